@@ -83,6 +83,17 @@ typedef enum
 
     /// ZIP file error.
     COSIM_ERRC_ZIP_ERROR,
+
+    // --- Codes unique to the C API, continued ---
+
+    /// Observed values diverged from a reference recording.
+    COSIM_ERRC_REFERENCE_DIVERGENCE,
+
+    /// A slave did not complete a time step within its step timeout.
+    COSIM_ERRC_STEP_TIMEOUT,
+
+    /// A bounded queue was full, so the request was dropped.
+    COSIM_ERRC_QUEUE_FULL,
 } cosim_errc;
 
 
@@ -165,8 +176,14 @@ cosim_execution* cosim_osp_config_execution_create(
 /**
  *  Creates a new execution based on a SystemStructure.ssd file.
  *
+ *  An `.ssp` archive may be given instead of an unpacked SSP.  Only the
+ *  system structure and the files it refers to are extracted from the
+ *  archive, in parallel, into a temporary directory.  Documentation and
+ *  other unused content is never unpacked.
+ *
  *  \param [in] sspDir
- *      Path to an .ssd file, or a directory holding SystemStructure.ssd
+ *      Path to an .ssd file, a directory holding SystemStructure.ssd, or an
+ *      .ssp archive
  *  \param [in] startTimeDefined
  *      Defines whether or not the following startTime variable should be ignored or not.
  *  \param [in] startTime
@@ -184,8 +201,10 @@ cosim_execution* cosim_ssp_execution_create(
 /**
  *  Creates a new execution based on a SystemStructure.ssd file.
  *
+ *  Like `cosim_ssp_execution_create()`, this accepts an `.ssp` archive.
+ *
  *  \param [in] sspDir
- *      Path to the directory holding SystemStructure.ssd
+ *      Path to the directory holding SystemStructure.ssd, or an .ssp archive
  *  \param [in] startTimeDefined
  *      Defines whether or not the following startTime variable should be ignored or not.
  *  \param [in] startTime
@@ -203,6 +222,61 @@ cosim_execution* cosim_ssp_fixed_step_execution_create(
     cosim_time_point startTime,
     cosim_duration stepSize);
 
+/**
+ *  Validates an OSP configuration without creating an execution.
+ *
+ *  The configuration file and the model descriptions of the simulators are
+ *  read, but no models are instantiated.  Every problem that is found is
+ *  reported, instead of just the first one.  The checks cover:
+ *
+ *  - that all referenced simulators, variables and functions exist
+ *  - that connections go from outputs to inputs of the same type
+ *  - that no input is connected more than once
+ *  - that initial values have the right type, are well formed, and are not
+ *    given for constants
+ *  - that step sizes are positive
+ *
+ *  \param [in] configPath
+ *      Path to an OSP config file (`OspSystemStructure.xml`), or to a
+ *      directory holding one.
+ *  \param [out] report
+ *      A buffer which will be filled with a description of each problem, on
+ *      the form `file:line: message`, separated by newlines.  The report is
+ *      truncated if the buffer is too small.  May be NULL if `reportSize`
+ *      is zero.
+ *  \param [in] reportSize
+ *      The size of the `report` buffer.
+ *
+ *  \returns
+ *      The number of problems found, which is zero if the configuration is
+ *      valid, or -1 if the configuration could not be read.
+ */
+int cosim_validate_osp_config(const char* configPath, char* report, size_t reportSize);
+
+/**
+ *  Validates an SSP configuration without creating an execution.
+ *
+ *  This works like `cosim_validate_osp_config()`.  It checks the components,
+ *  connectors, connections and component parameter bindings in the
+ *  system structure.  From an `.ssp` archive, only the system structure,
+ *  the parameter files it refers to and the model descriptions of the FMUs
+ *  are unpacked, although each FMU is still copied out of the archive
+ *  briefly in order to read its model description.
+ *
+ *  \param [in] sspDir
+ *      Path to the directory holding `SystemStructure.ssd`, to an `.ssd`
+ *      file, or to an `.ssp` archive.
+ *  \param [out] report
+ *      A buffer which will be filled with a description of each problem.
+ *  \param [in] reportSize
+ *      The size of the `report` buffer.
+ *
+ *  \returns
+ *      The number of problems found, or -1 if the configuration could not
+ *      be read or unpacked.
+ */
+int cosim_validate_ssp(const char* sspDir, char* report, size_t reportSize);
+
 /**
  *  Destroys an execution.
  *
@@ -220,6 +294,13 @@ typedef struct cosim_slave_s cosim_slave;
 /**
  *  Creates a new local slave.
  *
+ *  The FMU is unpacked once for all the slaves which are created from the
+ *  same file while any of them exists.  Entries are extracted in parallel,
+ *  skipping documentation, source code and binaries for other platforms.
+ *  Each slave still gets its own directory, with its own copy of the
+ *  binaries and hard links to the other files, which is removed when the
+ *  slave is destroyed.
+ *
  *  \param [in] fmuPath
  *      Path to FMU.
  *  \param [in] instanceName
@@ -323,6 +404,194 @@ cosim_slave_index cosim_execution_add_slave(
     cosim_execution* execution,
     cosim_slave* slave);
 
+/**
+ *  A function which transfers the state of a slave to its replacement.
+ *
+ *  It is called by `cosim_execution_replace_slave()` when the old slave is
+ *  still simulating and the new slave has been set up to start at the
+ *  current time, but is still in initialisation mode.  The variables of the
+ *  slaves can be accessed with `cosim_slave_get_real()`,
+ *  `cosim_slave_set_real()` etc., using the value references of each
+ *  slave's own model.
+ *
+ *  \param [in] oldSlave
+ *      The slave which is being replaced.  This is only valid during the call.
+ *  \param [in] newSlave
+ *      The replacement.
+ *  \param [in] userData
+ *      The pointer which was passed to `cosim_execution_replace_slave()`.
+ *
+ *  \returns
+ *      0 on success and -1 on error, which aborts the replacement.
+ */
+typedef int (*cosim_slave_state_transfer_fn)(cosim_slave* oldSlave, cosim_slave* newSlave, void* userData);
+
+/**
+ *  Replaces a slave with another one, e.g. a cheaper surrogate model, while
+ *  keeping its connections and observer subscriptions.
+ *
+ *  The slave keeps its index, name and variable list.  Its variables are
+ *  mapped to the variables of the replacement which have the same names and
+ *  types, and all its inputs and outputs must exist in the replacement.
+ *  Other variables which the replacement doesn't have keep their last
+ *  values.
+ *
+ *  If the simulation has started, the replacement is set up to start at the
+ *  current time, and the values of all variables which are inputs or
+ *  non-constant parameters in the replacement are copied from the old
+ *  slave.  Then `transfer`, if given, is called to transfer any other state.
+ *
+ *  Only slaves which were added with `cosim_execution_add_slave()` can be
+ *  replaced.  This may also be done while the execution is running in the
+ *  background, or being stepped in another thread, in which case the
+ *  replacement waits for the current step to complete.
+ *  States saved before the replacement can't be restored afterwards.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] index
+ *      The index of the slave to replace.
+ *  \param [in] newSlave
+ *      The replacement, which may not previously have been added to any
+ *      execution.
+ *  \param [in] transfer
+ *      A function which transfers state from the old slave to the new one,
+ *      or NULL.
+ *  \param [in] userData
+ *      A pointer which is passed on to `transfer`.
+ *
+ *  \returns
+ *      0 on success and -1 on error, in which case the old slave is kept.
+ */
+int cosim_execution_replace_slave(
+    cosim_execution* execution,
+    cosim_slave_index index,
+    cosim_slave* newSlave,
+    cosim_slave_state_transfer_fn transfer,
+    void* userData);
+
+/**
+ *  Retrieves the values of real variables directly from a slave.
+ *
+ *  This is intended for use in a `cosim_slave_state_transfer_fn`.  Slaves
+ *  in an execution should otherwise be accessed through observers.
+ *
+ *  \param [in] slave
+ *      The slave.
+ *  \param [in] variables
+ *      A pointer to an array of length `nv` that contains the value
+ *      references of the variables to retrieve.
+ *  \param [in] nv
+ *      The number of variables to retrieve.
+ *  \param [out] values
+ *      A pointer to an array of length `nv` which will be filled with the
+ *      values of the variables.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_slave_get_real(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    double values[]);
+
+/**
+ *  Sets the values of real variables directly in a slave.
+ *
+ *  This is intended for use in a `cosim_slave_state_transfer_fn`.  Slaves
+ *  in an execution should otherwise be modified through manipulators.
+ *
+ *  \param [in] slave
+ *      The slave.
+ *  \param [in] variables
+ *      A pointer to an array of length `nv` that contains the value
+ *      references of the variables to set.
+ *  \param [in] nv
+ *      The number of variables to set.
+ *  \param [in] values
+ *      A pointer to an array of length `nv` that contains the new values.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_slave_set_real(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    const double values[]);
+
+/// Retrieves the values of integer variables directly from a slave.  See `cosim_slave_get_real()`.
+int cosim_slave_get_integer(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    int values[]);
+
+/// Sets the values of integer variables directly in a slave.  See `cosim_slave_set_real()`.
+int cosim_slave_set_integer(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    const int values[]);
+
+/**
+ *  Adds a slave which computes derived signals, e.g. vector magnitudes,
+ *  powers or unit conversions, from the variables of other slaves.
+ *
+ *  Each derived signal is a real output variable of the new slave, whose
+ *  value is given by an expression.  The expressions are compiled once, and
+ *  evaluated after every step, as soon as the variables they refer to have
+ *  been updated, so they are not a step behind.  The outputs are ordinary
+ *  variables, which can be observed and connected like any other.  Their
+ *  value references are 0, 1, ..., in the order given.  Delays, filters
+ *  and extrapolation are never applied to the connections into the slave,
+ *  so expressions always see the exact values of the variables.
+ *
+ *  Expressions use the C operators `+ - * / % < <= > >= == != && || ! ?:`,
+ *  and `^` for exponentiation.  Comparisons and logical operators give 1 or
+ *  0.  The functions `abs`, `sqrt`, `exp`, `log`, `log10`, `sin`, `cos`,
+ *  `tan`, `asin`, `acos`, `atan`, `sinh`, `cosh`, `tanh`, `floor`, `ceil`,
+ *  `round`, `sign`, `atan2`, `pow`, `hypot`, `min` and `max`, and the
+ *  constants `pi` and `e`, are available.
+ *
+ *  Variables are referred to as `<slave name>.<variable name>`, e.g.
+ *  `crane.force * crane.velocity`.  Names which contain characters other
+ *  than letters, digits, underscores, periods and square brackets must be
+ *  written in braces, e.g. `{crane.der(x)}`.  Real, integer and boolean
+ *  output variables of slaves which have already been added can be used,
+ *  including the outputs of other expression slaves.  They are connected to
+ *  inputs of the new slave, which are named after them.  A name which
+ *  matches more than one variable, because slave or variable names contain
+ *  periods, is an error.
+ *
+ *  This is not supported for executions created with
+ *  `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] instanceName
+ *      A unique name for the slave.
+ *  \param [in] names
+ *      The names of the derived signals, which become the names of the
+ *      output variables.
+ *  \param [in] expressions
+ *      The expressions.
+ *  \param [in] count
+ *      The length of the `names` and `expressions` arrays.
+ *
+ *  \returns
+ *      The slave's index in the execution, or -1 on error, e.g. if an
+ *      expression is invalid or refers to an unknown variable.  The slave
+ *      is not added if there is an error.
+ */
+cosim_slave_index cosim_execution_add_expression_slave(
+    cosim_execution* execution,
+    const char* instanceName,
+    const char* const names[],
+    const char* const expressions[],
+    size_t count);
+
 
 /**
  *  Advances an execution a number of time steps.
@@ -378,6 +647,65 @@ int cosim_execution_start(cosim_execution* execution);
 int cosim_execution_stop(cosim_execution* execution);
 
 
+/**
+ *  Declares a group of slaves which are stepped sequentially.
+ *
+ *  By default, all slaves are stepped in parallel, using the variable values
+ *  from the end of the previous step (Jacobi coupling).  The slaves in a
+ *  sequential group are instead stepped one after another, in the order
+ *  given, and the outputs of each slave are transferred to the inputs of the
+ *  slaves later in the group as soon as its step is complete (Gauss-Seidel
+ *  coupling).  This can make tightly coupled slaves stable at larger step
+ *  sizes.  The group as a whole still runs in parallel with other groups and
+ *  with the slaves which are not in any group.  Any delay, filter or
+ *  extrapolation set for a connection within the group is applied to these
+ *  transfers as well.
+ *
+ *  The group takes effect from the next step.  A slave can only be in one
+ *  group.  This is not supported for executions created with
+ *  `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slaves
+ *      The indices of the slaves in the group, in stepping order.
+ *  \param [in] numSlaves
+ *      The length of the `slaves` array.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_add_sequential_group(
+    cosim_execution* execution,
+    const cosim_slave_index slaves[],
+    size_t numSlaves);
+
+/**
+ *  Changes the step size of an execution.
+ *
+ *  This may be called at any time, including while the simulation is
+ *  running in the background.  The new step size takes effect between two
+ *  steps, as soon as every slave has completed its current step.  (Slaves
+ *  with a decimation factor greater than 1 may be given shorter steps in the
+ *  meantime, so that they all arrive at the same time point.)
+ *
+ *  Note that `cosim_execution_simulate_until()` may overshoot its target
+ *  time if the step size doesn't divide the remaining time.
+ *
+ *  This is not supported for executions created with
+ *  `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] stepSize
+ *      The new step size, in nanoseconds.  Must be positive.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_step_size(cosim_execution* execution, cosim_duration stepSize);
+
+
 /// Enables real time simulation for an execution.
 int cosim_execution_enable_real_time_simulation(cosim_execution* execution);
 
@@ -390,6 +718,247 @@ int cosim_execution_set_real_time_factor_target(cosim_execution* execution, doub
 /// Sets the number of steps to monitor for rolling average real time factor measurement.
 int cosim_execution_set_steps_to_monitor(cosim_execution* execution, int stepsToMonitor);
 
+/**
+ *  A clock used for real time simulation.
+ *
+ *  \param [in] userData
+ *      The pointer which was passed to `cosim_execution_set_real_time_clock()`.
+ *
+ *  \returns
+ *      The current time, in nanoseconds since an arbitrary epoch.  The
+ *      clock must never go backwards.
+ */
+typedef cosim_time_point (*cosim_clock_fn)(void* userData);
+
+/**
+ *  Sets the clock which real time simulation is paced against.
+ *
+ *  By default, an execution is paced against the local monotonic clock.
+ *  This function makes it follow an external timebase instead, e.g. the
+ *  clock of a hardware-in-the-loop rig, a PTP-disciplined clock, or a
+ *  timestamp which another process publishes in shared memory.  The rate
+ *  of the external clock relative to the local one is estimated
+ *  continuously, and each step is held back until the external clock has
+ *  reached the step's target time, so that the simulation does not drift
+ *  away from the external timebase.
+ *
+ *  Pacing restarts from the current time when the clock is changed.  The
+ *  clock is called on the thread which runs the simulation.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] clock
+ *      The clock, or NULL to revert to the local monotonic clock.
+ *  \param [in] userData
+ *      A pointer which is passed on to `clock`.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_real_time_clock(cosim_execution* execution, cosim_clock_fn clock, void* userData);
+
+/// How real time simulation recovers when steps end later than their target time.
+typedef enum
+{
+    /**
+     *  Late steps are run back to back, without waiting, until the
+     *  simulation has caught up.  If it is still late after `maxSteps` such
+     *  steps, pacing is re-anchored.  Zero means no limit.  This is the
+     *  default.
+     */
+    COSIM_REAL_TIME_CATCH_UP_BURST,
+
+    /**
+     *  Pacing is re-anchored after every late step.  The simulation falls
+     *  behind by the length of each stall, but never runs faster than the
+     *  real time factor target.
+     */
+    COSIM_REAL_TIME_CATCH_UP_REANCHOR,
+
+    /**
+     *  Lateness is made up for gradually, by shortening each of the
+     *  following `maxSteps` steps by an equal part of it.  `maxSteps` must
+     *  be positive.
+     */
+    COSIM_REAL_TIME_CATCH_UP_SLOW_DOWN,
+} cosim_real_time_catch_up_policy;
+
+/**
+ *  Sets how real time simulation recovers from late steps, e.g. after a
+ *  stall in the host process or a slow model.
+ *
+ *  Re-anchoring means that pacing restarts from the time at which the late
+ *  step ended, so the lateness is never made up for.  The number of
+ *  re-anchors is reported in `cosim_real_time_pacing_stats`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] policy
+ *      The catch-up policy.
+ *  \param [in] maxSteps
+ *      The number of steps over which to catch up; see
+ *      `cosim_real_time_catch_up_policy`.
+ *  \param [in] maxLateness
+ *      The lateness beyond which pacing is always re-anchored, regardless of
+ *      policy, or zero for no limit.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_real_time_catch_up_policy(
+    cosim_execution* execution,
+    cosim_real_time_catch_up_policy policy,
+    int maxSteps,
+    cosim_duration maxLateness);
+
+/// Real time pacing statistics.
+typedef struct
+{
+    /// The number of steps which have been paced.
+    int64_t paced_steps;
+    /// The number of steps which ended more than 1 ms after their target time.
+    int64_t late_steps;
+    /// The number of times pacing has been re-anchored to recover from late steps.
+    int64_t reanchors;
+    /// How far after its target time the last paced step ended.  Negative if early.
+    cosim_duration last_lateness;
+    /// The largest lateness of any paced step.
+    cosim_duration max_lateness;
+    /// The mean lateness of the paced steps.
+    cosim_duration mean_lateness;
+    /// The estimated rate of the clock relative to the local monotonic clock.
+    double clock_rate;
+} cosim_real_time_pacing_stats;
+
+/**
+ *  Retrieves real time pacing statistics for an execution.
+ *
+ *  Lateness is measured on the clock set with
+ *  `cosim_execution_set_real_time_clock()`.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_get_real_time_pacing_stats(
+    cosim_execution* execution,
+    cosim_real_time_pacing_stats* stats);
+
+/**
+ *  Enables load shedding for real time simulation.
+ *
+ *  When the rolling average real time factor drops below the target, the
+ *  decimation factors of the slaves marked as degradable with
+ *  `cosim_execution_set_slave_degradable()` are doubled, so that they are
+ *  stepped less often (with correspondingly longer steps).  This is repeated
+ *  until the target is met or all degradable slaves have reached their
+ *  maximum decimation factor.  When the time spent computing steps drops
+ *  below half of the available wall-clock time, the decimation factors are
+ *  halved again.  Decisions are made once per `steps_to_monitor` steps.
+ *
+ *  Load shedding only has an effect while real time simulation is enabled,
+ *  and the number of currently degraded slaves is reported in
+ *  `cosim_execution_status`.  It is not supported for executions created
+ *  with `cosim_ssp_execution_create()`.
+ */
+int cosim_execution_enable_load_shedding(cosim_execution* execution);
+
+/// Disables load shedding, restoring the normal decimation factors of all slaves.
+int cosim_execution_disable_load_shedding(cosim_execution* execution);
+
+/**
+ *  Marks a slave as degradable by load shedding.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *  \param [in] maxDecimationFactor
+ *      The largest factor by which load shedding may multiply the slave's
+ *      decimation factor.  1 makes the slave non-degradable (the default).
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_slave_degradable(
+    cosim_execution* execution,
+    cosim_slave_index slave,
+    int maxDecimationFactor);
+
+/**
+ *  Retrieves the decimation factor currently used for a slave.
+ *
+ *  The slave is stepped with a step size equal to the execution's base step
+ *  size multiplied by this factor.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *  \param [out] decimationFactor
+ *      A pointer to a variable which will be set to the decimation factor.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_get_slave_decimation_factor(
+    cosim_execution* execution,
+    cosim_slave_index slave,
+    int* decimationFactor);
+
+/**
+ *  Freezes a slave.
+ *
+ *  A frozen slave is not stepped, and its outputs keep the values they had
+ *  when it was frozen.  This is useful for subsystems which are inactive
+ *  for long periods.  If the slave is in the middle of a step with a
+ *  decimation factor greater than 1, it is frozen when that step ends.
+ *
+ *  May be called at any time, also while the execution is running.  Not
+ *  supported for executions created with `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_freeze_slave(cosim_execution* execution, cosim_slave_index slave);
+
+/**
+ *  Thaws a slave which has been frozen with `cosim_execution_freeze_slave()`.
+ *
+ *  The slave's time is resynchronised with the simulation time by stepping
+ *  it over all the time it has been frozen, in steps of its usual size, as
+ *  part of its next step.  This may take a while after a long freeze, and
+ *  counts towards the slave's step timeout.  If the step size of the
+ *  execution was changed while the slave was frozen, the first of these
+ *  steps is shorter than the rest.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_thaw_slave(cosim_execution* execution, cosim_slave_index slave);
+
+/**
+ *  Returns whether a slave has been frozen.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *
+ *  \returns
+ *      1 if the slave is frozen, 0 if it is not, and -1 on error.
+ */
+int cosim_execution_is_slave_frozen(cosim_execution* execution, cosim_slave_index slave);
+
 
 /// Execution states.
 typedef enum
@@ -418,6 +987,10 @@ typedef struct
     int is_real_time_simulation;
     /// Number of steps used in rolling average real time factor measurement.
     int steps_to_monitor;
+    /// Number of degradable slaves which currently run with an increased decimation factor.
+    int num_degraded_slaves;
+    /// Number of slaves which currently are frozen.
+    int num_frozen_slaves;
 } cosim_execution_status;
 
 /**
@@ -441,23 +1014,142 @@ int cosim_execution_get_status(
     cosim_execution* execution,
     cosim_execution_status* status);
 
-/// Max number of characters used for slave name and source.
-#define SLAVE_NAME_MAX_SIZE 1024
-
-/// Variable types.
-typedef enum
-{
-    COSIM_VARIABLE_TYPE_REAL,
-    COSIM_VARIABLE_TYPE_INTEGER,
-    COSIM_VARIABLE_TYPE_STRING,
-    COSIM_VARIABLE_TYPE_BOOLEAN,
-} cosim_variable_type;
+/**
+ *  Enables computation of a rolling hash of the simulation state.
+ *
+ *  Once enabled, a hash of the values of all output variables of all slaves
+ *  is computed after every step, seeded with the hash for the previous step.
+ *  Two runs of the same system have equal hashes for a given step if and
+ *  only if all outputs have been bit-identical up to and including that step
+ *  (barring hash collisions), which makes it cheap to verify that e.g.
+ *  different scheduling options give identical results.
+ *
+ *  This must be called before the simulation is started.  Hashes are only
+ *  comparable between runs on platforms with the same byte order.
+ *
+ *  Hashes are kept for the 65536 most recent steps, which uses 512 KiB.
+ *  Use `cosim_execution_enable_state_hash_with_window()` to keep more or
+ *  fewer.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_enable_state_hash(cosim_execution* execution);
 
-/// Variable causalities.
-typedef enum
-{
-    COSIM_VARIABLE_CAUSALITY_INPUT,
-    COSIM_VARIABLE_CAUSALITY_PARAMETER,
+/**
+ *  Enables computation of a rolling hash of the simulation state, keeping
+ *  the hashes for a given number of steps.
+ *
+ *  This works like `cosim_execution_enable_state_hash()`, but the hashes
+ *  of the `window` most recent steps are kept, in 8 bytes each.  Hashes of
+ *  older steps can no longer be retrieved.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] window
+ *      The number of steps for which hashes are kept.  Must be positive.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_enable_state_hash_with_window(cosim_execution* execution, size_t window);
+
+/**
+ *  Retrieves the state hash for a given step.
+ *
+ *  \param [in] execution
+ *      The execution, for which `cosim_execution_enable_state_hash()` must
+ *      have been called.
+ *  \param [in] step
+ *      The step number.
+ *  \param [out] hash
+ *      A pointer to a variable which will be set to the state hash after `step`.
+ *
+ *  \returns
+ *      0 on success and -1 on error, including when no hash is available
+ *      for `step`, because it has not been taken yet or is outside the
+ *      window.
+ */
+int cosim_execution_get_state_hash(
+    cosim_execution* execution,
+    cosim_step_number step,
+    uint64_t* hash);
+
+/**
+ *  Sets a watchdog timeout for the time steps of a slave.
+ *
+ *  If a time step of the slave has not completed within `timeout` of
+ *  wall-clock time after the step was started, the step is abandoned and the simulation fails with the error
+ *  code `COSIM_ERRC_STEP_TIMEOUT`.  This also applies to simulations running
+ *  in the background, which will then be reported as failed by
+ *  `cosim_execution_get_status()` and `cosim_execution_stop()`.  Use
+ *  `cosim_execution_get_timed_out_slave()` to find out which slave it was.
+ *
+ *  A slave which has timed out may remain stuck in its step indefinitely.
+ *  The simulation can therefore not be continued, and the resources held by
+ *  the execution (including the slave's worker thread) are deliberately not
+ *  released by `cosim_execution_destroy()`.  The host processes of
+ *  out-of-process slaves are not accessible through this API, and are not
+ *  terminated.  The intended recovery is to report the error and exit the
+ *  process.
+ *
+ *  The timeout may be changed at any time, and takes effect from the next
+ *  time step.  It is not supported for executions created with
+ *  `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] slave
+ *      The index of the slave.
+ *  \param [in] timeout
+ *      The maximum wall-clock duration of a time step, in nanoseconds.
+ *      Zero disables the timeout.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_slave_step_timeout(
+    cosim_execution* execution,
+    cosim_slave_index slave,
+    cosim_duration timeout);
+
+/**
+ *  Retrieves the index of the slave which caused a `COSIM_ERRC_STEP_TIMEOUT`
+ *  error.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [out] slave
+ *      A pointer to a variable which will be set to the index of the slave
+ *      which timed out, if any.
+ *
+ *  \returns
+ *      1 if a slave has timed out, 0 if not, and -1 on error.
+ */
+int cosim_execution_get_timed_out_slave(
+    cosim_execution* execution,
+    cosim_slave_index* slave);
+
+/// Max number of characters used for slave name and source.
+#define SLAVE_NAME_MAX_SIZE 1024
+
+/// Variable types.
+typedef enum
+{
+    COSIM_VARIABLE_TYPE_REAL,
+    COSIM_VARIABLE_TYPE_INTEGER,
+    COSIM_VARIABLE_TYPE_STRING,
+    COSIM_VARIABLE_TYPE_BOOLEAN,
+} cosim_variable_type;
+
+/// Variable causalities.
+typedef enum
+{
+    COSIM_VARIABLE_CAUSALITY_INPUT,
+    COSIM_VARIABLE_CAUSALITY_PARAMETER,
     COSIM_VARIABLE_CAUSALITY_OUTPUT,
     COSIM_VARIABLE_CAUSALITY_CALCULATEDPARAMETER,
     COSIM_VARIABLE_CAUSALITY_LOCAL,
@@ -694,6 +1386,81 @@ int cosim_manipulator_slave_reset(
     const cosim_value_reference variables[],
     size_t nv);
 
+/**
+ *  Schedules an override of a real variable for one slave.
+ *
+ *  The override takes effect at the start of the first time step which
+ *  starts at or after `activationTime`, so the caller doesn't need to
+ *  watch the simulation time.  Scheduled overrides are applied in order of
+ *  activation time, and a later override of the same variable supersedes
+ *  any ongoing ramp or pending expiry of an earlier one.
+ *
+ *  Only works with manipulators created with
+ *  `cosim_override_manipulator_create()`.
+ *
+ *  \param [in] manipulator
+ *      The manipulator.
+ *  \param [in] slaveIndex
+ *      The slave.
+ *  \param [in] variable
+ *      The value reference of the variable to override.
+ *  \param [in] value
+ *      The override value.
+ *  \param [in] activationTime
+ *      The simulation time at which the override takes effect.
+ *  \param [in] rampDuration
+ *      If positive, the value is ramped linearly from the variable's own
+ *      value to `value` over this duration.  The ramp is evaluated at the
+ *      start of each step.
+ *  \param [in] holdDuration
+ *      If positive, the override is reset when this much time has passed
+ *      since `activationTime`.  If zero, it lasts until it is reset.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_manipulator_slave_schedule_real(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_value_reference variable,
+    double value,
+    cosim_time_point activationTime,
+    cosim_duration rampDuration,
+    cosim_duration holdDuration);
+
+/**
+ *  Schedules an override of an integer variable for one slave.
+ *
+ *  This works like `cosim_manipulator_slave_schedule_real()`, except that
+ *  integer values can't be ramped.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_manipulator_slave_schedule_integer(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_value_reference variable,
+    int value,
+    cosim_time_point activationTime,
+    cosim_duration holdDuration);
+
+/**
+ *  Schedules a reset of an overridden variable for one slave.
+ *
+ *  The reset takes effect at the start of the first time step which starts
+ *  at or after `activationTime`.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_manipulator_slave_schedule_reset(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_variable_type type,
+    cosim_value_reference variable,
+    cosim_time_point activationTime);
+
 /**
  *  Retrieves the values of real variables for one slave.
  *
@@ -876,6 +1643,79 @@ int64_t cosim_observer_slave_get_real_synchronized_series(
     double values1[],
     double values2[]);
 
+/// Kinds of events which can be searched for in observed series.
+typedef enum
+{
+    /// The value goes from below the threshold to at or above it.
+    COSIM_EVENT_UPWARD_CROSSING,
+    /// The value goes from at or above the threshold to below it.
+    COSIM_EVENT_DOWNWARD_CROSSING,
+    /// The value crosses the threshold in either direction.
+    COSIM_EVENT_CROSSING,
+    /// The value goes from zero to nonzero, e.g. a boolean flag being set.
+    COSIM_EVENT_RISING_EDGE,
+    /// The value goes from nonzero to zero.
+    COSIM_EVENT_FALLING_EDGE,
+    /// The value is strictly greater than the samples before and after it.
+    COSIM_EVENT_LOCAL_MAXIMUM,
+    /// The value is strictly smaller than the samples before and after it.
+    COSIM_EVENT_LOCAL_MINIMUM
+} cosim_event_type;
+
+/**
+ * Searches the observed series of a real variable for events.
+ *
+ * The search runs over the observer's buffered samples, so that only the
+ * steps and times of the events are returned.  Events are detected between
+ * consecutive samples within the step range, so the first sample in the
+ * range (and, for extrema, the last) cannot itself be an event.  For
+ * example, to find when a value first exceeded a limit, search for an
+ * upward crossing with `maxEvents` set to 1.
+ *
+ * \param [in] observer the observer, which must be a time series observer
+ * \param [in] slave index of the slave
+ * \param [in] valueReference the value reference
+ * \param [in] fromStep the first step number of the range to search
+ * \param [in] toStep the last step number of the range to search
+ * \param [in] type the kind of event to search for
+ * \param [in] threshold the threshold for crossings, ignored for other events
+ * \param [in] maxEvents the most events to find
+ * \param [out] steps the step numbers of the samples at which the events occur
+ * \param [out] times the corresponding simulation times
+ *
+ * \returns
+ *      The number of events found, in increasing order of time, or -1 on error.
+ */
+int64_t cosim_observer_slave_find_real_events(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
+    cosim_step_number fromStep,
+    cosim_step_number toStep,
+    cosim_event_type type,
+    double threshold,
+    size_t maxEvents,
+    cosim_step_number steps[],
+    cosim_time_point times[]);
+
+/**
+ * Searches the observed series of an integer variable for events.
+ *
+ * This works like `cosim_observer_slave_find_real_events()`.  Boolean
+ * signals which are represented as integers can be searched for edges.
+ */
+int64_t cosim_observer_slave_find_integer_events(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
+    cosim_step_number fromStep,
+    cosim_step_number toStep,
+    cosim_event_type type,
+    double threshold,
+    size_t maxEvents,
+    cosim_step_number steps[],
+    cosim_time_point times[]);
+
 /**
  * Retrieves the step numbers for a range given by a duration.
  *
@@ -966,6 +1806,111 @@ int cosim_execution_connect_integer_variables(
     cosim_slave_index inputSlaveIndex,
     cosim_value_reference inputValueReference);
 
+/**
+ *  Enables extrapolation of the value passed to a real input variable
+ *  through a connection.
+ *
+ *  An input is held constant over a time step, which introduces an error
+ *  that grows with the step size.  With extrapolation, the history of the
+ *  connected output is fitted with a polynomial of the given order, and the
+ *  input is set to its value at the middle of the upcoming step.  Order 1
+ *  uses the two last output values, and order 2 the three last ones.
+ *
+ *  The setting takes effect from the next step, and is retained if the
+ *  input is disconnected and reconnected.  It is not supported for
+ *  executions created with `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] inputSlaveIndex
+ *      The slave which has the input.
+ *  \param [in] inputValueReference
+ *      The input variable.
+ *  \param [in] order
+ *      The extrapolation order: 0 (none), 1 (linear) or 2 (quadratic).
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_real_connection_extrapolation(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    int order);
+
+/**
+ *  Sets the extrapolation order for all real connections which have not
+ *  been given one with `cosim_execution_set_real_connection_extrapolation()`.
+ *
+ *  The default is 0, i.e., no extrapolation.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_default_connection_extrapolation(cosim_execution* execution, int order);
+
+/**
+ *  Sets a transport delay on the connection to a real input variable.
+ *
+ *  The input receives the connected output as it was `delay` earlier,
+ *  linearly interpolated between the communication points.  Until the
+ *  delay has elapsed, it receives the first output value.  A delay of
+ *  zero removes it.
+ *
+ *  The delay is applied before filtering and extrapolation.  The setting
+ *  takes effect from the next step, and is retained if the input is
+ *  disconnected and reconnected.  It is not supported for executions
+ *  created with `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] inputSlaveIndex
+ *      The slave which has the input.
+ *  \param [in] inputValueReference
+ *      The input variable.
+ *  \param [in] delay
+ *      The delay, which must be non-negative.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_real_connection_delay(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    cosim_duration delay);
+
+/**
+ *  Inserts a first-order low-pass filter in the connection to a real input
+ *  variable.
+ *
+ *  The filter is solved exactly at each communication point, assuming the
+ *  output is constant in between, so it is stable for any step size.  A
+ *  time constant of zero removes the filter.
+ *
+ *  The filter is applied after any delay and before extrapolation.  The
+ *  setting takes effect from the next step, and is retained if the input
+ *  is disconnected and reconnected.  It is not supported for executions
+ *  created with `cosim_ssp_execution_create()`.
+ *
+ *  \param [in] execution
+ *      The execution.
+ *  \param [in] inputSlaveIndex
+ *      The slave which has the input.
+ *  \param [in] inputValueReference
+ *      The input variable.
+ *  \param [in] timeConstant
+ *      The time constant of the filter, which must be non-negative.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_execution_set_real_connection_filter(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    cosim_duration timeConstant);
+
 
 /// Creates an observer which stores the last observed value for all variables.
 cosim_observer* cosim_last_value_observer_create();
@@ -1007,6 +1952,99 @@ cosim_observer* cosim_time_series_observer_create();
  */
 cosim_observer* cosim_buffered_time_series_observer_create(size_t bufferSize);
 
+/**
+ *  Creates an observer which compares observed values against a reference recording.
+ *
+ *  The reference recording is a directory containing CSV files in the format
+ *  written by `cosim_file_observer_create()`, one file per slave, where the
+ *  file for a slave is identified by the slave's instance name.  Slaves
+ *  without a reference file are not compared.  The files are memory mapped
+ *  and read in step with the simulation, and nothing is written to disk.
+ *
+ *  After every step, each logged variable is compared with its reference
+ *  value.  A real or integer value matches if
+ *  `|observed - reference| <= absoluteTolerance + relativeTolerance * |reference|`,
+ *  while boolean and string values must match exactly.  At the first
+ *  mismatch, the execution is aborted with the error code
+ *  `COSIM_ERRC_REFERENCE_DIVERGENCE` and an error message which describes
+ *  the divergence.  The details can also be retrieved with
+ *  `cosim_comparator_observer_get_divergence()`.
+ *
+ *  \param [in] referenceDir
+ *      The directory which contains the reference recording.
+ *  \param [in] absoluteTolerance
+ *      The default absolute tolerance.
+ *  \param [in] relativeTolerance
+ *      The default relative tolerance.
+ *
+ *  \returns
+ *      The created observer, or NULL on error.
+ */
+cosim_observer* cosim_comparator_observer_create(
+    const char* referenceDir,
+    double absoluteTolerance,
+    double relativeTolerance);
+
+/**
+ *  Overrides the default tolerances of a comparator observer for one variable.
+ *
+ *  \param [in] observer
+ *      An observer created with `cosim_comparator_observer_create()`.
+ *  \param [in] slave
+ *      The slave index.
+ *  \param [in] type
+ *      The variable type.
+ *  \param [in] reference
+ *      The variable's value reference.
+ *  \param [in] absoluteTolerance
+ *      The absolute tolerance.
+ *  \param [in] relativeTolerance
+ *      The relative tolerance.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_comparator_observer_set_tolerance(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_variable_type type,
+    cosim_value_reference reference,
+    double absoluteTolerance,
+    double relativeTolerance);
+
+/// A struct containing information about a divergence from a reference recording.
+typedef struct
+{
+    /// The variable which diverged.
+    cosim_variable_id variable;
+    /// The variable name.
+    char variable_name[SLAVE_NAME_MAX_SIZE];
+    /// The step at which the divergence was detected.
+    cosim_step_number step;
+    /// The simulation time at which the divergence was detected.
+    cosim_time_point time;
+    /// The observed value (NaN for strings).
+    double observed_value;
+    /// The reference value (NaN for strings, or if the reference value is missing).
+    double reference_value;
+} cosim_divergence;
+
+/**
+ *  Retrieves the divergence which caused a comparator observer to abort the execution.
+ *
+ *  \param [in] observer
+ *      An observer created with `cosim_comparator_observer_create()`.
+ *  \param [out] divergence
+ *      A pointer to a `cosim_divergence` which will be filled with details
+ *      about the divergence, if one has been detected.
+ *
+ *  \returns
+ *      1 if a divergence has been detected, 0 if not, and -1 on error.
+ */
+int cosim_comparator_observer_get_divergence(
+    cosim_observer* observer,
+    cosim_divergence* divergence);
+
 /// Start observing a variable with a `time_series_observer`.
 int cosim_observer_start_observing(cosim_observer* observer, cosim_slave_index slave, cosim_variable_type type, cosim_value_reference reference);
 
@@ -1033,9 +2071,531 @@ int cosim_execution_add_observer(
     cosim_execution* execution,
     cosim_observer* observer);
 
-/// Creates a manipulator for overriding variable values
+/**
+ *  Creates a manipulator for overriding variable values.
+ *
+ *  Overrides and resets may be submitted from several threads while the
+ *  execution is running, without blocking the simulation.  They are passed
+ *  to the simulation through a bounded queue, which is emptied at the start
+ *  of each step.  This function creates a manipulator with room for 4096
+ *  submissions per step.
+ */
 cosim_manipulator* cosim_override_manipulator_create();
 
+/**
+ *  Creates a manipulator for overriding variable values, with a given queue
+ *  capacity.
+ *
+ *  \param [in] queueCapacity
+ *      The maximum number of overrides and resets which may be submitted
+ *      between two steps.  It is rounded up to a power of two.  When the
+ *      queue is full, submissions fail with `COSIM_ERRC_QUEUE_FULL`.
+ *
+ *  \returns
+ *      The manipulator, or NULL on error.
+ */
+cosim_manipulator* cosim_override_manipulator_create_with_capacity(size_t queueCapacity);
+
+/**
+ *  Returns the number of overrides and resets which have been rejected
+ *  because an override manipulator's queue was full.
+ *
+ *  \returns
+ *      The number of rejected submissions, or -1 on error.
+ */
+int64_t cosim_manipulator_get_overflow_count(cosim_manipulator* manipulator);
+
+/**
+ *  Creates an observer which measures end-to-end latency through the
+ *  simulation.
+ *
+ *  The observer measures the wall-clock time from a new value for an input
+ *  being submitted to an override manipulator, e.g. with
+ *  `cosim_manipulator_slave_set_real()`, until a corresponding output has
+ *  changed and been published to observers at the end of a step.  The
+ *  pairs of variables to measure are specified with
+ *  `cosim_latency_observer_add_pair()`.
+ *
+ *  Creating the observer makes the manipulator stamp every value submitted
+ *  from then on with the time of submission, and the time at which it was
+ *  applied at the start of a step.
+ *
+ *  \param [in] manipulator
+ *      A manipulator created with `cosim_override_manipulator_create()`.
+ *
+ *  \returns
+ *      The observer, or NULL on error.
+ */
+cosim_observer* cosim_latency_observer_create(cosim_manipulator* manipulator);
+
+/**
+ *  Adds a pair of variables to measure the latency between.
+ *
+ *  The output is considered to respond to a new input value when it first
+ *  differs from its value before the step in which the input value was
+ *  applied.  Only real, integer and boolean variables are supported.
+ *
+ *  \param [in] observer
+ *      The observer.
+ *  \param [in] input
+ *      The variable which values are submitted for.
+ *  \param [in] output
+ *      The variable which responds.
+ *
+ *  \returns
+ *      The index of the pair, or -1 on error.
+ */
+int cosim_latency_observer_add_pair(
+    cosim_observer* observer,
+    cosim_variable_id input,
+    cosim_variable_id output);
+
+/// A latency distribution, in nanoseconds.
+typedef struct
+{
+    cosim_duration min;
+    cosim_duration mean;
+    cosim_duration p50;
+    cosim_duration p90;
+    cosim_duration p99;
+    cosim_duration max;
+} cosim_latency_distribution;
+
+/**
+ *  Latency statistics for a pair of variables.
+ *
+ *  The distributions are computed from the 4096 most recent measurements.
+ */
+typedef struct
+{
+    /// The total number of measurements.
+    int64_t samples;
+    /// The number of input values which were superseded before the output responded.
+    int64_t unmatched;
+    /// From submission until the start of the step in which the value was applied.
+    cosim_latency_distribution queueing;
+    /// From the start of that step until the end of the step in which the output responded.
+    cosim_latency_distribution processing;
+    /// From submission until the end of the step in which the output responded.
+    cosim_latency_distribution total;
+} cosim_latency_stats;
+
+/**
+ *  Retrieves the latency statistics for a pair of variables.
+ *
+ *  \param [in] observer
+ *      The observer.
+ *  \param [in] pair
+ *      The index of the pair, as returned by `cosim_latency_observer_add_pair()`.
+ *  \param [out] stats
+ *      The statistics.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_latency_observer_get_stats(cosim_observer* observer, int pair, cosim_latency_stats* stats);
+
+/// Bin spacing for histogram observers.
+typedef enum
+{
+    /// Bins of equal width.
+    COSIM_HISTOGRAM_LINEAR_BINS,
+    /// Bins of equal width on a logarithmic scale.  The lower limit must be positive.
+    COSIM_HISTOGRAM_LOG_BINS
+} cosim_histogram_bin_scale;
+
+/**
+ *  Creates an observer which builds histograms of variable values.
+ *
+ *  Each variable added with `cosim_histogram_observer_add_variable()` is
+ *  sampled at initialization and after every step of its slave, and the
+ *  value is counted in a fixed set of bins.  Optionally, rainflow cycle
+ *  counting is done as well, for fatigue analysis.  Memory use does not
+ *  grow with the length of the simulation.
+ *
+ *  \returns
+ *      The observer, or NULL on error.
+ */
+cosim_observer* cosim_histogram_observer_create();
+
+/**
+ *  Adds a histogram of a variable to a histogram observer.
+ *
+ *  Values below `min` or at or above `max` are counted as underflow and
+ *  overflow, respectively.  Only real, integer and boolean variables are
+ *  supported.
+ *
+ *  \param [in] observer
+ *      An observer created with `cosim_histogram_observer_create()`.
+ *  \param [in] variable
+ *      The variable.
+ *  \param [in] scale
+ *      The bin spacing.
+ *  \param [in] min
+ *      The lower limit of the first bin.
+ *  \param [in] max
+ *      The upper limit of the last bin.
+ *  \param [in] numBins
+ *      The number of bins.
+ *  \param [in] rainflow
+ *      Whether to do rainflow counting.  The cycle ranges are counted in
+ *      `numBins` bins of equal width, from zero to `max - min`, with larger
+ *      ranges counted in the last bin.
+ *
+ *  \returns
+ *      The index of the histogram, or -1 on error.
+ */
+int cosim_histogram_observer_add_variable(
+    cosim_observer* observer,
+    cosim_variable_id variable,
+    cosim_histogram_bin_scale scale,
+    double min,
+    double max,
+    size_t numBins,
+    bool rainflow);
+
+/// Summary statistics of the values counted by a histogram.
+typedef struct
+{
+    /// The number of values counted, including underflow and overflow.
+    int64_t samples;
+    /// The number of values below the lower limit.
+    int64_t underflow;
+    /// The number of values at or above the upper limit.
+    int64_t overflow;
+    /// The smallest value, or NaN if there are none.
+    double min;
+    /// The largest value, or NaN if there are none.
+    double max;
+    /// The mean value, or NaN if there are none.
+    double mean;
+} cosim_histogram_summary;
+
+/**
+ *  Retrieves the counts of a histogram.
+ *
+ *  \param [in] observer
+ *      The observer.
+ *  \param [in] histogram
+ *      The index of the histogram, as returned by
+ *      `cosim_histogram_observer_add_variable()`.
+ *  \param [out] counts
+ *      An array of length `numBins`, which will be filled with the counts.
+ *      May be NULL.
+ *  \param [out] binEdges
+ *      An array of length `numBins + 1`, which will be filled with the bin
+ *      edges.  May be NULL.
+ *  \param [in] numBins
+ *      The number of bins to retrieve.
+ *  \param [out] summary
+ *      Summary statistics.  May be NULL.
+ *
+ *  \returns
+ *      The number of bins in the histogram, which may be larger than
+ *      `numBins`, or -1 on error.
+ */
+int64_t cosim_histogram_observer_get_counts(
+    cosim_observer* observer,
+    int histogram,
+    int64_t counts[],
+    double binEdges[],
+    size_t numBins,
+    cosim_histogram_summary* summary);
+
+/**
+ *  Retrieves the rainflow cycle counts of a histogram.
+ *
+ *  Closed cycles count as one, and the ranges of the residue (the reversals
+ *  which have not yet formed closed cycles) count as half cycles.
+ *
+ *  \param [in] observer
+ *      The observer.
+ *  \param [in] histogram
+ *      The index of a histogram for which rainflow counting is enabled.
+ *  \param [out] cycles
+ *      An array of length `numBins`, which will be filled with the number
+ *      of cycles in each range bin.
+ *  \param [in] numBins
+ *      The number of bins to retrieve.
+ *  \param [out] rangeBinWidth
+ *      The width of the range bins, the first of which starts at zero.
+ *      May be NULL.
+ *
+ *  \returns
+ *      The number of range bins, which may be larger than `numBins`, or -1
+ *      on error.
+ */
+int64_t cosim_histogram_observer_get_rainflow_cycles(
+    cosim_observer* observer,
+    int histogram,
+    double cycles[],
+    size_t numBins,
+    double* rangeBinWidth);
+
+/// Window functions for power spectral density observers.
+typedef enum
+{
+    /// The Hann window.  A good default.
+    COSIM_PSD_WINDOW_HANN,
+    /// The Hamming window.
+    COSIM_PSD_WINDOW_HAMMING,
+    /// No windowing.
+    COSIM_PSD_WINDOW_RECTANGULAR
+} cosim_psd_window;
+
+/**
+ *  Creates an observer which estimates power spectral densities of
+ *  variables with Welch's method.
+ *
+ *  Each variable added with `cosim_psd_observer_add_variable()` is sampled
+ *  after every step of its slave.  The samples are split into overlapping
+ *  segments, and as each segment is completed, it has its mean removed, is
+ *  windowed and Fourier transformed, and its periodogram is added to a
+ *  running average.  Memory use does not grow with the length of the
+ *  simulation.
+ *
+ *  The sample rate is the inverse of the slave's step size.  If the step
+ *  size changes, the estimate is discarded and starts over at the new
+ *  sample rate.  Segments do not span a restored state.
+ *
+ *  \returns
+ *      The observer, or NULL on error.
+ */
+cosim_observer* cosim_psd_observer_create();
+
+/**
+ *  Adds a variable to a power spectral density observer.
+ *
+ *  Only real, integer and boolean variables are supported.
+ *
+ *  \param [in] observer
+ *      An observer created with `cosim_psd_observer_create()`.
+ *  \param [in] variable
+ *      The variable.
+ *  \param [in] segmentLength
+ *      The number of samples per segment, which must be a power of two.
+ *      This determines the frequency resolution.
+ *  \param [in] overlap
+ *      The number of samples shared by consecutive segments, which must be
+ *      less than `segmentLength`.  Half the segment length is usual.
+ *  \param [in] window
+ *      The window function.
+ *
+ *  \returns
+ *      The index of the spectrum, or -1 on error.
+ */
+int cosim_psd_observer_add_variable(
+    cosim_observer* observer,
+    cosim_variable_id variable,
+    size_t segmentLength,
+    size_t overlap,
+    cosim_psd_window window);
+
+/**
+ *  Retrieves the current power spectral density estimate of a variable.
+ *
+ *  The estimate is one-sided, in units of the variable squared per hertz,
+ *  with `segmentLength / 2 + 1` frequency bins from zero to half the
+ *  sample rate.  It is all zeros until the first segment is complete.
+ *
+ *  \param [in] observer
+ *      The observer.
+ *  \param [in] spectrum
+ *      The index of the spectrum, as returned by
+ *      `cosim_psd_observer_add_variable()`.
+ *  \param [out] frequencies
+ *      An array of length `numBins`, which will be filled with the
+ *      frequencies of the bins, in hertz.  May be NULL.
+ *  \param [out] psd
+ *      An array of length `numBins`, which will be filled with the power
+ *      spectral density.  May be NULL.
+ *  \param [in] numBins
+ *      The number of bins to retrieve.
+ *  \param [out] numSegments
+ *      The number of segments averaged.  May be NULL.
+ *
+ *  \returns
+ *      The number of frequency bins, which may be larger than `numBins`, or
+ *      -1 on error.
+ */
+int64_t cosim_psd_observer_get_psd(
+    cosim_observer* observer,
+    int spectrum,
+    double frequencies[],
+    double psd[],
+    size_t numBins,
+    int64_t* numSegments);
+
+/**
+ *  Creates a manipulator which sets real variables from a shared-memory
+ *  segment written by another process.
+ *
+ *  The manipulator creates a named segment with one slot per variable, which
+ *  other processes can write to with the functions in `cosim_shm_writer.h`.
+ *  At the start of each step, if anything has been written since the
+ *  previous step, every variable is overridden with the value in its slot.
+ *  Variables are left alone until the first write.  Reads and writes are
+ *  lock-free; the simulation never waits for a writer.
+ *
+ *  On POSIX systems, the segment is a `shm_open()` object.  It is removed
+ *  when the manipulator is destroyed.
+ *
+ *  \param [in] segmentName
+ *      The name of the segment.  Any existing segment with this name is
+ *      replaced.
+ *  \param [in] slaves
+ *      The indices of the slaves owning the variables, one per slot.
+ *  \param [in] variables
+ *      The value references of the variables, one per slot.
+ *  \param [in] count
+ *      The number of slots.
+ *
+ *  \returns
+ *      The manipulator, or NULL on error.
+ */
+cosim_manipulator* cosim_shm_input_manipulator_create(
+    const char* segmentName,
+    const cosim_slave_index slaves[],
+    const cosim_value_reference variables[],
+    size_t count);
+
+/**
+ *  Returns the number of steps at which a shared-memory input manipulator
+ *  kept the previous values, because the segment was being written to
+ *  continuously and no consistent copy could be made.
+ *
+ *  \returns
+ *      The number of skipped reads, or -1 on error.
+ */
+int64_t cosim_shm_input_manipulator_get_skipped_reads(cosim_manipulator* manipulator);
+
+/// How a value is represented in a packet.
+typedef enum
+{
+    COSIM_PACKET_FIELD_FLOAT64,
+    COSIM_PACKET_FIELD_FLOAT32,
+    COSIM_PACKET_FIELD_INT8,
+    COSIM_PACKET_FIELD_UINT8,
+    COSIM_PACKET_FIELD_INT16,
+    COSIM_PACKET_FIELD_UINT16,
+    COSIM_PACKET_FIELD_INT32,
+    COSIM_PACKET_FIELD_UINT32
+} cosim_packet_field_encoding;
+
+/**
+ *  A variable value at a fixed position in a packet.
+ *
+ *  Real, integer and boolean variables may be mapped to fields of any
+ *  encoding.  Values are rounded and saturated to integer encodings, and
+ *  booleans are encoded as 0 or 1.
+ */
+typedef struct
+{
+    /// The variable.
+    cosim_variable_id variable;
+    /// The position of the field in the packet, in bytes.
+    size_t offset;
+    /// The representation of the value.
+    cosim_packet_field_encoding encoding;
+    /// Whether the value is big-endian (network byte order).
+    bool big_endian;
+} cosim_packet_field;
+
+/// Packet counters for UDP bridges.
+typedef struct
+{
+    /// The number of packets sent or received.
+    int64_t packets;
+    /// The number of packets which could not be sent, or were received with the wrong size.
+    int64_t dropped_packets;
+    /// The number of socket errors.
+    int64_t errors;
+} cosim_udp_bridge_stats;
+
+/**
+ *  Creates an observer which sends variable values in fixed-layout UDP
+ *  packets.
+ *
+ *  One packet is sent after initialization and one after each step.  The
+ *  packets are sent on a dedicated thread, in batches.  Bytes which are not
+ *  covered by any field are zero.
+ *
+ *  \param [in] localAddress
+ *      The IPv4 address to send from, or NULL for any.
+ *  \param [in] localPort
+ *      The port to send from, or zero for an ephemeral port.
+ *  \param [in] remoteAddress
+ *      The IPv4 address to send to.
+ *  \param [in] remotePort
+ *      The port to send to.
+ *  \param [in] packetSize
+ *      The size of the packets, in bytes.
+ *  \param [in] fields
+ *      The fields of the packets.
+ *  \param [in] numFields
+ *      The length of the `fields` array.
+ *
+ *  \returns
+ *      The observer, or NULL on error.
+ */
+cosim_observer* cosim_udp_output_observer_create(
+    const char* localAddress,
+    uint16_t localPort,
+    const char* remoteAddress,
+    uint16_t remotePort,
+    size_t packetSize,
+    const cosim_packet_field fields[],
+    size_t numFields);
+
+/**
+ *  Creates a manipulator which sets variables from fixed-layout UDP packets.
+ *
+ *  Packets are received on a dedicated thread, in batches.  At the start of
+ *  each step, if a packet has arrived since the previous step, every mapped
+ *  variable is overridden with its value from the newest packet.  Variables
+ *  are left alone until the first packet arrives.  Packets which are not
+ *  exactly `packetSize` bytes long are dropped.
+ *
+ *  \param [in] localAddress
+ *      The IPv4 address to receive on, or NULL for any.
+ *  \param [in] localPort
+ *      The port to receive on, or zero for an ephemeral port.
+ *  \param [in] packetSize
+ *      The size of the packets, in bytes.
+ *  \param [in] fields
+ *      The fields of the packets.
+ *  \param [in] numFields
+ *      The length of the `fields` array.
+ *
+ *  \returns
+ *      The manipulator, or NULL on error.
+ */
+cosim_manipulator* cosim_udp_input_manipulator_create(
+    const char* localAddress,
+    uint16_t localPort,
+    size_t packetSize,
+    const cosim_packet_field fields[],
+    size_t numFields);
+
+/// Returns the port a UDP input manipulator receives on, or -1 on error.
+int cosim_udp_input_manipulator_get_port(cosim_manipulator* manipulator);
+
+/**
+ *  Retrieves the packet counters of a UDP output observer.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_udp_output_observer_get_stats(cosim_observer* observer, cosim_udp_bridge_stats* stats);
+
+/**
+ *  Retrieves the packet counters of a UDP input manipulator.
+ *
+ *  \returns
+ *      0 on success and -1 on error.
+ */
+int cosim_udp_input_manipulator_get_stats(cosim_manipulator* manipulator, cosim_udp_bridge_stats* stats);
+
 /**
  *  Add a manipulator to an execution.
  *
@@ -1139,6 +2699,53 @@ cosim_version cosim_libcosim_version();
 cosim_version cosim_libcosimc_version();
 
 
+/**
+ *  Enables instrumentation of C API calls.
+ *
+ *  While instrumentation is enabled, every call to a function in this API
+ *  is counted, and the time spent in it is measured.  This includes the
+ *  time spent in libcosim and in the models, e.g. during
+ *  `cosim_execution_step()`.  The counters are kept per thread and summed
+ *  when retrieved, so instrumented calls from different threads do not
+ *  contend with each other.  Instrumentation is disabled by default.
+ */
+void cosim_enable_api_stats();
+
+/// Disables instrumentation of C API calls.  The counters are kept.
+void cosim_disable_api_stats();
+
+/// Resets all C API call counters to zero.
+void cosim_reset_api_stats();
+
+/// C API call counters for one function.
+typedef struct
+{
+    /// The name of the function.  Valid for the lifetime of the program.
+    const char* function;
+    /// The number of calls.
+    int64_t calls;
+    /// The total time spent in the calls, in nanoseconds.
+    cosim_duration total_time;
+} cosim_api_call_stats;
+
+/**
+ *  Retrieves the C API call counters.
+ *
+ *  Only functions which have been called while instrumentation was enabled
+ *  are included.  The counters of threads which have exited are included.
+ *
+ *  \param [out] stats
+ *      An array of length `numStats`, which will be filled with counters.
+ *  \param [in] numStats
+ *      The length of the `stats` array.
+ *
+ *  \returns
+ *      The number of functions which have been called, which may be larger
+ *      than `numStats`, or -1 on error.
+ */
+int cosim_get_api_stats(cosim_api_call_stats stats[], size_t numStats);
+
+
 #ifdef __cplusplus
 } // extern(C)
 #endif
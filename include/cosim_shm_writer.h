@@ -0,0 +1,76 @@
+/**
+ *  \file
+ *  Writer side of the shared-memory input channel
+ *
+ *  This is a small, stand-alone library for processes which feed input
+ *  values to a simulation through a segment created by
+ *  `cosim_shm_input_manipulator_create()`.  It does not depend on libcosim.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef COSIM_SHM_WRITER_H
+#define COSIM_SHM_WRITER_H
+
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/// An open shared-memory input segment.
+typedef struct cosim_shm_writer_s cosim_shm_writer;
+
+/**
+ *  Opens an existing shared-memory input segment for writing.
+ *
+ *  \param [in] segmentName
+ *      The name the segment was created with.
+ *
+ *  \returns
+ *      The writer, or NULL if the segment does not exist or is not a valid
+ *      input segment.
+ */
+cosim_shm_writer* cosim_shm_writer_open(const char* segmentName);
+
+/// Returns the number of value slots in the segment.
+size_t cosim_shm_writer_size(const cosim_shm_writer* writer);
+
+/**
+ *  Writes a range of values to the segment.
+ *
+ *  The values are published together: the simulation sees either all or
+ *  none of them.  This never waits for the simulation, only for other
+ *  writers to the same segment.
+ *
+ *  \param [in] writer
+ *      The writer.
+ *  \param [in] offset
+ *      The slot to write the first value to.
+ *  \param [in] values
+ *      The values to write.
+ *  \param [in] count
+ *      The number of values to write.
+ *
+ *  \returns
+ *      0 on success, or -1 if the range is out of bounds.
+ */
+int cosim_shm_writer_write(
+    cosim_shm_writer* writer,
+    size_t offset,
+    const double values[],
+    size_t count);
+
+/// Closes the segment.
+void cosim_shm_writer_close(cosim_shm_writer* writer);
+
+
+#ifdef __cplusplus
+} // extern(C)
+#endif
+
+#endif // header guard
@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "api_stats.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+
+namespace cosimc
+{
+
+std::atomic<bool> g_apiStatsEnabled{false};
+
+namespace
+{
+
+// The most functions which can be instrumented.  Functions beyond this are
+// not counted.
+constexpr std::size_t maxFunctions = 512;
+
+struct counter
+{
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::int64_t> nanoseconds{0};
+};
+
+using counter_array = std::array<counter, maxFunctions>;
+
+struct registry
+{
+    std::mutex mutex;
+    std::vector<const char*> functions;
+    std::vector<std::shared_ptr<counter_array>> threads;
+    // The counts of threads which have exited.
+    counter_array retired;
+};
+
+registry& get_registry()
+{
+    static registry r;
+    return r;
+}
+
+// Registers the counters of a thread on its first instrumented call, and
+// folds them into the retired counters when the thread exits.
+class thread_counters
+{
+public:
+    thread_counters()
+        : counters_(std::make_shared<counter_array>())
+    {
+        auto& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(counters_);
+    }
+
+    ~thread_counters()
+    {
+        auto& r = get_registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t i = 0; i < maxFunctions; ++i) {
+            r.retired[i].calls += (*counters_)[i].calls;
+            r.retired[i].nanoseconds += (*counters_)[i].nanoseconds;
+        }
+        for (auto it = r.threads.begin(); it != r.threads.end(); ++it) {
+            if (*it == counters_) {
+                r.threads.erase(it);
+                break;
+            }
+        }
+    }
+
+    thread_counters(const thread_counters&) = delete;
+    thread_counters& operator=(const thread_counters&) = delete;
+
+    counter& operator[](std::size_t function) noexcept { return (*counters_)[function]; }
+
+private:
+    std::shared_ptr<counter_array> counters_;
+};
+
+} // namespace
+
+
+api_function::api_function(const char* name)
+{
+    auto& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    index_ = r.functions.size();
+    r.functions.push_back(name);
+}
+
+void api_call_timer::record(std::size_t function, std::chrono::nanoseconds time) noexcept
+{
+    if (function >= maxFunctions) return;
+    thread_local thread_counters counters;
+    auto& c = counters[function];
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    c.nanoseconds.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+std::vector<api_call_stats> get_api_stats()
+{
+    auto& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<api_call_stats> stats;
+    for (std::size_t i = 0; i < r.functions.size() && i < maxFunctions; ++i) {
+        api_call_stats s;
+        s.calls = r.retired[i].calls.load(std::memory_order_relaxed);
+        std::int64_t nanoseconds = r.retired[i].nanoseconds.load(std::memory_order_relaxed);
+        for (const auto& t : r.threads) {
+            s.calls += (*t)[i].calls.load(std::memory_order_relaxed);
+            nanoseconds += (*t)[i].nanoseconds.load(std::memory_order_relaxed);
+        }
+        if (s.calls == 0) continue;
+        s.function = r.functions[i];
+        s.time = std::chrono::nanoseconds(nanoseconds);
+        stats.push_back(std::move(s));
+    }
+    return stats;
+}
+
+void reset_api_stats()
+{
+    auto& r = get_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const auto reset = [](counter_array& counters) {
+        for (auto& c : counters) {
+            c.calls = 0;
+            c.nanoseconds = 0;
+        }
+    };
+    reset(r.retired);
+    for (const auto& t : r.threads) reset(*t);
+}
+
+} // namespace cosimc
@@ -0,0 +1,101 @@
+/**
+ *  \file
+ *  \brief Opt-in instrumentation of C API calls.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_API_STATS_HPP
+#define LIBCOSIMC_API_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Whether C API calls are being counted and timed.
+extern std::atomic<bool> g_apiStatsEnabled;
+
+/// Call counters for one C API function.
+struct api_call_stats
+{
+    /// The function name, which has static storage duration.
+    const char* function = nullptr;
+    std::uint64_t calls = 0;
+    std::chrono::nanoseconds time{0};
+};
+
+/**
+ *  An instrumented C API function.
+ *
+ *  Each function is registered once, on its first call, and gets an index
+ *  into the per-thread counter arrays.
+ */
+class api_function
+{
+public:
+    /// Constructor.  `name` must have static storage duration.
+    explicit api_function(const char* name);
+
+    std::size_t index() const noexcept { return index_; }
+
+private:
+    std::size_t index_;
+};
+
+/**
+ *  Counts and times a call to a C API function, from construction to
+ *  destruction, if instrumentation is enabled.
+ *
+ *  The counters are kept per thread, so calls made concurrently from
+ *  different threads never contend.  They are summed over all threads,
+ *  including ones which have exited, by `get_api_stats()`.
+ */
+class api_call_timer
+{
+public:
+    explicit api_call_timer(const api_function& function) noexcept
+        : function_(function)
+        , enabled_(g_apiStatsEnabled.load(std::memory_order_relaxed))
+    {
+        if (enabled_) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~api_call_timer() noexcept
+    {
+        if (enabled_) record(function_.index(), std::chrono::steady_clock::now() - start_);
+    }
+
+    api_call_timer(const api_call_timer&) = delete;
+    api_call_timer& operator=(const api_call_timer&) = delete;
+
+private:
+    static void record(std::size_t function, std::chrono::nanoseconds time) noexcept;
+
+    const api_function& function_;
+    bool enabled_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// Returns the counters of every function which has been called while instrumentation was enabled.
+std::vector<api_call_stats> get_api_stats();
+
+/// Resets all counters to zero.
+void reset_api_stats();
+
+} // namespace cosimc
+
+
+/// Instruments the C API function in which it is placed.
+#define COSIMC_API_CALL()                                             \
+    static const ::cosimc::api_function cosimcApiFunction(__func__); \
+    const ::cosimc::api_call_timer cosimcApiCallTimer(cosimcApiFunction)
+
+#endif // header guard
@@ -0,0 +1,455 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "comparator_observer.hpp"
+
+#include "error.hpp"
+#include "mapped_file.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/exception.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// Returns `s` without leading and trailing whitespace and quotes.
+std::string_view trim(std::string_view s)
+{
+    const auto isJunk = [](char c) { return std::isspace(static_cast<unsigned char>(c)) || c == '"'; };
+    while (!s.empty() && isJunk(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isJunk(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Splits one CSV line into fields.  `fields` is reused between calls to
+// avoid allocating for every row.
+void split_fields(std::string_view line, std::vector<std::string_view>& fields)
+{
+    fields.clear();
+    std::size_t begin = 0;
+    for (;;) {
+        const auto end = line.find(',', begin);
+        fields.push_back(trim(line.substr(begin, end - begin)));
+        if (end == std::string_view::npos) break;
+        begin = end + 1;
+    }
+}
+
+// Strips the " [<reference> <TYPE>]" suffix which `file_observer` appends
+// to variable names in the header.
+std::string_view column_variable_name(std::string_view header)
+{
+    const auto bracket = header.find(" [");
+    return trim(header.substr(0, bracket));
+}
+
+// `strtod()` and friends require null-terminated input, which the fields
+// of a memory-mapped file are not.
+class field_parser
+{
+public:
+    bool parse_double(std::string_view field, double& value)
+    {
+        const char* s = terminate(field);
+        char* end = nullptr;
+        value = std::strtod(s, &end);
+        return end != s && *end == '\0';
+    }
+
+    bool parse_integer(std::string_view field, long long& value)
+    {
+        const char* s = terminate(field);
+        char* end = nullptr;
+        value = std::strtoll(s, &end, 10);
+        return end != s && *end == '\0';
+    }
+
+    bool parse_boolean(std::string_view field, bool& value)
+    {
+        if (field == "1" || field == "true") {
+            value = true;
+        } else if (field == "0" || field == "false") {
+            value = false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const char* terminate(std::string_view field)
+    {
+        buffer_.assign(field.data(), field.size());
+        return buffer_.c_str();
+    }
+
+    std::string buffer_;
+};
+
+// Returns whether `stem` is `simulatorName` followed by the timestamp
+// suffix which `file_observer` adds to its file names
+// ("_YYYYMMDD_HHMMSS_ffffff").
+bool is_recording_of(std::string_view stem, std::string_view simulatorName)
+{
+    if (stem == simulatorName) return true;
+    if (stem.size() <= simulatorName.size() + 1 ||
+        stem.substr(0, simulatorName.size()) != simulatorName ||
+        stem[simulatorName.size()] != '_') {
+        return false;
+    }
+    auto suffix = stem.substr(simulatorName.size() + 1);
+    const std::size_t groupLengths[] = {8, 6, 0};
+    for (std::size_t g = 0; g < 3; ++g) {
+        const auto end = std::min(suffix.find('_'), suffix.size());
+        const auto group = suffix.substr(0, end);
+        if (group.empty() || (groupLengths[g] != 0 && group.size() != groupLengths[g])) return false;
+        if (!std::all_of(group.begin(), group.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            return false;
+        }
+        if (g < 2 && end == suffix.size()) return false;
+        suffix.remove_prefix(std::min(end + 1, suffix.size()));
+    }
+    return suffix.empty();
+}
+
+std::optional<cosim::filesystem::path> find_reference_file(
+    const cosim::filesystem::path& referenceDir,
+    const std::string& simulatorName)
+{
+    std::optional<cosim::filesystem::path> found;
+    for (const auto& entry : cosim::filesystem::directory_iterator(referenceDir)) {
+        const auto& path = entry.path();
+        if (path.extension() != ".csv") continue;
+        if (!is_recording_of(path.stem().string(), simulatorName)) continue;
+        // The timestamp suffix sorts chronologically, so prefer the latest.
+        if (!found || path.filename().string() > found->filename().string()) {
+            found = path;
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+
+// Streams through the reference recording for one simulator.
+class comparator_observer::reference_stream
+{
+public:
+    struct column
+    {
+        std::size_t field;
+        std::string name;
+        cosim::variable_type type;
+        cosim::value_reference reference;
+        tolerance tol;
+    };
+
+    reference_stream(
+        const cosim::filesystem::path& path,
+        cosim::observable* simulator,
+        const std::function<tolerance(cosim::variable_type, cosim::value_reference)>& toleranceFor)
+        : file_(path)
+        , simulator_(simulator)
+        , name_(simulator->name())
+    {
+        const auto header = next_line();
+        if (!header) {
+            throw cosim::error(
+                cosim::make_error_code(cosim::errc::bad_file),
+                "Reference recording '" + path.string() + "' is empty");
+        }
+        split_fields(*header, fields_);
+
+        const auto modelDescription = simulator->model_description();
+        for (std::size_t f = 0; f < fields_.size(); ++f) {
+            const auto name = column_variable_name(fields_[f]);
+            if (name == "Time") {
+                timeField_ = f;
+                continue;
+            }
+            if (name == "StepCount") {
+                stepField_ = f;
+                continue;
+            }
+            const auto var = std::find_if(
+                modelDescription.variables.begin(),
+                modelDescription.variables.end(),
+                [&](const cosim::variable_description& vd) { return vd.name == name; });
+            if (var == modelDescription.variables.end()) continue;
+            simulator->expose_for_getting(var->type, var->reference);
+            columns_.push_back({f, var->name, var->type, var->reference, toleranceFor(var->type, var->reference)});
+        }
+        if (!stepField_) {
+            throw cosim::error(
+                cosim::make_error_code(cosim::errc::bad_file),
+                "Reference recording '" + path.string() + "' has no StepCount column");
+        }
+        dataBegin_ = position_;
+    }
+
+    const std::string& name() const noexcept { return name_; }
+
+    std::vector<column>& columns() noexcept { return columns_; }
+
+    // Advances to the row for `step` and makes it the current row.  Returns
+    // false if the reference has no row for this step.
+    bool seek(cosim::step_number step)
+    {
+        for (;;) {
+            if (!currentStep_) {
+                const auto line = next_line();
+                if (!line) return false;
+                if (trim(*line).empty()) continue;
+                split_fields(*line, fields_);
+                long long rowStep = 0;
+                if (*stepField_ >= fields_.size() || !parser_.parse_integer(fields_[*stepField_], rowStep)) {
+                    throw cosim::error(
+                        cosim::make_error_code(cosim::errc::bad_file),
+                        "Invalid step number in reference recording for '" + name_ + "'");
+                }
+                currentStep_ = static_cast<cosim::step_number>(rowStep);
+            }
+            if (*currentStep_ == step) return true;
+            if (*currentStep_ > step) return false;
+            currentStep_.reset();
+        }
+    }
+
+    // Compares the observed value of `col` with the current row.  Returns
+    // the two values if they differ by more than the tolerance.
+    std::optional<std::pair<double, double>> compare(const column& col)
+    {
+        if (col.field >= fields_.size()) return std::pair<double, double>(0.0, std::nan(""));
+        const auto field = fields_[col.field];
+        switch (col.type) {
+            case cosim::variable_type::real: {
+                double ref = 0.0;
+                if (!parser_.parse_double(field, ref)) return std::pair<double, double>(0.0, std::nan(""));
+                const double obs = simulator_->get_real(col.reference);
+                if (std::fabs(obs - ref) <= col.tol.absolute + col.tol.relative * std::fabs(ref)) {
+                    return std::nullopt;
+                }
+                return std::pair<double, double>(obs, ref);
+            }
+            case cosim::variable_type::integer: {
+                long long ref = 0;
+                if (!parser_.parse_integer(field, ref)) return std::pair<double, double>(0.0, std::nan(""));
+                const auto obs = static_cast<double>(simulator_->get_integer(col.reference));
+                const auto refd = static_cast<double>(ref);
+                if (std::fabs(obs - refd) <= col.tol.absolute + col.tol.relative * std::fabs(refd)) {
+                    return std::nullopt;
+                }
+                return std::pair<double, double>(obs, refd);
+            }
+            case cosim::variable_type::boolean: {
+                bool ref = false;
+                if (!parser_.parse_boolean(field, ref)) return std::pair<double, double>(0.0, std::nan(""));
+                const bool obs = simulator_->get_boolean(col.reference);
+                if (obs == ref) return std::nullopt;
+                return std::pair<double, double>(obs ? 1.0 : 0.0, ref ? 1.0 : 0.0);
+            }
+            case cosim::variable_type::string: {
+                if (std::string_view(simulator_->get_string(col.reference)) == field) return std::nullopt;
+                return std::pair<double, double>(std::nan(""), std::nan(""));
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    // Moves back to the first row, so that earlier steps can be found again.
+    void rewind()
+    {
+        position_ = dataBegin_;
+        currentStep_.reset();
+    }
+
+    std::optional<double> current_time()
+    {
+        double t = 0.0;
+        if (!timeField_ || *timeField_ >= fields_.size() || !parser_.parse_double(fields_[*timeField_], t)) {
+            return std::nullopt;
+        }
+        return t;
+    }
+
+private:
+    std::optional<std::string_view> next_line()
+    {
+        if (position_ >= file_.size()) return std::nullopt;
+        const auto data = std::string_view(file_.data(), file_.size());
+        auto end = data.find('\n', position_);
+        if (end == std::string_view::npos) end = data.size();
+        auto line = data.substr(position_, end - position_);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        position_ = end + 1;
+        return line;
+    }
+
+    mapped_file file_;
+    cosim::observable* simulator_;
+    std::string name_;
+    std::vector<column> columns_;
+    std::optional<std::size_t> timeField_;
+    std::optional<std::size_t> stepField_;
+    std::size_t dataBegin_ = 0;
+    std::size_t position_ = 0;
+    std::optional<cosim::step_number> currentStep_;
+    std::vector<std::string_view> fields_;
+    field_parser parser_;
+};
+
+
+comparator_observer::comparator_observer(
+    const cosim::filesystem::path& referenceDir,
+    double absoluteTolerance,
+    double relativeTolerance)
+    : referenceDir_(referenceDir)
+    , defaultTolerance_{absoluteTolerance, relativeTolerance}
+{
+    if (!cosim::filesystem::is_directory(referenceDir_)) {
+        throw std::invalid_argument("Reference directory '" + referenceDir_.string() + "' does not exist");
+    }
+    if (absoluteTolerance < 0.0 || relativeTolerance < 0.0) {
+        throw std::invalid_argument("Tolerances must be non-negative");
+    }
+}
+
+comparator_observer::~comparator_observer() noexcept = default;
+
+void comparator_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* simulator,
+    cosim::time_point)
+{
+    const auto path = find_reference_file(referenceDir_, simulator->name());
+    if (!path) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& overrides = tolerances_[index];
+    streams_[index] = std::make_unique<reference_stream>(
+        *path,
+        simulator,
+        [&](cosim::variable_type type, cosim::value_reference reference) {
+            const auto it = overrides.find({type, reference});
+            return it == overrides.end() ? defaultTolerance_ : it->second;
+        });
+}
+
+void comparator_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(index);
+}
+
+void comparator_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void comparator_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void comparator_observer::simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : streams_) {
+        compare(entry.first, firstStep, startTime);
+    }
+}
+
+void comparator_observer::step_complete(cosim::step_number, cosim::duration, cosim::time_point) { }
+
+void comparator_observer::simulator_step_complete(
+    cosim::simulator_index index,
+    cosim::step_number lastStep,
+    cosim::duration,
+    cosim::time_point currentTime)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (streams_.count(index)) compare(index, lastStep, currentTime);
+}
+
+void comparator_observer::state_restored(cosim::step_number, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : streams_) entry.second->rewind();
+}
+
+void comparator_observer::set_tolerance(
+    cosim::variable_id variable,
+    double absoluteTolerance,
+    double relativeTolerance)
+{
+    if (absoluteTolerance < 0.0 || relativeTolerance < 0.0) {
+        throw std::invalid_argument("Tolerances must be non-negative");
+    }
+    const auto tol = tolerance{absoluteTolerance, relativeTolerance};
+    std::lock_guard<std::mutex> lock(mutex_);
+    tolerances_[variable.simulator][{variable.type, variable.reference}] = tol;
+    const auto stream = streams_.find(variable.simulator);
+    if (stream == streams_.end()) return;
+    for (auto& col : stream->second->columns()) {
+        if (col.type == variable.type && col.reference == variable.reference) col.tol = tol;
+    }
+}
+
+std::optional<divergence> comparator_observer::first_divergence() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return divergence_;
+}
+
+void comparator_observer::compare(
+    cosim::simulator_index index,
+    cosim::step_number step,
+    cosim::time_point time)
+{
+    // Once diverged, the execution is aborted, so there is no point in
+    // comparing anything else.
+    if (divergence_) return;
+
+    auto& stream = *streams_.at(index);
+    // Steps which are missing from the reference (e.g. because it was
+    // recorded with a decimating log configuration, or because it ends
+    // earlier) are not compared.
+    if (!stream.seek(step)) return;
+
+    for (const auto& col : stream.columns()) {
+        const auto mismatch = stream.compare(col);
+        if (!mismatch) continue;
+
+        divergence d;
+        d.variable = cosim::variable_id{index, col.type, col.reference};
+        d.simulator_name = stream.name();
+        d.variable_name = col.name;
+        d.step = step;
+        d.time = time;
+        d.observed_value = mismatch->first;
+        d.reference_value = mismatch->second;
+        divergence_ = d;
+
+        std::ostringstream msg;
+        msg << "Divergence from reference at step " << step
+            << " (t = " << cosim::to_double_time_point(time) << " s";
+        if (const auto refTime = stream.current_time()) {
+            msg << ", reference t = " << *refTime << " s";
+        }
+        msg << "): variable '" << col.name << "' of simulator '" << stream.name()
+            << "' has value " << d.observed_value << ", expected " << d.reference_value
+            << " (absolute tolerance " << col.tol.absolute
+            << ", relative tolerance " << col.tol.relative << ")";
+        throw error(COSIM_ERRC_REFERENCE_DIVERGENCE, msg.str());
+    }
+}
+
+} // namespace cosimc
@@ -0,0 +1,117 @@
+/**
+ *  \file
+ *  \brief An observer which compares a simulation against a reference recording.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_COMPARATOR_OBSERVER_HPP
+#define LIBCOSIMC_COMPARATOR_OBSERVER_HPP
+
+#include <cosim/fs_portability.hpp>
+#include <cosim/model_description.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+
+namespace cosimc
+{
+
+/// Information about a value which differs from its reference value.
+struct divergence
+{
+    cosim::variable_id variable;
+    std::string simulator_name;
+    std::string variable_name;
+    cosim::step_number step = 0;
+    cosim::time_point time;
+    double observed_value = 0.0;
+    double reference_value = 0.0;
+};
+
+
+/**
+ *  An observer which compares observed values against a reference recording
+ *  while the simulation is running.
+ *
+ *  The reference is a directory of CSV files in the format produced by
+ *  `cosim::file_observer`, one file per simulator.  The files are memory
+ *  mapped and streamed through in step with the simulation, so the cost of
+ *  a comparison does not depend on the length of the recording.  Simulators
+ *  for which there is no reference file are not compared.
+ *
+ *  A value matches its reference when
+ *  `|observed - reference| <= absoluteTolerance + relativeTolerance * |reference|`.
+ *  String values must match exactly.  At the first mismatch, a detailed
+ *  report is stored and a `cosimc::error` with the code
+ *  `COSIM_ERRC_REFERENCE_DIVERGENCE` is thrown, which aborts the execution.
+ */
+class comparator_observer : public cosim::observer
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param referenceDir
+     *      The directory which contains the reference recording.
+     *  \param absoluteTolerance
+     *      The default absolute tolerance.
+     *  \param relativeTolerance
+     *      The default relative tolerance.
+     */
+    comparator_observer(
+        const cosim::filesystem::path& referenceDir,
+        double absoluteTolerance,
+        double relativeTolerance);
+
+    ~comparator_observer() noexcept override;
+
+    comparator_observer(const comparator_observer&) = delete;
+    comparator_observer& operator=(const comparator_observer&) = delete;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+    /// Overrides the default tolerances for one specific variable.
+    void set_tolerance(cosim::variable_id variable, double absoluteTolerance, double relativeTolerance);
+
+    /// Returns the first divergence that was detected, if any.
+    std::optional<divergence> first_divergence() const;
+
+private:
+    class reference_stream;
+
+    struct tolerance
+    {
+        double absolute;
+        double relative;
+    };
+
+    void compare(cosim::simulator_index index, cosim::step_number step, cosim::time_point time);
+
+    cosim::filesystem::path referenceDir_;
+    tolerance defaultTolerance_;
+    std::map<cosim::simulator_index, std::unique_ptr<reference_stream>> streams_;
+    std::unordered_map<cosim::simulator_index, std::map<std::pair<cosim::variable_type, cosim::value_reference>, tolerance>> tolerances_;
+    std::optional<divergence> divergence_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,630 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "config_validator.hpp"
+
+#include "parallel_unzip.hpp"
+#include "ssp_archive.hpp"
+#include "xml_document.hpp"
+
+#include <cosim/model_description.hpp>
+#include <cosim/uri.hpp>
+#include <cosim/utility/filesystem.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+
+namespace cosimc
+{
+namespace
+{
+
+const char* type_name(cosim::variable_type type)
+{
+    switch (type) {
+        case cosim::variable_type::real: return "Real";
+        case cosim::variable_type::integer: return "Integer";
+        case cosim::variable_type::boolean: return "Boolean";
+        case cosim::variable_type::string: return "String";
+        case cosim::variable_type::enumeration: return "Enumeration";
+        default: return "unknown";
+    }
+}
+
+std::optional<cosim::variable_type> parse_type_name(const std::string& name)
+{
+    if (name == "Real") return cosim::variable_type::real;
+    if (name == "Integer") return cosim::variable_type::integer;
+    if (name == "Boolean") return cosim::variable_type::boolean;
+    if (name == "String") return cosim::variable_type::string;
+    if (name == "Enumeration") return cosim::variable_type::enumeration;
+    return std::nullopt;
+}
+
+bool is_connectable_output(cosim::variable_causality causality)
+{
+    return causality == cosim::variable_causality::output ||
+        causality == cosim::variable_causality::calculated_parameter;
+}
+
+std::optional<double> parse_double(const std::string& s)
+{
+    if (s.empty()) return std::nullopt;
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(s.c_str(), &end);
+    if (*end != '\0' || errno == ERANGE) return std::nullopt;
+    return value;
+}
+
+bool is_valid_value(cosim::variable_type type, const std::string& value)
+{
+    switch (type) {
+        case cosim::variable_type::real:
+            return parse_double(value).has_value();
+        case cosim::variable_type::integer:
+        case cosim::variable_type::enumeration: {
+            if (value.empty()) return false;
+            char* end = nullptr;
+            errno = 0;
+            const long v = std::strtol(value.c_str(), &end, 10);
+            return *end == '\0' && errno != ERANGE && v >= INT32_MIN && v <= INT32_MAX;
+        }
+        case cosim::variable_type::boolean:
+            return value == "true" || value == "false" || value == "1" || value == "0";
+        default:
+            return true;
+    }
+}
+
+cosim::variable_causality parse_causality(const xml_element& variable, bool fmi1)
+{
+    const auto causality = variable.attribute("causality").value_or(fmi1 ? "internal" : "local");
+    if (causality == "input") return cosim::variable_causality::input;
+    if (causality == "output") return cosim::variable_causality::output;
+    if (fmi1 && (causality == "internal" || causality == "none")) return cosim::variable_causality::local;
+    if (!fmi1) {
+        if (causality == "parameter") return cosim::variable_causality::parameter;
+        if (causality == "calculatedParameter") return cosim::variable_causality::calculated_parameter;
+        if (causality == "local" || causality == "independent") return cosim::variable_causality::local;
+    }
+    throw std::runtime_error(
+        "Line " + std::to_string(variable.line) + ": Invalid causality '" + causality + "'");
+}
+
+cosim::variable_variability parse_variability(const xml_element& variable, bool fmi1)
+{
+    const auto variability = variable.attribute("variability").value_or("continuous");
+    if (variability == "constant") return cosim::variable_variability::constant;
+    if (variability == "discrete") return cosim::variable_variability::discrete;
+    if (variability == "continuous") return cosim::variable_variability::continuous;
+    if (fmi1 && variability == "parameter") return cosim::variable_variability::fixed;
+    if (!fmi1) {
+        if (variability == "fixed") return cosim::variable_variability::fixed;
+        if (variability == "tunable") return cosim::variable_variability::tunable;
+    }
+    throw std::runtime_error(
+        "Line " + std::to_string(variable.line) + ": Invalid variability '" + variability + "'");
+}
+
+// Reads an FMI 1.0 or 2.0 model description, as far as it is needed for
+// validation.  Start values are not read.
+std::shared_ptr<const cosim::model_description> parse_model_description(const xml_element& root)
+{
+    if (root.name != "fmiModelDescription") {
+        throw std::runtime_error("Expected <fmiModelDescription> as the root element, found <" + root.name + ">");
+    }
+    const auto fmiVersion = root.attribute("fmiVersion").value_or("");
+    const bool fmi1 = fmiVersion == "1.0";
+    if (!fmi1 && fmiVersion != "2.0") {
+        throw std::runtime_error("Unsupported FMI version '" + fmiVersion + "'");
+    }
+
+    auto description = std::make_shared<cosim::model_description>();
+    description->name = root.attribute("modelName").value_or("");
+    description->uuid = root.attribute("guid").value_or("");
+    description->description = root.attribute("description").value_or("");
+    description->author = root.attribute("author").value_or("");
+    description->version = root.attribute("version").value_or("");
+
+    const auto variables = root.child("ModelVariables");
+    for (const auto sv : variables ? variables->children_named("ScalarVariable") : std::vector<const xml_element*>()) {
+        const auto lineInfo = "Line " + std::to_string(sv->line) + ": ";
+        cosim::variable_description v;
+        v.name = sv->attribute("name").value_or("");
+        const auto reference = sv->attribute("valueReference").value_or("");
+        char* end = nullptr;
+        errno = 0;
+        const auto vr = std::strtoul(reference.c_str(), &end, 10);
+        if (reference.empty() || *end != '\0' || errno == ERANGE || vr > UINT32_MAX) {
+            throw std::runtime_error(lineInfo + "Invalid value reference '" + reference + "'");
+        }
+        v.reference = static_cast<cosim::value_reference>(vr);
+        std::optional<cosim::variable_type> type;
+        for (const auto& c : sv->children) {
+            if ((type = parse_type_name(c.name))) break;
+        }
+        if (!type) {
+            throw std::runtime_error(lineInfo + "Variable '" + v.name + "' has no type");
+        }
+        v.type = *type;
+        v.causality = parse_causality(*sv, fmi1);
+        v.variability = parse_variability(*sv, fmi1);
+        // FMI 1.0 has no parameter causality, only parameter variability.
+        if (fmi1 && sv->attribute("variability") == "parameter") {
+            v.causality = cosim::variable_causality::parameter;
+        }
+        description->variables.push_back(std::move(v));
+    }
+    return description;
+}
+
+// Collects problems, each prefixed with the file name and line number.
+class problem_report
+{
+public:
+    explicit problem_report(std::string fileName)
+        : fileName_(std::move(fileName))
+    { }
+
+    void add(int line, const std::string& message)
+    {
+        problems_.push_back(fileName_ + ":" + std::to_string(line) + ": " + message);
+    }
+
+    std::vector<std::string> release() { return std::move(problems_); }
+
+private:
+    std::string fileName_;
+    std::vector<std::string> problems_;
+};
+
+// The simulators of a system, with their model descriptions, and the
+// checks which are common to all configuration formats.
+class system_checker
+{
+public:
+    system_checker(problem_report& report, cosim::model_uri_resolver& resolver, cosim::uri baseUri)
+        : report_(report)
+        , resolver_(resolver)
+        , baseUri_(std::move(baseUri))
+    { }
+
+    // Adds a simulator, loading its model description.  Returns false if
+    // the simulator could not be added.
+    bool add_simulator(int line, const std::optional<std::string>& name, const std::optional<std::string>& source)
+    {
+        if (!name || name->empty()) {
+            report_.add(line, "Simulator has no name");
+            return false;
+        }
+        if (simulators_.count(*name)) {
+            report_.add(line, "Duplicate simulator name '" + *name + "'");
+            return false;
+        }
+        auto& sim = simulators_[*name];
+        if (!source || source->empty()) {
+            report_.add(line, "Simulator '" + *name + "' has no source");
+            return false;
+        }
+        sim.description = load_model(line, *name, *source);
+        if (!sim.description) return false;
+        for (const auto& v : sim.description->variables) {
+            sim.variables.emplace(v.name, &v);
+        }
+        return true;
+    }
+
+    bool has_simulator(const std::string& name) const
+    {
+        return simulators_.count(name) > 0;
+    }
+
+    // Looks up a variable, reporting a problem if it could not be found.
+    // Problems with simulators which failed to load are not repeated.
+    const cosim::variable_description* find_variable(
+        int line,
+        const std::string& context,
+        const std::optional<std::string>& simulator,
+        const std::optional<std::string>& variable)
+    {
+        if (!simulator || !variable) {
+            report_.add(line, context + ": Missing simulator or variable name");
+            return nullptr;
+        }
+        const auto sim = simulators_.find(*simulator);
+        if (sim == simulators_.end()) {
+            report_.add(line, context + ": Unknown simulator '" + *simulator + "'");
+            return nullptr;
+        }
+        if (!sim->second.description) return nullptr;
+        const auto var = sim->second.variables.find(*variable);
+        if (var == sim->second.variables.end()) {
+            report_.add(line, context + ": Simulator '" + *simulator + "' has no variable '" + *variable + "'");
+            return nullptr;
+        }
+        return var->second;
+    }
+
+    void check_connection(
+        int line,
+        const std::optional<std::string>& sourceSimulator,
+        const std::optional<std::string>& sourceVariable,
+        const std::optional<std::string>& targetSimulator,
+        const std::optional<std::string>& targetVariable)
+    {
+        const auto context = "Connection " + qualified(sourceSimulator, sourceVariable) +
+            " -> " + qualified(targetSimulator, targetVariable);
+        const auto source = find_variable(line, context, sourceSimulator, sourceVariable);
+        const auto target = find_variable(line, context, targetSimulator, targetVariable);
+        if (source && !is_connectable_output(source->causality)) {
+            report_.add(line, context + ": '" + *sourceVariable + "' is not an output");
+        }
+        if (target) check_connected_input(line, context, *targetSimulator, *target);
+        if (source && target && source->type != target->type) {
+            report_.add(line, context + ": Type mismatch (" + type_name(source->type) + " -> " + type_name(target->type) + ")");
+        }
+    }
+
+    // Checks that `target` is an input which has not been connected before.
+    void check_connected_input(
+        int line,
+        const std::string& context,
+        const std::string& simulator,
+        const cosim::variable_description& target)
+    {
+        if (target.causality != cosim::variable_causality::input) {
+            report_.add(line, context + ": '" + target.name + "' is not an input");
+            return;
+        }
+        const auto inserted = connectedInputs_.emplace(std::make_pair(simulator, target.name), line);
+        if (!inserted.second) {
+            report_.add(line, context + ": Input '" + simulator + "." + target.name +
+                    "' is already connected on line " + std::to_string(inserted.first->second));
+        }
+    }
+
+    void check_initial_value(
+        int line,
+        const std::string& simulator,
+        const std::optional<std::string>& variable,
+        const std::string& typeName,
+        const std::optional<std::string>& value)
+    {
+        const auto context = "Initial value of " + qualified(simulator, variable);
+        const auto var = find_variable(line, context, simulator, variable);
+        if (!var) return;
+        const auto type = parse_type_name(typeName);
+        if (!type) {
+            report_.add(line, context + ": Unknown value type '" + typeName + "'");
+            return;
+        }
+        if (*type != var->type) {
+            report_.add(line, context + ": Value is " + typeName + ", but the variable is " + type_name(var->type));
+        } else if (!value) {
+            report_.add(line, context + ": Missing value");
+        } else if (!is_valid_value(*type, *value)) {
+            report_.add(line, context + ": Invalid " + typeName + " value '" + *value + "'");
+        }
+        if (var->variability == cosim::variable_variability::constant) {
+            report_.add(line, context + ": The variable is a constant");
+        }
+    }
+
+private:
+    struct simulator
+    {
+        std::shared_ptr<const cosim::model_description> description;
+        std::unordered_map<std::string, const cosim::variable_description*> variables;
+    };
+
+    static std::string qualified(const std::optional<std::string>& simulator, const std::optional<std::string>& variable)
+    {
+        return "'" + simulator.value_or("?") + "." + variable.value_or("?") + "'";
+    }
+
+    // Loads a model description, reusing it for simulators with the same source.
+    std::shared_ptr<const cosim::model_description> load_model(int line, const std::string& name, const std::string& source)
+    {
+        const auto cached = models_.find(source);
+        if (cached != models_.end()) return cached->second;
+        std::shared_ptr<const cosim::model_description> description;
+        try {
+            description = read_model_description(source);
+        } catch (const std::exception& e) {
+            report_.add(line, "Failed to load model '" + source + "' for simulator '" + name + "': " + e.what());
+        }
+        models_.emplace(source, description);
+        return description;
+    }
+
+    // Local FMUs are not unpacked, only their model descriptions are read.
+    // Models with other URIs are loaded with the resolver.
+    std::shared_ptr<const cosim::model_description> read_model_description(const std::string& source)
+    {
+        const auto uri = cosim::resolve_reference(baseUri_, cosim::uri(source));
+        if (uri.scheme() == "file") {
+            const auto path = cosim::file_uri_to_path(uri);
+            if (cosim::filesystem::is_directory(path)) {
+                return parse_model_description(read_xml_file(path / "modelDescription.xml"));
+            }
+            if (path.extension() == ".fmu") {
+                const auto unpackDir = cosim::utility::temp_dir();
+                extract_zip_entries(path, {"modelDescription.xml"}, unpackDir.path(), 1);
+                return parse_model_description(read_xml_file(unpackDir.path() / "modelDescription.xml"));
+            }
+        }
+        return resolver_.lookup_model(baseUri_, source)->description();
+    }
+
+    problem_report& report_;
+    cosim::model_uri_resolver& resolver_;
+    cosim::uri baseUri_;
+    std::map<std::string, std::shared_ptr<const cosim::model_description>> models_;
+    std::map<std::string, simulator> simulators_;
+    std::map<std::pair<std::string, std::string>, int> connectedInputs_;
+};
+
+void check_positive_time(problem_report& report, const xml_element* element, const std::string& what)
+{
+    if (!element) return;
+    const auto value = parse_double(element->text);
+    if (!value || *value <= 0.0) {
+        report.add(element->line, "Invalid " + what + " '" + element->text + "'");
+    }
+}
+
+// The initial value elements of OSP configs and SSV parameters both contain
+// an element named after the value type, with a `value` attribute.
+const xml_element* typed_value(problem_report& report, const xml_element& parent, const std::string& context)
+{
+    for (const auto& c : parent.children) {
+        if (parse_type_name(c.name)) return &c;
+    }
+    report.add(parent.line, context + ": No typed value");
+    return nullptr;
+}
+
+} // namespace
+
+
+std::vector<std::string> validate_osp_config(
+    const cosim::filesystem::path& configPath,
+    cosim::model_uri_resolver& resolver)
+{
+    const auto file = cosim::filesystem::is_directory(configPath)
+        ? configPath / "OspSystemStructure.xml"
+        : configPath;
+    problem_report report(file.filename().string());
+
+    xml_element root;
+    try {
+        root = read_xml_file(file);
+    } catch (const std::system_error&) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        report.add(0, e.what());
+        return report.release();
+    }
+    if (root.name != "OspSystemStructure") {
+        report.add(root.line, "Expected <OspSystemStructure> as the root element, found <" + root.name + ">");
+        return report.release();
+    }
+    if (const auto startTime = root.child("StartTime"); startTime && !parse_double(startTime->text)) {
+        report.add(startTime->line, "Invalid start time '" + startTime->text + "'");
+    }
+    check_positive_time(report, root.child("BaseStepSize"), "base step size");
+
+    system_checker checker(report, resolver, cosim::path_to_file_uri(file));
+
+    const auto simulators = root.child("Simulators");
+    if (!simulators) report.add(root.line, "No <Simulators> element");
+    std::vector<std::pair<std::string, const xml_element*>> added;
+    for (const auto sim : simulators ? simulators->children_named("Simulator") : std::vector<const xml_element*>()) {
+        const auto name = sim->attribute("name");
+        if (const auto stepSize = sim->attribute("stepSize")) {
+            const auto value = parse_double(*stepSize);
+            if (!value || *value <= 0.0) report.add(sim->line, "Invalid step size '" + *stepSize + "'");
+        }
+        if (checker.add_simulator(sim->line, name, sim->attribute("source"))) {
+            added.emplace_back(*name, sim);
+        }
+    }
+    for (const auto& [name, sim] : added) {
+        const auto initialValues = sim->child("InitialValues");
+        if (!initialValues) continue;
+        for (const auto iv : initialValues->children_named("InitialValue")) {
+            const auto variable = iv->attribute("variable");
+            const auto value = typed_value(report, *iv, "Initial value of '" + name + "." + variable.value_or("?") + "'");
+            if (!value) continue;
+            checker.check_initial_value(value->line, name, variable, value->name, value->attribute("value"));
+        }
+    }
+
+    std::set<std::string> functions;
+    if (const auto fs = root.child("Functions")) {
+        for (const auto& f : fs->children) {
+            const auto name = f.attribute("name");
+            if (!name || !functions.insert(*name).second) {
+                report.add(f.line, "Function has no name, or a duplicate name");
+            }
+        }
+    }
+
+    const auto connections = root.child("Connections");
+    for (const auto& c : connections ? connections->children : std::vector<xml_element>()) {
+        const auto variables = c.children_named("Variable");
+        if (c.name == "VariableConnection") {
+            if (variables.size() != 2) {
+                report.add(c.line, "A variable connection must have exactly two variables");
+                continue;
+            }
+            checker.check_connection(
+                c.line,
+                variables[0]->attribute("simulator"),
+                variables[0]->attribute("name"),
+                variables[1]->attribute("simulator"),
+                variables[1]->attribute("name"));
+        } else if (c.name == "SignalConnection") {
+            const auto signal = c.child("Signal");
+            if (!signal || variables.size() != 1) {
+                report.add(c.line, "A signal connection must have one signal and one variable");
+                continue;
+            }
+            const auto function = signal->attribute("function").value_or("");
+            if (!functions.count(function)) {
+                report.add(c.line, "Signal connection: Unknown function '" + function + "'");
+            }
+            const auto sim = variables[0]->attribute("simulator");
+            const auto name = variables[0]->attribute("name");
+            const auto context = "Signal connection '" + function + "." + signal->attribute("name").value_or("?") + "'";
+            const auto var = checker.find_variable(c.line, context, sim, name);
+            if (!var) continue;
+            // Function inputs are named "in...", and function outputs "out...".
+            if (signal->attribute("name").value_or("").rfind("out", 0) == 0) {
+                checker.check_connected_input(c.line, context, *sim, *var);
+            } else if (!is_connectable_output(var->causality)) {
+                report.add(c.line, context + ": '" + *name + "' is not an output");
+            }
+            if (var->type != cosim::variable_type::real) {
+                report.add(c.line, context + ": Functions only accept Real variables");
+            }
+        } else if (c.name == "VariableGroupConnection" || c.name == "SignalGroupConnection") {
+            // Variable groups are defined in separate OSP model descriptions,
+            // so only the simulators are checked.
+            for (const auto v : c.children_named("VariableGroup")) {
+                const auto sim = v->attribute("simulator");
+                if (sim && !checker.has_simulator(*sim)) {
+                    report.add(c.line, "Group connection: Unknown simulator '" + *sim + "'");
+                }
+            }
+        } else {
+            report.add(c.line, "Unknown connection type <" + c.name + ">");
+        }
+    }
+    return report.release();
+}
+
+
+std::vector<std::string> validate_ssp(
+    const cosim::filesystem::path& sspDir,
+    cosim::model_uri_resolver& resolver)
+{
+    if (is_ssp_archive(sspDir)) {
+        const auto unpackDir = cosim::utility::temp_dir();
+        unpack_ssp_model_descriptions(sspDir, unpackDir.path());
+        return validate_ssp(unpackDir.path(), resolver);
+    }
+    const auto file = cosim::filesystem::is_directory(sspDir)
+        ? sspDir / "SystemStructure.ssd"
+        : sspDir;
+    problem_report report(file.filename().string());
+
+    xml_element root;
+    try {
+        root = read_xml_file(file);
+    } catch (const std::system_error&) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        report.add(0, e.what());
+        return report.release();
+    }
+    if (root.name != "SystemStructureDescription") {
+        report.add(root.line, "Expected <SystemStructureDescription> as the root element, found <" + root.name + ">");
+        return report.release();
+    }
+    const auto system = root.child("System");
+    if (!system) {
+        report.add(root.line, "No <System> element");
+        return report.release();
+    }
+
+    system_checker checker(report, resolver, cosim::path_to_file_uri(file));
+
+    const auto elements = system->child("Elements");
+    for (const auto component : elements ? elements->children_named("Component") : std::vector<const xml_element*>()) {
+        const auto name = component->attribute("name");
+        if (!checker.add_simulator(component->line, name, component->attribute("source"))) continue;
+
+        if (const auto connectors = component->child("Connectors")) {
+            for (const auto connector : connectors->children_named("Connector")) {
+                const auto context = "Connector '" + *name + "." + connector->attribute("name").value_or("?") + "'";
+                const auto var = checker.find_variable(connector->line, context, name, connector->attribute("name"));
+                if (!var) continue;
+                const auto kind = connector->attribute("kind").value_or("");
+                const bool kindMatches =
+                    (kind == "input" && var->causality == cosim::variable_causality::input) ||
+                    (kind == "output" && var->causality == cosim::variable_causality::output) ||
+                    (kind == "parameter" && var->causality == cosim::variable_causality::parameter) ||
+                    (kind == "calculatedParameter" && var->causality == cosim::variable_causality::calculated_parameter) ||
+                    kind == "inout";
+                if (!kindMatches) {
+                    report.add(connector->line, context + ": Kind '" + kind + "' does not match the variable's causality");
+                }
+                for (const auto& t : connector->children) {
+                    const auto type = parse_type_name(t.name);
+                    if (type && *type != var->type) {
+                        report.add(t.line, context + ": Type is " + t.name + ", but the variable is " + type_name(var->type));
+                    }
+                }
+            }
+        }
+
+        const auto bindings = component->child("ParameterBindings");
+        for (const auto binding : bindings ? bindings->children_named("ParameterBinding") : std::vector<const xml_element*>()) {
+            const auto prefix = binding->attribute("prefix").value_or("");
+            xml_element external;
+            const xml_element* parameterSet = nullptr;
+            if (const auto source = binding->attribute("source")) {
+                try {
+                    external = read_xml_file(file.parent_path() / *source);
+                    parameterSet = &external;
+                } catch (const std::exception& e) {
+                    report.add(binding->line, "Failed to read parameter set '" + *source + "': " + e.what());
+                    continue;
+                }
+            } else if (const auto values = binding->child("ParameterValues")) {
+                parameterSet = values->child("ParameterSet");
+            }
+            const auto parameters = parameterSet ? parameterSet->child("Parameters") : nullptr;
+            for (const auto parameter : parameters ? parameters->children_named("Parameter") : std::vector<const xml_element*>()) {
+                auto variable = parameter->attribute("name");
+                if (variable && variable->rfind(prefix, 0) == 0) variable = variable->substr(prefix.size());
+                const auto value = typed_value(report, *parameter, "Parameter '" + *name + "." + variable.value_or("?") + "'");
+                if (!value) continue;
+                // Lines in external parameter sets are reported as the binding's.
+                const auto line = parameterSet == &external ? binding->line : value->line;
+                checker.check_initial_value(line, *name, variable, value->name, value->attribute("value"));
+            }
+        }
+    }
+
+    const auto connections = system->child("Connections");
+    for (const auto c : connections ? connections->children_named("Connection") : std::vector<const xml_element*>()) {
+        const auto startElement = c->attribute("startElement");
+        const auto endElement = c->attribute("endElement");
+        // Connections to the system's own connectors are not simulated.
+        if (!startElement || !endElement) continue;
+        checker.check_connection(
+            c->line,
+            startElement,
+            c->attribute("startConnector"),
+            endElement,
+            c->attribute("endConnector"));
+    }
+    return report.release();
+}
+
+} // namespace cosimc
@@ -0,0 +1,75 @@
+/**
+ *  \file
+ *  \brief Validation of system structure configurations without
+ *  instantiating any models.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_CONFIG_VALIDATOR_HPP
+#define LIBCOSIMC_CONFIG_VALIDATOR_HPP
+
+#include <cosim/fs_portability.hpp>
+#include <cosim/orchestration.hpp>
+
+#include <string>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  Validates an OSP system structure file.
+ *
+ *  The file is parsed, and the model description of each simulator is
+ *  loaded, but no models are instantiated.  For local FMUs, only the
+ *  `modelDescription.xml` file is extracted from the archive.  Then every
+ *  initial value, connection and simulator step size is checked, and every
+ *  problem which is found is reported, rather than just the first one.
+ *
+ *  Checks include: that referenced simulators, variables and functions
+ *  exist; that connections go from an output to an input of the same type;
+ *  that no input is connected more than once; that initial values have the
+ *  right type, parse, and are not given for constants.
+ *
+ *  \param configPath
+ *      The path to an `OspSystemStructure.xml` file, or to a directory
+ *      which contains one.
+ *  \param resolver
+ *      Used to load models which are not local FMUs.
+ *
+ *  \returns
+ *      The problems found, each on the form `file:line: message`.
+ *
+ *  \throws std::system_error if the file could not be read.
+ */
+std::vector<std::string> validate_osp_config(
+    const cosim::filesystem::path& configPath,
+    cosim::model_uri_resolver& resolver);
+
+/**
+ *  Validates an SSP system structure.
+ *
+ *  This works like `validate_osp_config()`, for the `SystemStructure.ssd`
+ *  file in an unpacked SSP.  Connectors, connections and component-level
+ *  parameter bindings are checked.
+ *
+ *  \param sspDir
+ *      The path to an unpacked SSP directory, an `.ssd` file, or an `.ssp`
+ *      archive.  Of an archive, only the system structure, the files it
+ *      refers to and the model descriptions of the FMUs are unpacked, with
+ *      `unpack_ssp_model_descriptions()`, into a temporary directory.
+ *  \param resolver
+ *      Used to load models which are not local FMUs.
+ *
+ *  \throws std::runtime_error if an archive could not be unpacked.
+ */
+std::vector<std::string> validate_ssp(
+    const cosim::filesystem::path& sspDir,
+    cosim::model_uri_resolver& resolver);
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,164 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "connection_processor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace cosimc
+{
+namespace
+{
+
+double seconds(cosim::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+
+bool operator==(const connection_options& a, const connection_options& b) noexcept
+{
+    return a.extrapolation_order == b.extrapolation_order &&
+        a.delay == b.delay &&
+        a.filter_time_constant == b.filter_time_constant;
+}
+
+bool operator!=(const connection_options& a, const connection_options& b) noexcept
+{
+    return !(a == b);
+}
+
+
+void validate(const connection_options& options)
+{
+    if (options.extrapolation_order < 0 || options.extrapolation_order > 2) {
+        throw std::invalid_argument("The extrapolation order must be 0, 1 or 2");
+    }
+    if (options.delay < cosim::duration::zero()) {
+        throw std::invalid_argument("The delay must be non-negative");
+    }
+    if (options.filter_time_constant < cosim::duration::zero()) {
+        throw std::invalid_argument("The filter time constant must be non-negative");
+    }
+}
+
+
+connection_processor::connection_processor(const connection_options& options)
+    : options_(options)
+{
+    validate(options);
+}
+
+double connection_processor::process(
+    cosim::time_point t,
+    double value,
+    cosim::time_point stepStart,
+    cosim::duration stepSize)
+{
+    if (options_.delay > cosim::duration::zero()) {
+        value = delay(t, value);
+    }
+    if (options_.filter_time_constant > cosim::duration::zero()) {
+        value = filter(t, value);
+    }
+    if (options_.extrapolation_order > 0) {
+        value = extrapolate(t, value, stepStart + stepSize / 2);
+    }
+    return value;
+}
+
+double connection_processor::delay(cosim::time_point t, double value)
+{
+    const auto at = [this](std::size_t i) -> sample& {
+        return delayBuffer_[(delayHead_ + i) % delayBuffer_.size()];
+    };
+
+    if (delayCount_ > 0 && at(delayCount_ - 1).t == t) {
+        at(delayCount_ - 1).value = value;
+    } else {
+        if (delayCount_ == delayBuffer_.size()) {
+            // Full; unroll into a buffer twice the size.
+            std::vector<sample> bigger(std::max<std::size_t>(8, 2 * delayBuffer_.size()));
+            for (std::size_t i = 0; i < delayCount_; ++i) bigger[i] = at(i);
+            delayBuffer_ = std::move(bigger);
+            delayHead_ = 0;
+        }
+        ++delayCount_;
+        at(delayCount_ - 1) = {t, value};
+    }
+
+    // Drop the samples which are no longer needed, i.e., all but the last
+    // one before the delayed time.
+    const auto delayed = t - options_.delay;
+    while (delayCount_ >= 2 && at(1).t <= delayed) {
+        delayHead_ = (delayHead_ + 1) % delayBuffer_.size();
+        --delayCount_;
+    }
+
+    const auto& s0 = at(0);
+    if (delayed <= s0.t || delayCount_ == 1) return s0.value;
+    const auto& s1 = at(1);
+    const double w = seconds(delayed - s0.t) / seconds(s1.t - s0.t);
+    return s0.value + w * (s1.value - s0.value);
+}
+
+double connection_processor::filter(cosim::time_point t, double value)
+{
+    const auto step = [this](const sample& from, cosim::time_point to, double u) {
+        const double alpha = 1.0 - std::exp(-seconds(to - from.t) / seconds(options_.filter_time_constant));
+        return from.value + alpha * (u - from.value);
+    };
+
+    if (!filterStarted_) {
+        filterState_ = {t, value};
+        filterStarted_ = true;
+    } else if (t == filterState_.t) {
+        filterState_.value = hasFilterPrevious_ ? step(filterPrevious_, t, value) : value;
+    } else {
+        filterPrevious_ = filterState_;
+        hasFilterPrevious_ = true;
+        filterState_ = {t, step(filterState_, t, value)};
+    }
+    return filterState_.value;
+}
+
+double connection_processor::extrapolate(cosim::time_point t, double value, cosim::time_point at)
+{
+    if (historySize_ > 0 && history_[0].t == t) {
+        history_[0].value = value;
+    } else {
+        std::copy_backward(history_.begin(), history_.end() - 1, history_.end());
+        history_[0] = {t, value};
+        historySize_ = std::min(historySize_ + 1, history_.size());
+    }
+
+    const auto order = std::min(
+        static_cast<std::size_t>(options_.extrapolation_order),
+        historySize_ - 1);
+    if (order == 0) return value;
+
+    // Lagrange interpolation through the `order + 1` newest samples,
+    // with times measured in seconds relative to the newest one.
+    const double x = seconds(at - t);
+    double result = 0.0;
+    for (std::size_t i = 0; i <= order; ++i) {
+        const double xi = seconds(history_[i].t - t);
+        double weight = 1.0;
+        for (std::size_t j = 0; j <= order; ++j) {
+            if (j == i) continue;
+            const double xj = seconds(history_[j].t - t);
+            weight *= (x - xj) / (xi - xj);
+        }
+        result += weight * history_[i].value;
+    }
+    return result;
+}
+
+} // namespace cosimc
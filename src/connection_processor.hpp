@@ -0,0 +1,130 @@
+/**
+ *  \file
+ *  \brief Processing of values passed through connections.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_CONNECTION_PROCESSOR_HPP
+#define LIBCOSIMC_CONNECTION_PROCESSOR_HPP
+
+#include <cosim/time.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Options for the processing of values passed through a real connection.
+struct connection_options
+{
+    /// The order (0, 1 or 2) of the polynomial used for input extrapolation.
+    int extrapolation_order = 0;
+
+    /// A transport delay, or zero for none.
+    cosim::duration delay{0};
+
+    /// The time constant of a first-order low-pass filter, or zero for none.
+    cosim::duration filter_time_constant{0};
+
+    /// Whether these options require any processing at all.
+    bool is_direct() const noexcept
+    {
+        return extrapolation_order == 0 &&
+            delay == cosim::duration::zero() &&
+            filter_time_constant == cosim::duration::zero();
+    }
+};
+
+bool operator==(const connection_options& a, const connection_options& b) noexcept;
+bool operator!=(const connection_options& a, const connection_options& b) noexcept;
+
+/// Throws `std::invalid_argument` if `options` are invalid.
+void validate(const connection_options& options);
+
+
+/**
+ *  Computes the value to apply to the input of a real connection, given the
+ *  history of the output.
+ *
+ *  The output passes through three stages, each of which is optional:
+ *
+ *    1. A transport delay.  Output samples are kept in a ring buffer, and the
+ *       value at `t - delay` is found by linear interpolation between them.
+ *       Until the delay has elapsed, the first sample is held.
+ *
+ *    2. A first-order low-pass filter, `T y' = u - y`, which is solved
+ *       exactly under the assumption that `u` is constant between samples.
+ *
+ *    3. Input extrapolation, which compensates for the fact that an input is
+ *       held constant over a step.  The history is fitted with a polynomial
+ *       of the specified order (a line through the two last samples, or a
+ *       parabola through the three last ones), which is evaluated at the
+ *       midpoint of the target's next step.  The midpoint minimises the
+ *       error of the constant input for signals which vary smoothly over the
+ *       step.
+ */
+class connection_processor
+{
+public:
+    explicit connection_processor(const connection_options& options);
+
+    /// Returns the options of this processor.
+    const connection_options& options() const noexcept { return options_; }
+
+    /**
+     *  Records a new output value and returns the value to apply to the input.
+     *
+     *  \param t
+     *      The time at which the output had the value `value`.  If this is
+     *      the same as for the previous call, the previous value is replaced.
+     *  \param value
+     *      The output value.
+     *  \param stepStart
+     *      The start of the next step of the target.
+     *  \param stepSize
+     *      The size of the next step of the target.
+     */
+    double process(
+        cosim::time_point t,
+        double value,
+        cosim::time_point stepStart,
+        cosim::duration stepSize);
+
+private:
+    struct sample
+    {
+        cosim::time_point t;
+        double value;
+    };
+
+    double delay(cosim::time_point t, double value);
+    double filter(cosim::time_point t, double value);
+    double extrapolate(cosim::time_point t, double value, cosim::time_point at);
+
+    connection_options options_;
+
+    // Delay: a ring buffer which grows as needed
+    std::vector<sample> delayBuffer_;
+    std::size_t delayHead_ = 0;
+    std::size_t delayCount_ = 0;
+
+    // Filter: the current state, and the one before it in case the current
+    // sample is replaced
+    bool filterStarted_ = false;
+    bool hasFilterPrevious_ = false;
+    sample filterState_{};
+    sample filterPrevious_{};
+
+    // Extrapolation: the newest samples, newest first
+    std::array<sample, 3> history_{};
+    std::size_t historySize_ = 0;
+};
+
+} // namespace cosimc
+#endif // header guard
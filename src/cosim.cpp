@@ -6,12 +6,30 @@
 #    define NOMINMAX
 #endif
 
+#include "api_stats.hpp"
+#include "comparator_observer.hpp"
+#include "config_validator.hpp"
+#include "error.hpp"
+#include "event_search.hpp"
+#include "expression_slave.hpp"
+#include "fixed_step_algorithm.hpp"
+#include "fmu_cache.hpp"
+#include "histogram_observer.hpp"
+#include "latency_observer.hpp"
+#include "override_manipulator.hpp"
+#include "psd_observer.hpp"
+#include "real_time_pacer.hpp"
+#include "replaceable_slave.hpp"
+#include "shm_input_manipulator.hpp"
+#include "ssp_archive.hpp"
+#include "state_hash_observer.hpp"
+#include "udp_bridge.hpp"
+
 #include <cosim.h>
 #include <cosim/algorithm.hpp>
 #include <cosim/exception.hpp>
 #include <cosim/execution.hpp>
 #include <cosim/fmi/fmu.hpp>
-#include <cosim/fmi/importer.hpp>
 #include <cosim/log/simple.hpp>
 #include <cosim/manipulator.hpp>
 #include <cosim/model_description.hpp>
@@ -20,6 +38,7 @@
 #include <cosim/osp_config_parser.hpp>
 #include <cosim/ssp/ssp_loader.hpp>
 #include <cosim/time.hpp>
+#include <cosim/utility/filesystem.hpp>
 
 #include <algorithm>
 #include <atomic>
@@ -35,6 +54,9 @@
 #include <string>
 #include <system_error>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -92,6 +114,8 @@ void handle_current_exception()
 {
     try {
         throw;
+    } catch (const cosimc::error& e) {
+        set_last_error(e.code(), e.what());
     } catch (const cosim::error& e) {
         set_last_error(e.code(), e.what());
     } catch (const std::system_error& e) {
@@ -137,11 +161,13 @@ void safe_strncpy(char* dest, const char* src, std::size_t count)
 
 cosim_errc cosim_last_error_code()
 {
+    COSIMC_API_CALL();
     return g_lastErrorCode;
 }
 
 const char* cosim_last_error_message()
 {
+    COSIMC_API_CALL();
     return g_lastErrorMessage.c_str();
 }
 
@@ -151,6 +177,10 @@ struct cosim_execution_s
     std::shared_ptr<cosim::real_time_config> real_time_config;
     std::shared_ptr<const cosim::real_time_metrics> real_time_metrics;
     cosim::entity_index_maps entity_maps;
+    std::shared_ptr<cosimc::fixed_step_algorithm> algorithm;
+    std::shared_ptr<cosimc::real_time_pacer> pacer;
+    std::shared_ptr<cosimc::state_hash_observer> state_hash_observer;
+    std::unordered_map<cosim_slave_index, std::shared_ptr<cosimc::replaceable_slave>> replaceable_slaves;
     std::thread t;
     std::future<bool> simulate_result;
     std::exception_ptr simulate_exception_ptr;
@@ -158,18 +188,47 @@ struct cosim_execution_s
     int error_code;
 };
 
+// Returns the execution's algorithm, or throws if the execution was created
+// with an algorithm from an SSP configuration.
+cosimc::fixed_step_algorithm& get_fixed_step_algorithm(cosim_execution* execution)
+{
+    if (!execution->algorithm) {
+        throw cosimc::error(
+            COSIM_ERRC_UNSUPPORTED_FEATURE,
+            "This function is not supported for executions which use the algorithm specified in an SSP configuration");
+    }
+    return *execution->algorithm;
+}
+
+// Sets up real-time pacing for a newly created execution.  Pacing is done by
+// our own observer, so the execution's built-in pacing is never enabled.
+void setup_real_time(cosim_execution* execution)
+{
+    execution->real_time_config = execution->cpp_execution->get_real_time_config();
+    execution->real_time_metrics = execution->cpp_execution->get_real_time_metrics();
+    execution->pacer = std::make_shared<cosimc::real_time_pacer>(execution->real_time_config);
+    execution->cpp_execution->add_observer(execution->pacer);
+    if (execution->algorithm) {
+        execution->algorithm->set_real_time_monitoring(
+            execution->real_time_config,
+            execution->real_time_metrics,
+            execution->pacer);
+    }
+}
+
 cosim_execution* cosim_execution_create(cosim_time_point startTime, cosim_duration stepSize)
 {
+    COSIMC_API_CALL();
     try {
         // No exceptions are possible right now, so try...catch and unique_ptr
         // are strictly unnecessary, but this will change soon enough.
         auto execution = std::make_unique<cosim_execution>();
 
+        execution->algorithm = std::make_shared<cosimc::fixed_step_algorithm>(to_duration(stepSize));
         execution->cpp_execution = std::make_unique<cosim::execution>(
             to_time_point(startTime),
-            std::make_unique<cosim::fixed_step_algorithm>(to_duration(stepSize)));
-        execution->real_time_config = execution->cpp_execution->get_real_time_config();
-        execution->real_time_metrics = execution->cpp_execution->get_real_time_metrics();
+            execution->algorithm);
+        setup_real_time(execution.get());
         execution->error_code = COSIM_ERRC_SUCCESS;
         execution->state = COSIM_EXECUTION_STOPPED;
 
@@ -185,21 +244,22 @@ cosim_execution* cosim_osp_config_execution_create(
     bool startTimeDefined,
     cosim_time_point startTime)
 {
+    COSIMC_API_CALL();
     try {
         auto execution = std::make_unique<cosim_execution>();
 
         auto resolver = cosim::default_model_uri_resolver();
         const auto config = cosim::load_osp_config(configPath, *resolver);
 
+        execution->algorithm = std::make_shared<cosimc::fixed_step_algorithm>(config.step_size);
         execution->cpp_execution = std::make_unique<cosim::execution>(
             startTimeDefined ? to_time_point(startTime) : config.start_time,
-            std::make_shared<cosim::fixed_step_algorithm>(config.step_size));
+            execution->algorithm);
         execution->entity_maps = cosim::inject_system_structure(
             *execution->cpp_execution,
             config.system_structure,
             config.initial_values);
-        execution->real_time_config = execution->cpp_execution->get_real_time_config();
-        execution->real_time_metrics = execution->cpp_execution->get_real_time_metrics();
+        setup_real_time(execution.get());
         execution->error_code = COSIM_ERRC_SUCCESS;
         execution->state = COSIM_EXECUTION_STOPPED;
 
@@ -210,17 +270,28 @@ cosim_execution* cosim_osp_config_execution_create(
     }
 }
 
+// Loads an SSP configuration from a directory, an .ssd file or an .ssp
+// archive.  Archives are unpacked selectively into a temporary directory,
+// which can be removed once the models have been loaded.
+auto load_ssp(const char* sspPath)
+{
+    cosim::ssp_loader loader;
+    if (!cosimc::is_ssp_archive(sspPath)) return loader.load(sspPath);
+    const auto unpackDir = cosim::utility::temp_dir();
+    cosimc::unpack_ssp_archive(sspPath, unpackDir.path());
+    return loader.load(unpackDir.path());
+}
 
 cosim_execution* cosim_ssp_execution_create(
     const char* sspDir,
     bool startTimeDefined,
     cosim_time_point startTime)
 {
+    COSIMC_API_CALL();
     try {
         auto execution = std::make_unique<cosim_execution>();
 
-        cosim::ssp_loader loader;
-        const auto config = loader.load(sspDir);
+        const auto config = load_ssp(sspDir);
 
         execution->cpp_execution = std::make_unique<cosim::execution>(
             startTimeDefined ? to_time_point(startTime) : config.start_time,
@@ -229,8 +300,7 @@ cosim_execution* cosim_ssp_execution_create(
             *execution->cpp_execution,
             config.system_structure,
             config.parameter_sets.at(""));
-        execution->real_time_config = execution->cpp_execution->get_real_time_config();
-        execution->real_time_metrics = execution->cpp_execution->get_real_time_metrics();
+        setup_real_time(execution.get());
         execution->error_code = COSIM_ERRC_SUCCESS;
         execution->state = COSIM_EXECUTION_STOPPED;
 
@@ -247,21 +317,21 @@ cosim_execution* cosim_ssp_fixed_step_execution_create(
     cosim_time_point startTime,
     cosim_duration stepSize)
 {
+    COSIMC_API_CALL();
     try {
         auto execution = std::make_unique<cosim_execution>();
 
-        cosim::ssp_loader loader;
-        const auto config = loader.load(sspDir);
+        const auto config = load_ssp(sspDir);
 
+        execution->algorithm = std::make_shared<cosimc::fixed_step_algorithm>(to_duration(stepSize));
         execution->cpp_execution = std::make_unique<cosim::execution>(
             startTimeDefined ? to_time_point(startTime) : config.start_time,
-            std::make_unique<cosim::fixed_step_algorithm>(to_duration(stepSize)));
+            execution->algorithm);
         execution->entity_maps = cosim::inject_system_structure(
             *execution->cpp_execution,
             config.system_structure,
             config.parameter_sets.at(""));
-        execution->real_time_config = execution->cpp_execution->get_real_time_config();
-        execution->real_time_metrics = execution->cpp_execution->get_real_time_metrics();
+        setup_real_time(execution.get());
         execution->error_code = COSIM_ERRC_SUCCESS;
         execution->state = COSIM_EXECUTION_STOPPED;
 
@@ -272,12 +342,58 @@ cosim_execution* cosim_ssp_fixed_step_execution_create(
     }
 }
 
+// Writes the problems found by a validation to a report buffer, and returns
+// the number of problems.
+int write_validation_report(const std::vector<std::string>& problems, char* report, size_t reportSize)
+{
+    if (report && reportSize > 0) {
+        std::string text;
+        for (const auto& p : problems) {
+            text += p;
+            text += '\n';
+        }
+        safe_strncpy(report, text.c_str(), reportSize);
+    }
+    return static_cast<int>(problems.size());
+}
+
+int cosim_validate_osp_config(const char* configPath, char* report, size_t reportSize)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto resolver = cosim::default_model_uri_resolver();
+        return write_validation_report(cosimc::validate_osp_config(configPath, *resolver), report, reportSize);
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_validate_ssp(const char* sspDir, char* report, size_t reportSize)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto resolver = cosim::default_model_uri_resolver();
+        return write_validation_report(cosimc::validate_ssp(sspDir, *resolver), report, reportSize);
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
 int cosim_execution_destroy(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     try {
         if (!execution) return success;
         const auto owned = std::unique_ptr<cosim_execution>(execution);
         cosim_execution_stop(execution);
+        if (execution->algorithm && execution->algorithm->has_hung_simulator()) {
+            // A slave is still stuck in a time step on one of the algorithm's
+            // worker threads, and destroying the execution would destroy the
+            // slave under its feet.  Leaking it is the lesser evil.
+            static_cast<void>(execution->cpp_execution.release());
+        }
         return success;
     } catch (...) {
         execution->state = COSIM_EXECUTION_ERROR;
@@ -289,11 +405,13 @@ int cosim_execution_destroy(cosim_execution* execution)
 
 size_t cosim_execution_get_num_slaves(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     return execution->entity_maps.simulators.size();
 }
 
 int cosim_execution_get_slave_infos(cosim_execution* execution, cosim_slave_info infos[], size_t numSlaves)
 {
+    COSIMC_API_CALL();
     try {
         auto ids = execution->entity_maps.simulators;
         size_t slave = 0;
@@ -315,6 +433,7 @@ int cosim_execution_get_slave_infos(cosim_execution* execution, cosim_slave_info
 
 int cosim_slave_get_num_variables(cosim_execution* execution, cosim_slave_index slave)
 {
+    COSIMC_API_CALL();
     try {
         return static_cast<int>(execution
                                     ->cpp_execution
@@ -329,6 +448,7 @@ int cosim_slave_get_num_variables(cosim_execution* execution, cosim_slave_index
 
 int cosim_get_num_modified_variables(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     return static_cast<int>(execution->cpp_execution->get_modified_variables().size());
 }
 
@@ -395,6 +515,7 @@ void translate_variable_description(const cosim::variable_description& vd, cosim
 
 int cosim_slave_get_variables(cosim_execution* execution, cosim_slave_index slave, cosim_variable_description variables[], size_t numVariables)
 {
+    COSIMC_API_CALL();
     try {
         const auto vars = execution
                               ->cpp_execution
@@ -421,13 +542,12 @@ struct cosim_slave_s
 
 cosim_slave* cosim_local_slave_create(const char* fmuPath, const char* instanceName)
 {
+    COSIMC_API_CALL();
     try {
-        const auto importer = cosim::fmi::importer::create();
-        const auto fmu = importer->import(fmuPath);
         auto slave = std::make_unique<cosim_slave>();
-        slave->modelName = fmu->model_description()->name;
         slave->instanceName = std::string(instanceName);
-        slave->instance = fmu->instantiate_slave(slave->instanceName);
+        slave->instance = cosimc::instantiate_local_slave(fmuPath, slave->instanceName);
+        slave->modelName = slave->instance->model_description().name;
         // slave address not in use yet. Should be something else than a string.
         slave->address = "local";
         return slave.release();
@@ -439,6 +559,7 @@ cosim_slave* cosim_local_slave_create(const char* fmuPath, const char* instanceN
 
 int cosim_execution_set_real_initial_value(cosim_execution* execution, cosim_slave_index slaveIndex, cosim_value_reference vr, double value)
 {
+    COSIMC_API_CALL();
     try {
         execution->cpp_execution->set_real_initial_value(slaveIndex, vr, value);
     } catch (...) {
@@ -450,6 +571,7 @@ int cosim_execution_set_real_initial_value(cosim_execution* execution, cosim_sla
 
 int cosim_execution_set_integer_initial_value(cosim_execution* execution, cosim_slave_index slaveIndex, cosim_value_reference vr, int value)
 {
+    COSIMC_API_CALL();
     try {
         execution->cpp_execution->set_integer_initial_value(slaveIndex, vr, value);
     } catch (...) {
@@ -461,6 +583,7 @@ int cosim_execution_set_integer_initial_value(cosim_execution* execution, cosim_
 
 int cosim_execution_set_boolean_initial_value(cosim_execution* execution, cosim_slave_index slaveIndex, cosim_value_reference vr, bool value)
 {
+    COSIMC_API_CALL();
     try {
         execution->cpp_execution->set_boolean_initial_value(slaveIndex, vr, value);
     } catch (...) {
@@ -472,6 +595,7 @@ int cosim_execution_set_boolean_initial_value(cosim_execution* execution, cosim_
 
 int cosim_execution_set_string_initial_value(cosim_execution* execution, cosim_slave_index slaveIndex, cosim_value_reference vr, char* value)
 {
+    COSIMC_API_CALL();
     try {
         execution->cpp_execution->set_string_initial_value(slaveIndex, vr, value);
     } catch (...) {
@@ -483,6 +607,7 @@ int cosim_execution_set_string_initial_value(cosim_execution* execution, cosim_s
 
 int cosim_local_slave_destroy(cosim_slave* slave)
 {
+    COSIMC_API_CALL();
     try {
         if (!slave) return success;
         const auto owned = std::unique_ptr<cosim_slave>(slave);
@@ -497,9 +622,192 @@ cosim_slave_index cosim_execution_add_slave(
     cosim_execution* execution,
     cosim_slave* slave)
 {
+    COSIMC_API_CALL();
     try {
-        auto index = execution->cpp_execution->add_slave(slave->instance, slave->instanceName);
+        auto instance = std::make_shared<cosimc::replaceable_slave>(slave->instance);
+        auto index = execution->cpp_execution->add_slave(instance, slave->instanceName);
         execution->entity_maps.simulators[slave->instanceName] = index;
+        execution->replaceable_slaves[index] = std::move(instance);
+        return index;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_replace_slave(
+    cosim_execution* execution,
+    cosim_slave_index index,
+    cosim_slave* newSlave,
+    cosim_slave_state_transfer_fn transfer,
+    void* userData)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto it = execution->replaceable_slaves.find(index);
+        if (it == execution->replaceable_slaves.end()) {
+            throw std::out_of_range(
+                "There is no slave with index " + std::to_string(index) +
+                " which was added with cosim_execution_add_slave()");
+        }
+        auto& slave = *it->second;
+
+        cosimc::replaceable_slave::state_transfer_function transferFunction;
+        if (transfer) {
+            transferFunction = [&](cosim::slave& from, cosim::slave&) {
+                cosim_slave oldSlave;
+                oldSlave.address = "local";
+                oldSlave.modelName = from.model_description().name;
+                for (const auto& [name, i] : execution->entity_maps.simulators) {
+                    if (i == index) oldSlave.instanceName = name;
+                }
+                oldSlave.instance = slave.instance();
+                if (transfer(&oldSlave, newSlave, userData) < 0) {
+                    throw cosimc::error(COSIM_ERRC_UNSPECIFIED, "The state transfer function reported an error");
+                }
+            };
+        }
+        const auto replace = [&](cosim::time_point currentTime) {
+            slave.replace(newSlave->instance, currentTime, transferFunction);
+        };
+        if (execution->algorithm) {
+            // The execution may be stepped from another thread, or be
+            // running in the background.
+            execution->algorithm->between_steps(replace);
+        } else {
+            replace(execution->cpp_execution->current_time());
+        }
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_slave_get_real(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    double values[])
+{
+    COSIMC_API_CALL();
+    try {
+        slave->instance->get_real_variables(gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_slave_set_real(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    const double values[])
+{
+    COSIMC_API_CALL();
+    try {
+        slave->instance->set_real_variables(gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_slave_get_integer(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    int values[])
+{
+    COSIMC_API_CALL();
+    try {
+        slave->instance->get_integer_variables(gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_slave_set_integer(
+    cosim_slave* slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    const int values[])
+{
+    COSIMC_API_CALL();
+    try {
+        slave->instance->set_integer_variables(gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+// Finds a variable from its qualified name, `<slave name>.<variable name>`.
+// Since both slave and variable names may contain periods, more than one
+// variable may match, in which case the name is rejected as ambiguous.
+std::pair<cosim::simulator_index, cosim::variable_description> find_variable(
+    cosim_execution* execution,
+    const std::string& qualifiedName)
+{
+    std::optional<std::pair<cosim::simulator_index, cosim::variable_description>> found;
+    for (const auto& [slaveName, index] : execution->entity_maps.simulators) {
+        if (qualifiedName.size() <= slaveName.size() ||
+            qualifiedName.compare(0, slaveName.size(), slaveName) != 0 ||
+            qualifiedName[slaveName.size()] != '.') {
+            continue;
+        }
+        const auto variableName = qualifiedName.substr(slaveName.size() + 1);
+        for (const auto& v : execution->cpp_execution->get_model_description(index).variables) {
+            if (v.name != variableName) continue;
+            if (found) throw std::invalid_argument("Ambiguous variable name: " + qualifiedName);
+            found.emplace(index, v);
+        }
+    }
+    if (!found) throw std::invalid_argument("Unknown variable: " + qualifiedName);
+    return std::move(*found);
+}
+
+cosim_slave_index cosim_execution_add_expression_slave(
+    cosim_execution* execution,
+    const char* instanceName,
+    const char* const names[],
+    const char* const expressions[],
+    size_t count)
+{
+    COSIMC_API_CALL();
+    try {
+        auto& algorithm = get_fixed_step_algorithm(execution);
+        std::vector<cosimc::expression_slave::output> outputs;
+        for (size_t i = 0; i < count; ++i) {
+            outputs.push_back({names[i], expressions[i]});
+        }
+        // All variables are resolved and checked by the constructor, so the
+        // connections can't fail once the slave has been added.
+        std::unordered_map<std::string, cosim::variable_id> sources;
+        const auto slave = std::make_shared<cosimc::expression_slave>(
+            outputs,
+            [&](const std::string& name) {
+                const auto [sourceIndex, source] = find_variable(execution, name);
+                if (source.causality != cosim::variable_causality::output) {
+                    throw std::invalid_argument("Only output variables can be used in expressions: " + name);
+                }
+                sources.emplace(name, cosim::variable_id{sourceIndex, source.type, source.reference});
+                return source.type;
+            });
+        const auto index = execution->cpp_execution->add_slave(slave, instanceName);
+        for (const auto& input : slave->inputs()) {
+            execution->cpp_execution->connect_variables(
+                sources.at(input.name),
+                cosim::variable_id{index, input.type, input.reference});
+        }
+        execution->entity_maps.simulators[instanceName] = index;
+        algorithm.set_derived(index);
         return index;
     } catch (...) {
         handle_current_exception();
@@ -514,6 +822,7 @@ void cosim_execution_step(cosim_execution* execution)
 
 int cosim_execution_step(cosim_execution* execution, size_t numSteps)
 {
+    COSIMC_API_CALL();
     if (execution->cpp_execution->is_running()) {
         return success;
     } else {
@@ -534,16 +843,20 @@ int cosim_execution_step(cosim_execution* execution, size_t numSteps)
 
 int cosim_execution_simulate_until(cosim_execution* execution, cosim_time_point targetTime)
 {
+    COSIMC_API_CALL();
     if (execution->cpp_execution->is_running()) {
         set_last_error(COSIM_ERRC_ILLEGAL_STATE, "Function 'cosim_execution_simulate_until' may not be called while simulation is running!");
         return failure;
     } else {
         execution->state = COSIM_EXECUTION_RUNNING;
         try {
+            execution->pacer->start_run();
             const bool notStopped = execution->cpp_execution->simulate_until(to_time_point(targetTime));
+            execution->pacer->stop_run();
             execution->state = COSIM_EXECUTION_STOPPED;
             return notStopped;
         } catch (...) {
+            execution->pacer->stop_run();
             handle_current_exception();
             execution->state = COSIM_EXECUTION_ERROR;
             return failure;
@@ -553,11 +866,13 @@ int cosim_execution_simulate_until(cosim_execution* execution, cosim_time_point
 
 int cosim_execution_start(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     if (execution->t.joinable()) {
         return success;
     } else {
         try {
             execution->state = COSIM_EXECUTION_RUNNING;
+            execution->pacer->start_run();
             auto task = std::packaged_task<bool()>([execution]() {
                 return execution->cpp_execution->simulate_until(std::nullopt);
             });
@@ -591,7 +906,9 @@ void execution_async_health_check(cosim_execution* execution)
 
 int cosim_execution_stop(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     try {
+        execution->pacer->stop_run();
         execution->cpp_execution->stop_simulation();
         if (execution->t.joinable()) {
             if (execution->simulate_exception_ptr) {
@@ -614,6 +931,7 @@ int cosim_execution_stop(cosim_execution* execution)
 
 int cosim_execution_get_status(cosim_execution* execution, cosim_execution_status* status)
 {
+    COSIMC_API_CALL();
     try {
         status->error_code = execution->error_code;
         status->state = execution->state;
@@ -621,8 +939,10 @@ int cosim_execution_get_status(cosim_execution* execution, cosim_execution_statu
         status->rolling_average_real_time_factor = execution->real_time_metrics->rolling_average_real_time_factor.load();
         status->total_average_real_time_factor = execution->real_time_metrics->total_average_real_time_factor.load();
         status->real_time_factor_target = execution->real_time_config->real_time_factor_target.load();
-        status->is_real_time_simulation = execution->real_time_config->real_time_simulation.load() ? 1 : 0;
+        status->is_real_time_simulation = execution->pacer->enabled() ? 1 : 0;
         status->steps_to_monitor = execution->real_time_config->steps_to_monitor.load();
+        status->num_degraded_slaves = execution->algorithm ? execution->algorithm->num_degraded_simulators() : 0;
+        status->num_frozen_slaves = execution->algorithm ? execution->algorithm->num_frozen_simulators() : 0;
         execution_async_health_check(execution);
         return success;
     } catch (...) {
@@ -635,10 +955,39 @@ int cosim_execution_get_status(cosim_execution* execution, cosim_execution_statu
     }
 }
 
+int cosim_execution_add_sequential_group(
+    cosim_execution* execution,
+    const cosim_slave_index slaves[],
+    size_t numSlaves)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).add_sequential_group(
+            std::vector<cosim::simulator_index>(slaves, slaves + numSlaves));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_set_step_size(cosim_execution* execution, cosim_duration stepSize)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_base_step_size(to_duration(stepSize));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
 int cosim_execution_enable_real_time_simulation(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     try {
-        execution->real_time_config->real_time_simulation.store(true);
+        execution->pacer->set_enabled(true);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -648,8 +997,9 @@ int cosim_execution_enable_real_time_simulation(cosim_execution* execution)
 
 int cosim_execution_disable_real_time_simulation(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     try {
-        execution->real_time_config->real_time_simulation.store(false);
+        execution->pacer->set_enabled(false);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -659,6 +1009,7 @@ int cosim_execution_disable_real_time_simulation(cosim_execution* execution)
 
 int cosim_execution_set_real_time_factor_target(cosim_execution* execution, double realTimeFactor)
 {
+    COSIMC_API_CALL();
     try {
         execution->real_time_config->real_time_factor_target.store(realTimeFactor);
         return success;
@@ -670,6 +1021,7 @@ int cosim_execution_set_real_time_factor_target(cosim_execution* execution, doub
 
 int cosim_execution_set_steps_to_monitor(cosim_execution* execution, int stepsToMonitor)
 {
+    COSIMC_API_CALL();
     try {
         execution->real_time_config->steps_to_monitor.store(stepsToMonitor);
         return success;
@@ -679,16 +1031,17 @@ int cosim_execution_set_steps_to_monitor(cosim_execution* execution, int stepsTo
     }
 }
 
-struct cosim_observer_s
-{
-    std::shared_ptr<cosim::observer> cpp_observer;
-};
-
-int cosim_observer_destroy(cosim_observer* observer)
+int cosim_execution_set_real_time_clock(cosim_execution* execution, cosim_clock_fn clock, void* userData)
 {
+    COSIMC_API_CALL();
     try {
-        if (!observer) return success;
-        const auto owned = std::unique_ptr<cosim_observer>(observer);
+        if (clock) {
+            execution->pacer->set_clock([clock, userData]() {
+                return std::chrono::nanoseconds(clock(userData));
+            });
+        } else {
+            execution->pacer->set_clock(nullptr);
+        }
         return success;
     } catch (...) {
         handle_current_exception();
@@ -696,18 +1049,37 @@ int cosim_observer_destroy(cosim_observer* observer)
     }
 }
 
-int connect_variables(
+int cosim_execution_set_real_time_catch_up_policy(
     cosim_execution* execution,
-    cosim::simulator_index outputSimulator,
-    cosim::value_reference outputVariable,
-    cosim::simulator_index inputSimulator,
-    cosim::value_reference inputVariable,
-    cosim::variable_type type)
+    cosim_real_time_catch_up_policy policy,
+    int maxSteps,
+    cosim_duration maxLateness)
 {
+    COSIMC_API_CALL();
     try {
-        const auto outputId = cosim::variable_id{outputSimulator, type, outputVariable};
-        const auto inputId = cosim::variable_id{inputSimulator, type, inputVariable};
-        execution->cpp_execution->connect_variables(outputId, inputId);
+        cosimc::real_time_pacer::catch_up_settings settings;
+        switch (policy) {
+            case COSIM_REAL_TIME_CATCH_UP_BURST:
+                settings.policy = cosimc::real_time_pacer::catch_up_policy::burst;
+                break;
+            case COSIM_REAL_TIME_CATCH_UP_REANCHOR:
+                settings.policy = cosimc::real_time_pacer::catch_up_policy::reanchor;
+                break;
+            case COSIM_REAL_TIME_CATCH_UP_SLOW_DOWN:
+                settings.policy = cosimc::real_time_pacer::catch_up_policy::slow_down;
+                if (maxSteps < 1) {
+                    throw std::invalid_argument("The slow-down catch-up policy requires a positive number of steps!");
+                }
+                break;
+            default:
+                throw std::invalid_argument("Invalid catch-up policy!");
+        }
+        if (maxSteps < 0 || maxLateness < 0) {
+            throw std::invalid_argument("Catch-up limits may not be negative!");
+        }
+        settings.maxSteps = maxSteps;
+        settings.maxLateness = std::chrono::nanoseconds(maxLateness);
+        execution->pacer->set_catch_up(settings);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -715,41 +1087,44 @@ int connect_variables(
     }
 }
 
-int cosim_execution_connect_real_variables(
+int cosim_execution_get_real_time_pacing_stats(
     cosim_execution* execution,
-    cosim_slave_index outputSlaveIndex,
-    cosim_value_reference outputValueReference,
-    cosim_slave_index inputSlaveIndex,
-    cosim_value_reference inputValueReference)
+    cosim_real_time_pacing_stats* stats)
 {
-    return connect_variables(execution, outputSlaveIndex, outputValueReference, inputSlaveIndex, inputValueReference,
-        cosim::variable_type::real);
+    COSIMC_API_CALL();
+    try {
+        const auto s = execution->pacer->stats();
+        stats->paced_steps = static_cast<int64_t>(s.pacedSteps);
+        stats->late_steps = static_cast<int64_t>(s.lateSteps);
+        stats->reanchors = static_cast<int64_t>(s.reanchors);
+        stats->last_lateness = s.lastLateness.count();
+        stats->max_lateness = s.maxLateness.count();
+        stats->mean_lateness = s.meanLateness.count();
+        stats->clock_rate = s.clockRate;
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
-int cosim_execution_connect_integer_variables(
-    cosim_execution* execution,
-    cosim_slave_index outputSlaveIndex,
-    cosim_value_reference outputValueReference,
-    cosim_slave_index inputSlaveIndex,
-    cosim_value_reference inputValueReference)
+int cosim_execution_enable_load_shedding(cosim_execution* execution)
 {
-    return connect_variables(execution, outputSlaveIndex, outputValueReference, inputSlaveIndex, inputValueReference,
-        cosim::variable_type::integer);
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_load_shedding(true);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
-int cosim_observer_slave_get_real(
-    cosim_observer* observer,
-    cosim_slave_index slave,
-    const cosim_value_reference variables[],
-    size_t nv,
-    double values[])
+int cosim_execution_disable_load_shedding(cosim_execution* execution)
 {
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
-        }
-        obs->get_real(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        get_fixed_step_algorithm(execution).set_load_shedding(false);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -757,19 +1132,14 @@ int cosim_observer_slave_get_real(
     }
 }
 
-int cosim_observer_slave_get_integer(
-    cosim_observer* observer,
+int cosim_execution_set_slave_degradable(
+    cosim_execution* execution,
     cosim_slave_index slave,
-    const cosim_value_reference variables[],
-    size_t nv,
-    int values[])
+    int maxDecimationFactor)
 {
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
-        }
-        obs->get_integer(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        get_fixed_step_algorithm(execution).set_max_shedding_factor(slave, maxDecimationFactor);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -777,19 +1147,14 @@ int cosim_observer_slave_get_integer(
     }
 }
 
-int cosim_observer_slave_get_boolean(
-    cosim_observer* observer,
+int cosim_execution_get_slave_decimation_factor(
+    cosim_execution* execution,
     cosim_slave_index slave,
-    const cosim_value_reference variables[],
-    size_t nv,
-    bool values[])
+    int* decimationFactor)
 {
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
-        }
-        obs->get_boolean(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        *decimationFactor = get_fixed_step_algorithm(execution).decimation_factor(slave);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -797,28 +1162,11 @@ int cosim_observer_slave_get_boolean(
     }
 }
 
-// This holds string variable values.
-// Must only be used with `cosim_observer_slave_get_string()`.
-thread_local std::vector<std::string> g_stringVariableBuffer;
-
-int cosim_observer_slave_get_string(
-    cosim_observer* observer,
-    cosim_slave_index slave,
-    const cosim_value_reference variables[],
-    size_t nv,
-    const char* values[])
+int cosim_execution_freeze_slave(cosim_execution* execution, cosim_slave_index slave)
 {
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
-        }
-        g_stringVariableBuffer.clear();
-        g_stringVariableBuffer.resize(nv);
-        obs->get_string(slave, gsl::make_span(variables, nv), gsl::span<std::string>(g_stringVariableBuffer));
-        for (size_t i = 0; i < nv; i++) {
-            values[i] = g_stringVariableBuffer.at(i).c_str();
-        }
+        get_fixed_step_algorithm(execution).set_frozen(slave, true);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -826,228 +1174,1173 @@ int cosim_observer_slave_get_string(
     }
 }
 
-int64_t cosim_observer_slave_get_real_samples(
-    cosim_observer* observer,
-    cosim_slave_index slave,
-    cosim_value_reference valueReference,
-    cosim_step_number fromStep,
-    size_t nSamples,
-    double values[],
-    cosim_step_number steps[],
-    cosim_time_point times[])
+int cosim_execution_thaw_slave(cosim_execution* execution, cosim_slave_index slave)
 {
+    COSIMC_API_CALL();
     try {
-        std::vector<cosim::time_point> timePoints(nSamples);
-        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
-        }
-        size_t samplesRead = obs->get_real_samples(slave, valueReference, fromStep,
-            gsl::make_span(values, nSamples),
-            gsl::make_span(steps, nSamples), timePoints);
-        for (size_t i = 0; i < samplesRead; ++i) {
-            times[i] = to_integer_time_point(timePoints[i]);
-        }
-        return samplesRead;
+        get_fixed_step_algorithm(execution).set_frozen(slave, false);
+        return success;
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-int64_t cosim_observer_slave_get_real_synchronized_series(
+int cosim_execution_is_slave_frozen(cosim_execution* execution, cosim_slave_index slave)
+{
+    COSIMC_API_CALL();
+    try {
+        return get_fixed_step_algorithm(execution).is_frozen(slave) ? 1 : 0;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int enable_state_hash(cosim_execution* execution, size_t window)
+{
+    try {
+        if (execution->state_hash_observer) return success;
+        if (execution->cpp_execution->is_running()) {
+            set_last_error(COSIM_ERRC_ILLEGAL_STATE, "State hashing must be enabled before the simulation is started");
+            return failure;
+        }
+        auto observer = std::make_shared<cosimc::state_hash_observer>(window);
+        execution->cpp_execution->add_observer(observer);
+        execution->state_hash_observer = std::move(observer);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_enable_state_hash(cosim_execution* execution)
+{
+    COSIMC_API_CALL();
+    return enable_state_hash(execution, cosimc::state_hash_observer::default_window);
+}
+
+int cosim_execution_enable_state_hash_with_window(cosim_execution* execution, size_t window)
+{
+    COSIMC_API_CALL();
+    return enable_state_hash(execution, window);
+}
+
+int cosim_execution_get_state_hash(
+    cosim_execution* execution,
+    cosim_step_number step,
+    uint64_t* hash)
+{
+    COSIMC_API_CALL();
+    try {
+        if (!execution->state_hash_observer) {
+            set_last_error(COSIM_ERRC_ILLEGAL_STATE, "State hashing has not been enabled for this execution");
+            return failure;
+        }
+        const auto h = execution->state_hash_observer->hash(step);
+        if (!h) {
+            throw std::out_of_range("No state hash available for step " + std::to_string(step));
+        }
+        *hash = *h;
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_set_slave_step_timeout(
+    cosim_execution* execution,
+    cosim_slave_index slave,
+    cosim_duration timeout)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_step_timeout(slave, std::chrono::nanoseconds(timeout));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_get_timed_out_slave(cosim_execution* execution, cosim_slave_index* slave)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto index = get_fixed_step_algorithm(execution).timed_out_simulator();
+        if (!index) return 0;
+        *slave = *index;
+        return 1;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+struct cosim_observer_s
+{
+    std::shared_ptr<cosim::observer> cpp_observer;
+};
+
+int cosim_observer_destroy(cosim_observer* observer)
+{
+    COSIMC_API_CALL();
+    try {
+        if (!observer) return success;
+        const auto owned = std::unique_ptr<cosim_observer>(observer);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int connect_variables(
+    cosim_execution* execution,
+    cosim::simulator_index outputSimulator,
+    cosim::value_reference outputVariable,
+    cosim::simulator_index inputSimulator,
+    cosim::value_reference inputVariable,
+    cosim::variable_type type)
+{
+    try {
+        const auto outputId = cosim::variable_id{outputSimulator, type, outputVariable};
+        const auto inputId = cosim::variable_id{inputSimulator, type, inputVariable};
+        execution->cpp_execution->connect_variables(outputId, inputId);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_connect_real_variables(
+    cosim_execution* execution,
+    cosim_slave_index outputSlaveIndex,
+    cosim_value_reference outputValueReference,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference)
+{
+    COSIMC_API_CALL();
+    return connect_variables(execution, outputSlaveIndex, outputValueReference, inputSlaveIndex, inputValueReference,
+        cosim::variable_type::real);
+}
+
+int cosim_execution_connect_integer_variables(
+    cosim_execution* execution,
+    cosim_slave_index outputSlaveIndex,
+    cosim_value_reference outputValueReference,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference)
+{
+    COSIMC_API_CALL();
+    return connect_variables(execution, outputSlaveIndex, outputValueReference, inputSlaveIndex, inputValueReference,
+        cosim::variable_type::integer);
+}
+
+int cosim_execution_set_real_connection_extrapolation(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    int order)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_extrapolation_order(
+            cosim::variable_id{inputSlaveIndex, cosim::variable_type::real, inputValueReference},
+            order);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_set_default_connection_extrapolation(cosim_execution* execution, int order)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_default_extrapolation_order(order);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_set_real_connection_delay(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    cosim_duration delay)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_delay(
+            cosim::variable_id{inputSlaveIndex, cosim::variable_type::real, inputValueReference},
+            to_duration(delay));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_set_real_connection_filter(
+    cosim_execution* execution,
+    cosim_slave_index inputSlaveIndex,
+    cosim_value_reference inputValueReference,
+    cosim_duration timeConstant)
+{
+    COSIMC_API_CALL();
+    try {
+        get_fixed_step_algorithm(execution).set_filter_time_constant(
+            cosim::variable_id{inputSlaveIndex, cosim::variable_type::real, inputValueReference},
+            to_duration(timeConstant));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_slave_get_real(
     cosim_observer* observer,
-    cosim_slave_index slave1,
-    cosim_value_reference valueReference1,
-    cosim_slave_index slave2,
-    cosim_value_reference valueReference2,
+    cosim_slave_index slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    double values[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
+        }
+        obs->get_real(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_slave_get_integer(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    int values[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
+        }
+        obs->get_integer(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_slave_get_boolean(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    bool values[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
+        }
+        obs->get_boolean(slave, gsl::make_span(variables, nv), gsl::make_span(values, nv));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+// This holds string variable values.
+// Must only be used with `cosim_observer_slave_get_string()`.
+thread_local std::vector<std::string> g_stringVariableBuffer;
+
+int cosim_observer_slave_get_string(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    const cosim_value_reference variables[],
+    size_t nv,
+    const char* values[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::last_value_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a last_value_observer.");
+        }
+        g_stringVariableBuffer.clear();
+        g_stringVariableBuffer.resize(nv);
+        obs->get_string(slave, gsl::make_span(variables, nv), gsl::span<std::string>(g_stringVariableBuffer));
+        for (size_t i = 0; i < nv; i++) {
+            values[i] = g_stringVariableBuffer.at(i).c_str();
+        }
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int64_t cosim_observer_slave_get_real_samples(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
     cosim_step_number fromStep,
     size_t nSamples,
-    double values1[],
-    double values2[])
+    double values[],
+    cosim_step_number steps[],
+    cosim_time_point times[])
+{
+    COSIMC_API_CALL();
+    try {
+        std::vector<cosim::time_point> timePoints(nSamples);
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        size_t samplesRead = obs->get_real_samples(slave, valueReference, fromStep,
+            gsl::make_span(values, nSamples),
+            gsl::make_span(steps, nSamples), timePoints);
+        for (size_t i = 0; i < samplesRead; ++i) {
+            times[i] = to_integer_time_point(timePoints[i]);
+        }
+        return samplesRead;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int64_t cosim_observer_slave_get_real_synchronized_series(
+    cosim_observer* observer,
+    cosim_slave_index slave1,
+    cosim_value_reference valueReference1,
+    cosim_slave_index slave2,
+    cosim_value_reference valueReference2,
+    cosim_step_number fromStep,
+    size_t nSamples,
+    double values1[],
+    double values2[])
+{
+    COSIMC_API_CALL();
+    try {
+        std::vector<cosim::time_point> timePoints(nSamples);
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        size_t samplesRead = obs->get_synchronized_real_series(
+            slave1,
+            valueReference1,
+            slave2,
+            valueReference2,
+            fromStep,
+            gsl::make_span(values1, nSamples),
+            gsl::make_span(values2, nSamples));
+        return samplesRead;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int64_t cosim_observer_slave_get_integer_samples(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
+    cosim_step_number fromStep,
+    size_t nSamples,
+    int values[],
+    cosim_step_number steps[],
+    cosim_time_point times[])
+{
+    COSIMC_API_CALL();
+    try {
+        std::vector<cosim::time_point> timePoints(nSamples);
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        size_t samplesRead = obs->get_integer_samples(slave, valueReference, fromStep,
+            gsl::make_span(values, nSamples),
+            gsl::make_span(steps, nSamples), timePoints);
+        for (size_t i = 0; i < samplesRead; ++i) {
+            times[i] = to_integer_time_point(timePoints[i]);
+        }
+        return samplesRead;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+cosimc::event_type to_event_type(cosim_event_type type)
+{
+    switch (type) {
+        case COSIM_EVENT_UPWARD_CROSSING: return cosimc::event_type::upward_crossing;
+        case COSIM_EVENT_DOWNWARD_CROSSING: return cosimc::event_type::downward_crossing;
+        case COSIM_EVENT_CROSSING: return cosimc::event_type::crossing;
+        case COSIM_EVENT_RISING_EDGE: return cosimc::event_type::rising_edge;
+        case COSIM_EVENT_FALLING_EDGE: return cosimc::event_type::falling_edge;
+        case COSIM_EVENT_LOCAL_MAXIMUM: return cosimc::event_type::local_maximum;
+        case COSIM_EVENT_LOCAL_MINIMUM: return cosimc::event_type::local_minimum;
+    }
+    throw std::invalid_argument("Invalid event type!");
+}
+
+// Searches a series held by a time series observer for events, reading it
+// in chunks with `getSamples`, which has the signature of
+// `time_series_provider::get_real_samples()` minus the first two arguments.
+// Consecutive chunks overlap by the samples needed to test the candidates
+// at the chunk boundary.
+template<typename T, typename GetSamples>
+int64_t find_series_events(
+    GetSamples getSamples,
+    cosim_step_number fromStep,
+    cosim_step_number toStep,
+    cosim_event_type type,
+    double threshold,
+    size_t maxEvents,
+    cosim_step_number steps[],
+    cosim_time_point times[])
+{
+    constexpr std::size_t chunkSize = 4096;
+    const auto eventType = to_event_type(type);
+    const auto lookahead = cosimc::event_lookahead(eventType);
+
+    std::vector<T> values(chunkSize);
+    std::vector<cosim::step_number> chunkSteps(chunkSize);
+    std::vector<cosim::time_point> chunkTimes(chunkSize);
+    std::vector<std::size_t> found;
+    size_t numEvents = 0;
+    auto from = fromStep;
+    while (numEvents < maxEvents) {
+        const auto numRead = getSamples(from,
+            gsl::make_span(values),
+            gsl::make_span(chunkSteps),
+            gsl::make_span(chunkTimes));
+        const auto numInRange = static_cast<std::size_t>(
+            std::upper_bound(chunkSteps.begin(), chunkSteps.begin() + numRead, toStep) - chunkSteps.begin());
+        if (numInRange < 2 + lookahead) break;
+
+        found.clear();
+        cosimc::find_events(values.data(), 1, numInRange - lookahead, eventType, threshold, found, maxEvents - numEvents);
+        for (const auto i : found) {
+            steps[numEvents] = chunkSteps[i];
+            times[numEvents] = to_integer_time_point(chunkTimes[i]);
+            ++numEvents;
+        }
+        if (numRead < chunkSize || numInRange < numRead) break;
+        from = chunkSteps[numInRange - 1 - lookahead];
+    }
+    return static_cast<int64_t>(numEvents);
+}
+
+int64_t cosim_observer_slave_find_real_events(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
+    cosim_step_number fromStep,
+    cosim_step_number toStep,
+    cosim_event_type type,
+    double threshold,
+    size_t maxEvents,
+    cosim_step_number steps[],
+    cosim_time_point times[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        return find_series_events<double>(
+            [&](cosim::step_number from, auto values, auto stepNumbers, auto timePoints) {
+                return obs->get_real_samples(slave, valueReference, from, values, stepNumbers, timePoints);
+            },
+            fromStep, toStep, type, threshold, maxEvents, steps, times);
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int64_t cosim_observer_slave_find_integer_events(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_value_reference valueReference,
+    cosim_step_number fromStep,
+    cosim_step_number toStep,
+    cosim_event_type type,
+    double threshold,
+    size_t maxEvents,
+    cosim_step_number steps[],
+    cosim_time_point times[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        return find_series_events<int>(
+            [&](cosim::step_number from, auto values, auto stepNumbers, auto timePoints) {
+                return obs->get_integer_samples(slave, valueReference, from, values, stepNumbers, timePoints);
+            },
+            fromStep, toStep, type, threshold, maxEvents, steps, times);
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_get_step_numbers_for_duration(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_duration duration,
+    cosim_step_number steps[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        obs->get_step_numbers(slave, to_duration(duration), gsl::make_span(steps, 2));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_get_step_numbers(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_time_point begin,
+    cosim_time_point end,
+    cosim_step_number steps[])
+{
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        obs->get_step_numbers(slave, to_time_point(begin), to_time_point(end),
+            gsl::make_span(steps, 2));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+cosim_observer* cosim_last_value_observer_create()
+{
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    observer->cpp_observer = std::make_shared<cosim::last_value_observer>();
+    return observer.release();
+}
+
+cosim_observer* cosim_file_observer_create(const char* logDir)
+{
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    auto logPath = cosim::filesystem::path(logDir);
+    observer->cpp_observer = std::make_shared<cosim::file_observer>(logPath);
+    return observer.release();
+}
+
+cosim_observer* cosim_file_observer_create_from_cfg(const char* logDir, const char* cfgPath)
+{
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    auto fsLogDir = cosim::filesystem::path(logDir);
+    auto fsCfgPath = cosim::filesystem::path(cfgPath);
+    observer->cpp_observer = std::make_shared<cosim::file_observer>(fsLogDir, fsCfgPath);
+    return observer.release();
+}
+
+cosim_observer* cosim_time_series_observer_create()
+{
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    observer->cpp_observer = std::make_shared<cosim::time_series_observer>();
+    return observer.release();
+}
+
+cosim_observer* cosim_buffered_time_series_observer_create(size_t bufferSize)
+{
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    observer->cpp_observer = std::make_shared<cosim::time_series_observer>(bufferSize);
+    return observer.release();
+}
+
+cosim::variable_type to_cpp_variable_type(cosim_variable_type type)
+{
+    switch (type) {
+        case COSIM_VARIABLE_TYPE_REAL:
+            return cosim::variable_type::real;
+        case COSIM_VARIABLE_TYPE_INTEGER:
+            return cosim::variable_type::integer;
+        case COSIM_VARIABLE_TYPE_BOOLEAN:
+            return cosim::variable_type::boolean;
+        case COSIM_VARIABLE_TYPE_STRING:
+            return cosim::variable_type::string;
+        default:
+            throw std::invalid_argument("Variable type not supported");
+    }
+}
+
+cosim_observer* cosim_comparator_observer_create(
+    const char* referenceDir,
+    double absoluteTolerance,
+    double relativeTolerance)
+{
+    COSIMC_API_CALL();
+    try {
+        auto observer = std::make_unique<cosim_observer>();
+        observer->cpp_observer = std::make_shared<cosimc::comparator_observer>(
+            cosim::filesystem::path(referenceDir),
+            absoluteTolerance,
+            relativeTolerance);
+        return observer.release();
+    } catch (...) {
+        handle_current_exception();
+        return nullptr;
+    }
+}
+
+int cosim_comparator_observer_set_tolerance(
+    cosim_observer* observer,
+    cosim_slave_index slave,
+    cosim_variable_type type,
+    cosim_value_reference reference,
+    double absoluteTolerance,
+    double relativeTolerance)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto comparator = std::dynamic_pointer_cast<cosimc::comparator_observer>(observer->cpp_observer);
+        if (!comparator) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a comparator_observer.");
+        }
+        const auto variableId = cosim::variable_id{slave, to_cpp_variable_type(type), reference};
+        comparator->set_tolerance(variableId, absoluteTolerance, relativeTolerance);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_comparator_observer_get_divergence(
+    cosim_observer* observer,
+    cosim_divergence* divergence)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto comparator = std::dynamic_pointer_cast<cosimc::comparator_observer>(observer->cpp_observer);
+        if (!comparator) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a comparator_observer.");
+        }
+        const auto d = comparator->first_divergence();
+        if (!d) return 0;
+        divergence->variable.slave_index = d->variable.simulator;
+        divergence->variable.type = to_c_variable_type(d->variable.type);
+        divergence->variable.value_reference = d->variable.reference;
+        safe_strncpy(divergence->variable_name, d->variable_name.c_str(), SLAVE_NAME_MAX_SIZE);
+        divergence->step = d->step;
+        divergence->time = to_integer_time_point(d->time);
+        divergence->observed_value = d->observed_value;
+        divergence->reference_value = d->reference_value;
+        return 1;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_start_observing(cosim_observer* observer, cosim_slave_index slave, cosim_variable_type type, cosim_value_reference reference)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto timeSeriesObserver = std::dynamic_pointer_cast<cosim::time_series_observer>(observer->cpp_observer);
+        if (!timeSeriesObserver) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        const auto variableId = cosim::variable_id{slave, to_cpp_variable_type(type), reference};
+        timeSeriesObserver->start_observing(variableId);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_observer_stop_observing(cosim_observer* observer, cosim_slave_index slave, cosim_variable_type type, cosim_value_reference reference)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto timeSeriesObserver = std::dynamic_pointer_cast<cosim::time_series_observer>(observer->cpp_observer);
+        if (!timeSeriesObserver) {
+            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        }
+        const auto variableId = cosim::variable_id{slave, to_cpp_variable_type(type), reference};
+        timeSeriesObserver->stop_observing(variableId);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_execution_add_observer(
+    cosim_execution* execution,
+    cosim_observer* observer)
+{
+    COSIMC_API_CALL();
+    try {
+        execution->cpp_execution->add_observer(observer->cpp_observer);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+struct cosim_manipulator_s
+{
+    std::shared_ptr<cosim::manipulator> cpp_manipulator;
+};
+
+cosim_manipulator* cosim_override_manipulator_create()
+{
+    COSIMC_API_CALL();
+    auto manipulator = std::make_unique<cosim_manipulator>();
+    manipulator->cpp_manipulator = std::make_shared<cosimc::override_manipulator>();
+    return manipulator.release();
+}
+
+cosim_manipulator* cosim_override_manipulator_create_with_capacity(size_t queueCapacity)
+{
+    COSIMC_API_CALL();
+    try {
+        auto manipulator = std::make_unique<cosim_manipulator>();
+        manipulator->cpp_manipulator = std::make_shared<cosimc::override_manipulator>(queueCapacity);
+        return manipulator.release();
+    } catch (...) {
+        handle_current_exception();
+        return nullptr;
+    }
+}
+
+int64_t cosim_manipulator_get_overflow_count(cosim_manipulator* manipulator)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        return static_cast<int64_t>(man->overflow_count());
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+cosim_observer* cosim_latency_observer_create(cosim_manipulator* manipulator)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        auto observer = std::make_unique<cosim_observer>();
+        observer->cpp_observer = std::make_shared<cosimc::latency_observer>(man);
+        return observer.release();
+    } catch (...) {
+        handle_current_exception();
+        return nullptr;
+    }
+}
+
+cosim::variable_id to_cpp_variable_id(const cosim_variable_id& id)
+{
+    return {id.slave_index, to_cpp_variable_type(id.type), id.value_reference};
+}
+
+void to_c_distribution(const cosimc::latency_observer::distribution& d, cosim_latency_distribution* distribution)
+{
+    distribution->min = d.min.count();
+    distribution->mean = d.mean.count();
+    distribution->p50 = d.p50.count();
+    distribution->p90 = d.p90.count();
+    distribution->p99 = d.p99.count();
+    distribution->max = d.max.count();
+}
+
+int cosim_latency_observer_add_pair(
+    cosim_observer* observer,
+    cosim_variable_id input,
+    cosim_variable_id output)
 {
+    COSIMC_API_CALL();
     try {
-        std::vector<cosim::time_point> timePoints(nSamples);
-        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        const auto obs = std::dynamic_pointer_cast<cosimc::latency_observer>(observer->cpp_observer);
         if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+            throw std::invalid_argument("Invalid observer!");
         }
-        size_t samplesRead = obs->get_synchronized_real_series(
-            slave1,
-            valueReference1,
-            slave2,
-            valueReference2,
-            fromStep,
-            gsl::make_span(values1, nSamples),
-            gsl::make_span(values2, nSamples));
-        return samplesRead;
+        return static_cast<int>(obs->add_pair(to_cpp_variable_id(input), to_cpp_variable_id(output)));
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-int64_t cosim_observer_slave_get_integer_samples(
-    cosim_observer* observer,
-    cosim_slave_index slave,
-    cosim_value_reference valueReference,
-    cosim_step_number fromStep,
-    size_t nSamples,
-    int values[],
-    cosim_step_number steps[],
-    cosim_time_point times[])
+int cosim_latency_observer_get_stats(cosim_observer* observer, int pair, cosim_latency_stats* stats)
 {
+    COSIMC_API_CALL();
     try {
-        std::vector<cosim::time_point> timePoints(nSamples);
-        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        const auto obs = std::dynamic_pointer_cast<cosimc::latency_observer>(observer->cpp_observer);
         if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+            throw std::invalid_argument("Invalid observer!");
         }
-        size_t samplesRead = obs->get_integer_samples(slave, valueReference, fromStep,
-            gsl::make_span(values, nSamples),
-            gsl::make_span(steps, nSamples), timePoints);
-        for (size_t i = 0; i < samplesRead; ++i) {
-            times[i] = to_integer_time_point(timePoints[i]);
+        if (pair < 0) {
+            throw std::out_of_range("Invalid latency pair index: " + std::to_string(pair));
         }
-        return samplesRead;
+        const auto s = obs->stats(static_cast<std::size_t>(pair));
+        stats->samples = static_cast<int64_t>(s.samples);
+        stats->unmatched = static_cast<int64_t>(s.unmatched);
+        to_c_distribution(s.queueing, &stats->queueing);
+        to_c_distribution(s.processing, &stats->processing);
+        to_c_distribution(s.total, &stats->total);
+        return success;
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-int cosim_observer_get_step_numbers_for_duration(
-    cosim_observer* observer,
-    cosim_slave_index slave,
-    cosim_duration duration,
-    cosim_step_number steps[])
+cosim_observer* cosim_histogram_observer_create()
 {
+    COSIMC_API_CALL();
+    auto observer = std::make_unique<cosim_observer>();
+    observer->cpp_observer = std::make_shared<cosimc::histogram_observer>();
+    return observer.release();
+}
+
+int cosim_histogram_observer_add_variable(
+    cosim_observer* observer,
+    cosim_variable_id variable,
+    cosim_histogram_bin_scale scale,
+    double min,
+    double max,
+    size_t numBins,
+    bool rainflow)
+{
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
+        const auto obs = std::dynamic_pointer_cast<cosimc::histogram_observer>(observer->cpp_observer);
         if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+            throw std::invalid_argument("Invalid observer!");
         }
-        obs->get_step_numbers(slave, to_duration(duration), gsl::make_span(steps, 2));
-        return success;
+        const auto binScale = scale == COSIM_HISTOGRAM_LOG_BINS
+            ? cosimc::bin_scale::logarithmic
+            : cosimc::bin_scale::linear;
+        return static_cast<int>(obs->add_histogram(to_cpp_variable_id(variable), binScale, min, max, numBins, rainflow));
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-int cosim_observer_get_step_numbers(
+cosimc::histogram_observer::result get_histogram(cosim_observer* observer, int histogram)
+{
+    const auto obs = std::dynamic_pointer_cast<cosimc::histogram_observer>(observer->cpp_observer);
+    if (!obs) {
+        throw std::invalid_argument("Invalid observer!");
+    }
+    if (histogram < 0) {
+        throw std::out_of_range("Invalid histogram index: " + std::to_string(histogram));
+    }
+    return obs->get(static_cast<std::size_t>(histogram));
+}
+
+int64_t cosim_histogram_observer_get_counts(
     cosim_observer* observer,
-    cosim_slave_index slave,
-    cosim_time_point begin,
-    cosim_time_point end,
-    cosim_step_number steps[])
+    int histogram,
+    int64_t counts[],
+    double binEdges[],
+    size_t numBins,
+    cosim_histogram_summary* summary)
 {
+    COSIMC_API_CALL();
     try {
-        const auto obs = std::dynamic_pointer_cast<cosim::time_series_provider>(observer->cpp_observer);
-        if (!obs) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        const auto h = get_histogram(observer, histogram);
+        const auto n = std::min(numBins, h.counts.size());
+        if (counts) {
+            for (size_t i = 0; i < n; ++i) counts[i] = static_cast<int64_t>(h.counts[i]);
         }
-        obs->get_step_numbers(slave, to_time_point(begin), to_time_point(end),
-            gsl::make_span(steps, 2));
-        return success;
+        if (binEdges && numBins > 0) {
+            std::copy(h.binEdges.begin(), h.binEdges.begin() + n + 1, binEdges);
+        }
+        if (summary) {
+            summary->samples = static_cast<int64_t>(h.samples);
+            summary->underflow = static_cast<int64_t>(h.underflow);
+            summary->overflow = static_cast<int64_t>(h.overflow);
+            summary->min = h.min;
+            summary->max = h.max;
+            summary->mean = h.mean;
+        }
+        return static_cast<int64_t>(h.counts.size());
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-cosim_observer* cosim_last_value_observer_create()
+int64_t cosim_histogram_observer_get_rainflow_cycles(
+    cosim_observer* observer,
+    int histogram,
+    double cycles[],
+    size_t numBins,
+    double* rangeBinWidth)
 {
-    auto observer = std::make_unique<cosim_observer>();
-    observer->cpp_observer = std::make_shared<cosim::last_value_observer>();
-    return observer.release();
+    COSIMC_API_CALL();
+    try {
+        const auto h = get_histogram(observer, histogram);
+        if (h.cycles.empty()) {
+            throw std::invalid_argument("Rainflow counting is not enabled for this histogram!");
+        }
+        std::copy(h.cycles.begin(), h.cycles.begin() + std::min(numBins, h.cycles.size()), cycles);
+        if (rangeBinWidth) *rangeBinWidth = h.rangeBinWidth;
+        return static_cast<int64_t>(h.cycles.size());
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
-cosim_observer* cosim_file_observer_create(const char* logDir)
+cosim_observer* cosim_psd_observer_create()
 {
+    COSIMC_API_CALL();
     auto observer = std::make_unique<cosim_observer>();
-    auto logPath = cosim::filesystem::path(logDir);
-    observer->cpp_observer = std::make_shared<cosim::file_observer>(logPath);
+    observer->cpp_observer = std::make_shared<cosimc::psd_observer>();
     return observer.release();
 }
 
-cosim_observer* cosim_file_observer_create_from_cfg(const char* logDir, const char* cfgPath)
+int cosim_psd_observer_add_variable(
+    cosim_observer* observer,
+    cosim_variable_id variable,
+    size_t segmentLength,
+    size_t overlap,
+    cosim_psd_window window)
 {
-    auto observer = std::make_unique<cosim_observer>();
-    auto fsLogDir = cosim::filesystem::path(logDir);
-    auto fsCfgPath = cosim::filesystem::path(cfgPath);
-    observer->cpp_observer = std::make_shared<cosim::file_observer>(fsLogDir, fsCfgPath);
-    return observer.release();
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosimc::psd_observer>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer!");
+        }
+        cosimc::window_function windowFunction;
+        switch (window) {
+            case COSIM_PSD_WINDOW_HANN: windowFunction = cosimc::window_function::hann; break;
+            case COSIM_PSD_WINDOW_HAMMING: windowFunction = cosimc::window_function::hamming; break;
+            case COSIM_PSD_WINDOW_RECTANGULAR: windowFunction = cosimc::window_function::rectangular; break;
+            default: throw std::invalid_argument("Invalid window function!");
+        }
+        return static_cast<int>(obs->add_variable(to_cpp_variable_id(variable), segmentLength, overlap, windowFunction));
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
-cosim_observer* cosim_time_series_observer_create()
+int64_t cosim_psd_observer_get_psd(
+    cosim_observer* observer,
+    int spectrum,
+    double frequencies[],
+    double psd[],
+    size_t numBins,
+    int64_t* numSegments)
 {
-    auto observer = std::make_unique<cosim_observer>();
-    observer->cpp_observer = std::make_shared<cosim::time_series_observer>();
-    return observer.release();
+    COSIMC_API_CALL();
+    try {
+        const auto obs = std::dynamic_pointer_cast<cosimc::psd_observer>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer!");
+        }
+        if (spectrum < 0) {
+            throw std::out_of_range("Invalid spectrum index: " + std::to_string(spectrum));
+        }
+        const auto r = obs->get(static_cast<std::size_t>(spectrum));
+        const auto n = std::min(numBins, r.psd.size());
+        if (frequencies) std::copy(r.frequencies.begin(), r.frequencies.begin() + n, frequencies);
+        if (psd) std::copy(r.psd.begin(), r.psd.begin() + n, psd);
+        if (numSegments) *numSegments = static_cast<int64_t>(r.segments);
+        return static_cast<int64_t>(r.psd.size());
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
-cosim_observer* cosim_buffered_time_series_observer_create(size_t bufferSize)
+cosim_manipulator* cosim_shm_input_manipulator_create(
+    const char* segmentName,
+    const cosim_slave_index slaves[],
+    const cosim_value_reference variables[],
+    size_t count)
 {
-    auto observer = std::make_unique<cosim_observer>();
-    observer->cpp_observer = std::make_shared<cosim::time_series_observer>(bufferSize);
-    return observer.release();
+    COSIMC_API_CALL();
+    try {
+        std::vector<cosimc::shm_input_manipulator::mapping> mappings;
+        for (size_t i = 0; i < count; ++i) {
+            mappings.push_back({slaves[i], variables[i]});
+        }
+        auto manipulator = std::make_unique<cosim_manipulator>();
+        manipulator->cpp_manipulator =
+            std::make_shared<cosimc::shm_input_manipulator>(segmentName, std::move(mappings));
+        return manipulator.release();
+    } catch (...) {
+        handle_current_exception();
+        return nullptr;
+    }
 }
 
-cosim::variable_type to_cpp_variable_type(cosim_variable_type type)
+int64_t cosim_shm_input_manipulator_get_skipped_reads(cosim_manipulator* manipulator)
 {
-    switch (type) {
-        case COSIM_VARIABLE_TYPE_REAL:
-            return cosim::variable_type::real;
-        case COSIM_VARIABLE_TYPE_INTEGER:
-            return cosim::variable_type::integer;
-        case COSIM_VARIABLE_TYPE_BOOLEAN:
-            return cosim::variable_type::boolean;
-        case COSIM_VARIABLE_TYPE_STRING:
-            return cosim::variable_type::string;
-        default:
-            throw std::invalid_argument("Variable type not supported");
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::shm_input_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        return static_cast<int64_t>(man->skipped_reads());
+    } catch (...) {
+        handle_current_exception();
+        return failure;
     }
 }
 
-int cosim_observer_start_observing(cosim_observer* observer, cosim_slave_index slave, cosim_variable_type type, cosim_value_reference reference)
+cosimc::packet_layout to_packet_layout(size_t packetSize, const cosim_packet_field fields[], size_t numFields)
+{
+    cosimc::packet_layout layout;
+    layout.size = packetSize;
+    for (size_t i = 0; i < numFields; ++i) {
+        const auto& f = fields[i];
+        layout.fields.push_back({
+            f.variable.slave_index,
+            to_cpp_variable_type(f.variable.type),
+            f.variable.value_reference,
+            f.offset,
+            static_cast<cosimc::field_encoding>(f.encoding),
+            f.big_endian,
+        });
+    }
+    return layout;
+}
+
+void to_c_stats(const cosimc::udp_bridge_stats& s, cosim_udp_bridge_stats* stats)
+{
+    stats->packets = static_cast<int64_t>(s.packets);
+    stats->dropped_packets = static_cast<int64_t>(s.droppedPackets);
+    stats->errors = static_cast<int64_t>(s.errors);
+}
+
+cosim_observer* cosim_udp_output_observer_create(
+    const char* localAddress,
+    uint16_t localPort,
+    const char* remoteAddress,
+    uint16_t remotePort,
+    size_t packetSize,
+    const cosim_packet_field fields[],
+    size_t numFields)
 {
+    COSIMC_API_CALL();
     try {
-        const auto timeSeriesObserver = std::dynamic_pointer_cast<cosim::time_series_observer>(observer->cpp_observer);
-        if (!timeSeriesObserver) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
-        }
-        const auto variableId = cosim::variable_id{slave, to_cpp_variable_type(type), reference};
-        timeSeriesObserver->start_observing(variableId);
-        return success;
+        auto observer = std::make_unique<cosim_observer>();
+        observer->cpp_observer = std::make_shared<cosimc::udp_output_observer>(
+            localAddress ? localAddress : "",
+            localPort,
+            remoteAddress,
+            remotePort,
+            to_packet_layout(packetSize, fields, numFields));
+        return observer.release();
     } catch (...) {
         handle_current_exception();
-        return failure;
+        return nullptr;
     }
 }
 
-int cosim_observer_stop_observing(cosim_observer* observer, cosim_slave_index slave, cosim_variable_type type, cosim_value_reference reference)
+cosim_manipulator* cosim_udp_input_manipulator_create(
+    const char* localAddress,
+    uint16_t localPort,
+    size_t packetSize,
+    const cosim_packet_field fields[],
+    size_t numFields)
 {
+    COSIMC_API_CALL();
     try {
-        const auto timeSeriesObserver = std::dynamic_pointer_cast<cosim::time_series_observer>(observer->cpp_observer);
-        if (!timeSeriesObserver) {
-            throw std::invalid_argument("Invalid observer! The provided observer must be a time_series_observer.");
+        auto manipulator = std::make_unique<cosim_manipulator>();
+        manipulator->cpp_manipulator = std::make_shared<cosimc::udp_input_manipulator>(
+            localAddress ? localAddress : "",
+            localPort,
+            to_packet_layout(packetSize, fields, numFields));
+        return manipulator.release();
+    } catch (...) {
+        handle_current_exception();
+        return nullptr;
+    }
+}
+
+int cosim_udp_input_manipulator_get_port(cosim_manipulator* manipulator)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::udp_input_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
         }
-        const auto variableId = cosim::variable_id{slave, to_cpp_variable_type(type), reference};
-        timeSeriesObserver->stop_observing(variableId);
-        return success;
+        return man->local_port();
     } catch (...) {
         handle_current_exception();
         return failure;
     }
 }
 
-int cosim_execution_add_observer(
-    cosim_execution* execution,
-    cosim_observer* observer)
+int cosim_udp_output_observer_get_stats(cosim_observer* observer, cosim_udp_bridge_stats* stats)
 {
+    COSIMC_API_CALL();
     try {
-        execution->cpp_execution->add_observer(observer->cpp_observer);
+        const auto obs = std::dynamic_pointer_cast<cosimc::udp_output_observer>(observer->cpp_observer);
+        if (!obs) {
+            throw std::invalid_argument("Invalid observer!");
+        }
+        to_c_stats(obs->stats(), stats);
         return success;
     } catch (...) {
         handle_current_exception();
@@ -1055,20 +2348,25 @@ int cosim_execution_add_observer(
     }
 }
 
-struct cosim_manipulator_s
-{
-    std::shared_ptr<cosim::manipulator> cpp_manipulator;
-};
-
-cosim_manipulator* cosim_override_manipulator_create()
+int cosim_udp_input_manipulator_get_stats(cosim_manipulator* manipulator, cosim_udp_bridge_stats* stats)
 {
-    auto manipulator = std::make_unique<cosim_manipulator>();
-    manipulator->cpp_manipulator = std::make_shared<cosim::override_manipulator>();
-    return manipulator.release();
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::udp_input_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        to_c_stats(man->stats(), stats);
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
 }
 
 int cosim_manipulator_destroy(cosim_manipulator* manipulator)
 {
+    COSIMC_API_CALL();
     try {
         if (!manipulator) return success;
         const auto owned = std::unique_ptr<cosim_manipulator>(manipulator);
@@ -1083,6 +2381,7 @@ int cosim_execution_add_manipulator(
     cosim_execution* execution,
     cosim_manipulator* manipulator)
 {
+    COSIMC_API_CALL();
     try {
         execution->cpp_execution->add_manipulator(manipulator->cpp_manipulator);
         return success;
@@ -1099,8 +2398,9 @@ int cosim_manipulator_slave_set_real(
     size_t nv,
     const double values[])
 {
+    COSIMC_API_CALL();
     try {
-        const auto man = std::dynamic_pointer_cast<cosim::override_manipulator>(manipulator->cpp_manipulator);
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
         if (!man) {
             throw std::invalid_argument("Invalid manipulator!");
         }
@@ -1121,8 +2421,9 @@ int cosim_manipulator_slave_set_integer(
     size_t nv,
     const int values[])
 {
+    COSIMC_API_CALL();
     try {
-        const auto man = std::dynamic_pointer_cast<cosim::override_manipulator>(manipulator->cpp_manipulator);
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
         if (!man) {
             throw std::invalid_argument("Invalid manipulator!");
         }
@@ -1143,8 +2444,9 @@ int cosim_manipulator_slave_set_boolean(
     size_t nv,
     const bool values[])
 {
+    COSIMC_API_CALL();
     try {
-        const auto man = std::dynamic_pointer_cast<cosim::override_manipulator>(manipulator->cpp_manipulator);
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
         if (!man) {
             throw std::invalid_argument("Invalid manipulator!");
         }
@@ -1165,8 +2467,9 @@ int cosim_manipulator_slave_set_string(
     size_t nv,
     const char* values[])
 {
+    COSIMC_API_CALL();
     try {
-        const auto man = std::dynamic_pointer_cast<cosim::override_manipulator>(manipulator->cpp_manipulator);
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
         if (!man) {
             throw std::invalid_argument("Invalid manipulator!");
         }
@@ -1187,8 +2490,9 @@ int cosim_manipulator_slave_reset(
     const cosim_value_reference variables[],
     size_t nv)
 {
+    COSIMC_API_CALL();
     try {
-        const auto man = std::dynamic_pointer_cast<cosim::override_manipulator>(manipulator->cpp_manipulator);
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
         if (!man) {
             throw std::invalid_argument("Invalid manipulator!");
         }
@@ -1203,8 +2507,86 @@ int cosim_manipulator_slave_reset(
     }
 }
 
+int cosim_manipulator_slave_schedule_real(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_value_reference variable,
+    double value,
+    cosim_time_point activationTime,
+    cosim_duration rampDuration,
+    cosim_duration holdDuration)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        man->schedule_real_override(
+            slaveIndex,
+            variable,
+            value,
+            to_time_point(activationTime),
+            to_duration(rampDuration),
+            to_duration(holdDuration));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_manipulator_slave_schedule_integer(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_value_reference variable,
+    int value,
+    cosim_time_point activationTime,
+    cosim_duration holdDuration)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        man->schedule_integer_override(
+            slaveIndex,
+            variable,
+            value,
+            to_time_point(activationTime),
+            to_duration(holdDuration));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
+int cosim_manipulator_slave_schedule_reset(
+    cosim_manipulator* manipulator,
+    cosim_slave_index slaveIndex,
+    cosim_variable_type type,
+    cosim_value_reference variable,
+    cosim_time_point activationTime)
+{
+    COSIMC_API_CALL();
+    try {
+        const auto man = std::dynamic_pointer_cast<cosimc::override_manipulator>(manipulator->cpp_manipulator);
+        if (!man) {
+            throw std::invalid_argument("Invalid manipulator!");
+        }
+        man->schedule_reset(slaveIndex, to_cpp_variable_type(type), variable, to_time_point(activationTime));
+        return success;
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
+
 cosim_manipulator* cosim_scenario_manager_create()
 {
+    COSIMC_API_CALL();
     auto manipulator = std::make_unique<cosim_manipulator>();
     manipulator->cpp_manipulator = std::make_shared<cosim::scenario_manager>();
     return manipulator.release();
@@ -1215,6 +2597,7 @@ int cosim_execution_load_scenario(
     cosim_manipulator* manipulator,
     const char* scenarioFile)
 {
+    COSIMC_API_CALL();
     try {
         auto time = execution->cpp_execution->current_time();
         const auto manager = std::dynamic_pointer_cast<cosim::scenario_manager>(manipulator->cpp_manipulator);
@@ -1231,6 +2614,7 @@ int cosim_execution_load_scenario(
 
 int cosim_scenario_is_running(cosim_manipulator* manipulator)
 {
+    COSIMC_API_CALL();
     try {
         const auto manager = std::dynamic_pointer_cast<cosim::scenario_manager>(manipulator->cpp_manipulator);
         if (!manager) {
@@ -1245,6 +2629,7 @@ int cosim_scenario_is_running(cosim_manipulator* manipulator)
 
 int cosim_scenario_abort(cosim_manipulator* manipulator)
 {
+    COSIMC_API_CALL();
     try {
         const auto manager = std::dynamic_pointer_cast<cosim::scenario_manager>(manipulator->cpp_manipulator);
         if (!manager) {
@@ -1260,6 +2645,7 @@ int cosim_scenario_abort(cosim_manipulator* manipulator)
 
 int cosim_get_modified_variables(cosim_execution* execution, cosim_variable_id ids[], size_t numVariables)
 {
+    COSIMC_API_CALL();
     try {
         auto modified_vars = execution->cpp_execution->get_modified_variables();
         size_t counter = 0;
@@ -1284,6 +2670,7 @@ int cosim_get_modified_variables(cosim_execution* execution, cosim_variable_id i
 
 int cosim_log_setup_simple_console_logging()
 {
+    COSIMC_API_CALL();
     try {
         cosim::log::setup_simple_console_logging();
         return success;
@@ -1296,6 +2683,7 @@ int cosim_log_setup_simple_console_logging()
 
 void cosim_log_set_output_level(cosim_log_severity_level level)
 {
+    COSIMC_API_CALL();
     switch (level) {
         case COSIM_LOG_SEVERITY_TRACE:
             cosim::log::set_global_output_level(cosim::log::trace);
@@ -1319,3 +2707,35 @@ void cosim_log_set_output_level(cosim_log_severity_level level)
             assert(false);
     }
 }
+
+
+void cosim_enable_api_stats()
+{
+    cosimc::g_apiStatsEnabled = true;
+}
+
+void cosim_disable_api_stats()
+{
+    cosimc::g_apiStatsEnabled = false;
+}
+
+void cosim_reset_api_stats()
+{
+    cosimc::reset_api_stats();
+}
+
+int cosim_get_api_stats(cosim_api_call_stats stats[], size_t numStats)
+{
+    try {
+        const auto s = cosimc::get_api_stats();
+        for (size_t i = 0; i < s.size() && i < numStats; ++i) {
+            stats[i].function = s[i].function;
+            stats[i].calls = static_cast<int64_t>(s[i].calls);
+            stats[i].total_time = s[i].time.count();
+        }
+        return static_cast<int>(s.size());
+    } catch (...) {
+        handle_current_exception();
+        return failure;
+    }
+}
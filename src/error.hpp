@@ -0,0 +1,44 @@
+/**
+ *  \file
+ *  \brief Error handling utilities shared by the C API implementation.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_ERROR_HPP
+#define LIBCOSIMC_ERROR_HPP
+
+#include <cosim.h>
+
+#include <stdexcept>
+#include <string>
+
+
+namespace cosimc
+{
+
+/**
+ *  An exception which carries an error code that is unique to the C API.
+ *
+ *  Errors which correspond to `cosim::errc` values should be reported with
+ *  `cosim::error` instead.
+ */
+class error : public std::runtime_error
+{
+public:
+    error(cosim_errc code, const std::string& message)
+        : std::runtime_error(message)
+        , code_(code)
+    { }
+
+    /// Returns the C API error code.
+    cosim_errc code() const noexcept { return code_; }
+
+private:
+    cosim_errc code_;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "event_search.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+
+namespace cosimc
+{
+namespace
+{
+
+constexpr std::size_t blockSize = 64;
+
+// Tests the candidates in [first, last) a block at a time.  `test(v, i)`
+// must be branch-free, so that evaluating a whole block into a mask
+// vectorises.  Blocks are only searched for hits if any were found.
+template<typename T, typename Test>
+void scan(
+    const T* values,
+    std::size_t first,
+    std::size_t last,
+    Test test,
+    std::vector<std::size_t>& found,
+    std::size_t maxFound)
+{
+    std::uint8_t mask[blockSize];
+    for (auto begin = first; begin < last && found.size() < maxFound; begin += blockSize) {
+        const auto n = std::min(blockSize, last - begin);
+        const T* v = values + begin;
+        std::uint8_t any = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            mask[i] = test(v, i);
+            any |= mask[i];
+        }
+        if (!any) continue;
+        for (std::size_t i = 0; i < n && found.size() < maxFound; ++i) {
+            if (mask[i]) found.push_back(begin + i);
+        }
+    }
+}
+
+} // namespace
+
+
+std::size_t event_lookahead(event_type type) noexcept
+{
+    return type == event_type::local_maximum || type == event_type::local_minimum ? 1 : 0;
+}
+
+template<typename T>
+void find_events(
+    const T* values,
+    std::size_t first,
+    std::size_t last,
+    event_type type,
+    double threshold,
+    std::vector<std::size_t>& found,
+    std::size_t maxFound)
+{
+    const auto run = [&](auto test) { scan(values, first, last, test, found, maxFound); };
+    switch (type) {
+        case event_type::upward_crossing:
+            run([threshold](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i - 1] < threshold) & (v[i] >= threshold);
+            });
+            break;
+        case event_type::downward_crossing:
+            run([threshold](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i - 1] >= threshold) & (v[i] < threshold);
+            });
+            break;
+        case event_type::crossing:
+            run([threshold](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i - 1] < threshold) != (v[i] < threshold);
+            });
+            break;
+        case event_type::rising_edge:
+            run([](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i - 1] == T(0)) & (v[i] != T(0));
+            });
+            break;
+        case event_type::falling_edge:
+            run([](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i - 1] != T(0)) & (v[i] == T(0));
+            });
+            break;
+        case event_type::local_maximum:
+            run([](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i] > v[i - 1]) & (v[i] > v[i + 1]);
+            });
+            break;
+        case event_type::local_minimum:
+            run([](const T* v, std::size_t i) -> std::uint8_t {
+                return (v[i] < v[i - 1]) & (v[i] < v[i + 1]);
+            });
+            break;
+    }
+}
+
+template void find_events<double>(
+    const double*, std::size_t, std::size_t, event_type, double, std::vector<std::size_t>&, std::size_t);
+template void find_events<int>(
+    const int*, std::size_t, std::size_t, event_type, double, std::vector<std::size_t>&, std::size_t);
+
+} // namespace cosimc
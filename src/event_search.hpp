@@ -0,0 +1,83 @@
+/**
+ *  \file
+ *  \brief Searching sampled series for events.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_EVENT_SEARCH_HPP
+#define LIBCOSIMC_EVENT_SEARCH_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Kinds of events in a sampled series.
+enum class event_type
+{
+    /// The value goes from below the threshold to at or above it.
+    upward_crossing,
+    /// The value goes from at or above the threshold to below it.
+    downward_crossing,
+    /// Either of the above.
+    crossing,
+    /// The value goes from zero to nonzero.
+    rising_edge,
+    /// The value goes from nonzero to zero.
+    falling_edge,
+    /// The value is strictly greater than both its neighbours.
+    local_maximum,
+    /// The value is strictly smaller than both its neighbours.
+    local_minimum,
+};
+
+/**
+ *  Returns the number of samples after a candidate sample which are needed
+ *  to decide whether an event occurs at it.
+ *
+ *  Every event type also needs the sample before the candidate.
+ */
+std::size_t event_lookahead(event_type type) noexcept;
+
+/**
+ *  Finds the samples at which events occur in a series.
+ *
+ *  The candidates `values[first]` through `values[last - 1]` are tested,
+ *  where `first` must be at least 1 and `last + event_lookahead(type)` at
+ *  most the length of the series.  Candidates are tested in blocks with
+ *  branch-free loops, which the compiler vectorises, so that stretches
+ *  without events are skipped quickly.
+ *
+ *  \param values
+ *      The series.
+ *  \param first
+ *      The first candidate.
+ *  \param last
+ *      One past the last candidate.
+ *  \param type
+ *      The kind of event to search for.
+ *  \param threshold
+ *      The threshold for crossings.  Ignored for other event types.
+ *  \param found
+ *      The indices of the samples at which events occur are appended to
+ *      this, in increasing order, until it holds `maxFound` elements.
+ *  \param maxFound
+ *      The most elements `found` should hold.
+ */
+template<typename T>
+void find_events(
+    const T* values,
+    std::size_t first,
+    std::size_t last,
+    event_type type,
+    double threshold,
+    std::vector<std::size_t>& found,
+    std::size_t maxFound);
+
+} // namespace cosimc
+#endif // header guard
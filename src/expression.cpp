@@ -0,0 +1,466 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "expression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace cosimc
+{
+namespace
+{
+
+using unary_function = double (*)(double);
+using binary_function = double (*)(double, double);
+
+struct named_unary_function
+{
+    const char* name;
+    unary_function fn;
+};
+
+struct named_binary_function
+{
+    const char* name;
+    binary_function fn;
+};
+
+const named_unary_function unaryFunctions[] = {
+    {"abs", [](double x) { return std::abs(x); }},
+    {"sqrt", [](double x) { return std::sqrt(x); }},
+    {"exp", [](double x) { return std::exp(x); }},
+    {"log", [](double x) { return std::log(x); }},
+    {"log10", [](double x) { return std::log10(x); }},
+    {"sin", [](double x) { return std::sin(x); }},
+    {"cos", [](double x) { return std::cos(x); }},
+    {"tan", [](double x) { return std::tan(x); }},
+    {"asin", [](double x) { return std::asin(x); }},
+    {"acos", [](double x) { return std::acos(x); }},
+    {"atan", [](double x) { return std::atan(x); }},
+    {"sinh", [](double x) { return std::sinh(x); }},
+    {"cosh", [](double x) { return std::cosh(x); }},
+    {"tanh", [](double x) { return std::tanh(x); }},
+    {"floor", [](double x) { return std::floor(x); }},
+    {"ceil", [](double x) { return std::ceil(x); }},
+    {"round", [](double x) { return std::round(x); }},
+    {"sign", [](double x) { return x > 0.0 ? 1.0 : (x < 0.0 ? -1.0 : 0.0); }},
+};
+
+const named_binary_function binaryFunctions[] = {
+    {"atan2", [](double y, double x) { return std::atan2(y, x); }},
+    {"pow", [](double x, double y) { return std::pow(x, y); }},
+    {"hypot", [](double x, double y) { return std::hypot(x, y); }},
+    {"min", [](double x, double y) { return std::min(x, y); }},
+    {"max", [](double x, double y) { return std::max(x, y); }},
+};
+
+bool is_name_start(char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_name_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '[' || c == ']';
+}
+
+} // namespace
+
+
+// A recursive-descent parser which emits code as it goes.
+class compiled_expression::parser
+{
+public:
+    parser(std::string_view source, const variable_resolver& resolve, std::vector<instruction>& code)
+        : source_(source)
+        , resolve_(resolve)
+        , code_(code)
+    { }
+
+    void parse()
+    {
+        conditional();
+        skip_space();
+        if (pos_ < source_.size()) fail("unexpected '" + std::string(1, source_[pos_]) + "'");
+    }
+
+private:
+    void conditional()
+    {
+        logical_or();
+        if (accept("?")) {
+            conditional();
+            expect(":");
+            conditional();
+            emit(opcode::select, 3);
+        }
+    }
+
+    void logical_or()
+    {
+        logical_and();
+        while (accept("||")) {
+            logical_and();
+            emit(opcode::logical_or, 2);
+        }
+    }
+
+    void logical_and()
+    {
+        equality();
+        while (accept("&&")) {
+            equality();
+            emit(opcode::logical_and, 2);
+        }
+    }
+
+    void equality()
+    {
+        relational();
+        for (;;) {
+            if (accept("==")) {
+                relational();
+                emit(opcode::equal, 2);
+            } else if (accept("!=")) {
+                relational();
+                emit(opcode::not_equal, 2);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void relational()
+    {
+        additive();
+        for (;;) {
+            if (accept("<=")) {
+                additive();
+                emit(opcode::less_equal, 2);
+            } else if (accept(">=")) {
+                additive();
+                emit(opcode::greater_equal, 2);
+            } else if (accept("<")) {
+                additive();
+                emit(opcode::less, 2);
+            } else if (accept(">")) {
+                additive();
+                emit(opcode::greater, 2);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void additive()
+    {
+        multiplicative();
+        for (;;) {
+            if (accept("+")) {
+                multiplicative();
+                emit(opcode::add, 2);
+            } else if (accept("-")) {
+                multiplicative();
+                emit(opcode::subtract, 2);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void multiplicative()
+    {
+        unary();
+        for (;;) {
+            if (accept("*")) {
+                unary();
+                emit(opcode::multiply, 2);
+            } else if (accept("/")) {
+                unary();
+                emit(opcode::divide, 2);
+            } else if (accept("%")) {
+                unary();
+                emit(opcode::modulo, 2);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void unary()
+    {
+        if (accept("-")) {
+            unary();
+            emit(opcode::negate, 1);
+        } else if (accept("+")) {
+            unary();
+        } else if (accept("!")) {
+            unary();
+            emit(opcode::logical_not, 1);
+        } else {
+            power();
+        }
+    }
+
+    void power()
+    {
+        primary();
+        if (accept("^")) {
+            // Right-associative, and binds tighter than a unary minus on
+            // its left, but not on its right: -2^-2 == -(2^(-2)).
+            unary();
+            emit(opcode::power, 2);
+        }
+    }
+
+    void primary()
+    {
+        skip_space();
+        if (pos_ >= source_.size()) fail("unexpected end of expression");
+        const char c = source_[pos_];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            number();
+        } else if (c == '(') {
+            ++pos_;
+            conditional();
+            expect(")");
+        } else if (c == '{') {
+            const auto end = source_.find('}', pos_);
+            if (end == std::string_view::npos) fail("missing '}'");
+            const auto name = std::string(source_.substr(pos_ + 1, end - pos_ - 1));
+            pos_ = end + 1;
+            variable(name);
+        } else if (is_name_start(c)) {
+            const auto start = pos_;
+            while (pos_ < source_.size() && is_name_char(source_[pos_])) ++pos_;
+            const auto name = std::string(source_.substr(start, pos_ - start));
+            skip_space();
+            if (pos_ < source_.size() && source_[pos_] == '(') {
+                call(name, start);
+            } else if (name == "pi") {
+                code_.push_back({opcode::constant, 0, std::acos(-1.0)});
+            } else if (name == "e") {
+                code_.push_back({opcode::constant, 0, std::exp(1.0)});
+            } else {
+                variable(name);
+            }
+        } else {
+            fail("unexpected '" + std::string(1, c) + "'");
+        }
+    }
+
+    void number()
+    {
+        const auto start = pos_;
+        while (pos_ < source_.size() && (std::isdigit(static_cast<unsigned char>(source_[pos_])) || source_[pos_] == '.')) {
+            ++pos_;
+        }
+        if (pos_ < source_.size() && (source_[pos_] == 'e' || source_[pos_] == 'E')) {
+            auto p = pos_ + 1;
+            if (p < source_.size() && (source_[p] == '+' || source_[p] == '-')) ++p;
+            if (p < source_.size() && std::isdigit(static_cast<unsigned char>(source_[p]))) {
+                pos_ = p;
+                while (pos_ < source_.size() && std::isdigit(static_cast<unsigned char>(source_[pos_]))) ++pos_;
+            }
+        }
+        std::istringstream stream(std::string(source_.substr(start, pos_ - start)));
+        stream.imbue(std::locale::classic());
+        double value = 0.0;
+        stream >> value;
+        if (stream.fail() || stream.peek() != std::char_traits<char>::eof()) {
+            pos_ = start;
+            fail("invalid number");
+        }
+        code_.push_back({opcode::constant, 0, value});
+    }
+
+    void call(const std::string& name, std::size_t namePos)
+    {
+        expect("(");
+        conditional();
+        const auto unaryFn = std::find_if(
+            std::begin(unaryFunctions),
+            std::end(unaryFunctions),
+            [&](const auto& f) { return name == f.name; });
+        if (unaryFn != std::end(unaryFunctions)) {
+            expect(")");
+            code_.push_back({opcode::call1, static_cast<std::size_t>(unaryFn - std::begin(unaryFunctions)), 0.0});
+            fold(1);
+            return;
+        }
+        const auto binaryFn = std::find_if(
+            std::begin(binaryFunctions),
+            std::end(binaryFunctions),
+            [&](const auto& f) { return name == f.name; });
+        if (binaryFn != std::end(binaryFunctions)) {
+            expect(",");
+            conditional();
+            expect(")");
+            code_.push_back({opcode::call2, static_cast<std::size_t>(binaryFn - std::begin(binaryFunctions)), 0.0});
+            fold(2);
+            return;
+        }
+        pos_ = namePos;
+        fail("unknown function '" + name + "'");
+    }
+
+    void variable(const std::string& name)
+    {
+        if (name.empty()) fail("empty variable name");
+        code_.push_back({opcode::variable, resolve_(name), 0.0});
+    }
+
+    void emit(opcode op, std::size_t arity)
+    {
+        code_.push_back({op, 0, 0.0});
+        fold(arity);
+    }
+
+    // Replaces the last instruction with a constant if its operands are
+    // constants, which are then the `arity` instructions before it.
+    void fold(std::size_t arity)
+    {
+        if (code_.size() < arity + 1) return;
+        const auto first = code_.end() - static_cast<std::ptrdiff_t>(arity + 1);
+        if (!std::all_of(first, code_.end() - 1, [](const instruction& i) { return i.op == opcode::constant; })) {
+            return;
+        }
+        double stack[3];
+        const auto value = execute(&*first, code_.data() + code_.size(), nullptr, stack);
+        code_.erase(first, code_.end());
+        code_.push_back({opcode::constant, 0, value});
+    }
+
+    void skip_space()
+    {
+        while (pos_ < source_.size() && std::isspace(static_cast<unsigned char>(source_[pos_]))) ++pos_;
+    }
+
+    bool accept(std::string_view token)
+    {
+        skip_space();
+        if (source_.substr(pos_, token.size()) != token) return false;
+        // Don't mistake the first character of a two-character operator
+        // for a one-character operator.
+        if (token.size() == 1 && pos_ + 1 < source_.size()) {
+            const auto next = source_[pos_ + 1];
+            if ((token == "<" || token == ">" || token == "!") && next == '=') return false;
+        }
+        pos_ += token.size();
+        return true;
+    }
+
+    void expect(std::string_view token)
+    {
+        if (!accept(token)) fail("expected '" + std::string(token) + "'");
+    }
+
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        throw std::invalid_argument(
+            "Error in expression '" + std::string(source_) + "' at position " +
+            std::to_string(pos_ + 1) + ": " + message);
+    }
+
+    std::string_view source_;
+    const variable_resolver& resolve_;
+    std::vector<instruction>& code_;
+    std::size_t pos_ = 0;
+};
+
+
+compiled_expression::compiled_expression(std::string_view source, const variable_resolver& resolve)
+{
+    parser(source, resolve, code_).parse();
+
+    std::size_t depth = 0;
+    for (const auto& i : code_) {
+        switch (i.op) {
+            case opcode::constant:
+            case opcode::variable:
+                ++depth;
+                break;
+            case opcode::negate:
+            case opcode::logical_not:
+            case opcode::call1:
+                break;
+            case opcode::select:
+                depth -= 2;
+                break;
+            default:
+                --depth;
+                break;
+        }
+        stackSize_ = std::max(stackSize_, depth);
+    }
+}
+
+double compiled_expression::evaluate(const double* variables, double* stack) const noexcept
+{
+    return execute(code_.data(), code_.data() + code_.size(), variables, stack);
+}
+
+double compiled_expression::evaluate(const double* variables) const
+{
+    std::vector<double> stack(stackSize_);
+    return evaluate(variables, stack.data());
+}
+
+double compiled_expression::execute(
+    const instruction* begin,
+    const instruction* end,
+    const double* variables,
+    double* stack) noexcept
+{
+    // `sp` is the number of values on the stack.
+    std::size_t sp = 0;
+    for (auto i = begin; i != end; ++i) {
+        switch (i->op) {
+            case opcode::constant: stack[sp++] = i->value; break;
+            case opcode::variable: stack[sp++] = variables[i->index]; break;
+            case opcode::negate: stack[sp - 1] = -stack[sp - 1]; break;
+            case opcode::logical_not: stack[sp - 1] = stack[sp - 1] == 0.0 ? 1.0 : 0.0; break;
+            case opcode::call1: stack[sp - 1] = unaryFunctions[i->index].fn(stack[sp - 1]); break;
+            case opcode::select:
+                sp -= 2;
+                stack[sp - 1] = stack[sp - 1] != 0.0 ? stack[sp] : stack[sp + 1];
+                break;
+            default: {
+                --sp;
+                const auto a = stack[sp - 1];
+                const auto b = stack[sp];
+                auto& r = stack[sp - 1];
+                switch (i->op) {
+                    case opcode::add: r = a + b; break;
+                    case opcode::subtract: r = a - b; break;
+                    case opcode::multiply: r = a * b; break;
+                    case opcode::divide: r = a / b; break;
+                    case opcode::modulo: r = std::fmod(a, b); break;
+                    case opcode::power: r = std::pow(a, b); break;
+                    case opcode::less: r = a < b ? 1.0 : 0.0; break;
+                    case opcode::less_equal: r = a <= b ? 1.0 : 0.0; break;
+                    case opcode::greater: r = a > b ? 1.0 : 0.0; break;
+                    case opcode::greater_equal: r = a >= b ? 1.0 : 0.0; break;
+                    case opcode::equal: r = a == b ? 1.0 : 0.0; break;
+                    case opcode::not_equal: r = a != b ? 1.0 : 0.0; break;
+                    case opcode::logical_and: r = (a != 0.0 && b != 0.0) ? 1.0 : 0.0; break;
+                    case opcode::logical_or: r = (a != 0.0 || b != 0.0) ? 1.0 : 0.0; break;
+                    case opcode::call2: r = binaryFunctions[i->index].fn(a, b); break;
+                    default: break;
+                }
+                break;
+            }
+        }
+    }
+    return stack[0];
+}
+
+} // namespace cosimc
@@ -0,0 +1,127 @@
+/**
+ *  \file
+ *  \brief Arithmetic expressions compiled to bytecode.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_EXPRESSION_HPP
+#define LIBCOSIMC_EXPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A real-valued expression, compiled once to bytecode for a stack machine.
+ *
+ *  The syntax is that of C, with these operators, from lowest to highest
+ *  precedence:
+ *
+ *      ?:   ||   &&   == !=   < <= > >=   + -   * / %   unary - + !   ^
+ *
+ *  `^` is exponentiation and is right-associative.  Comparisons and logical
+ *  operators give 1 for true and 0 for false, and any nonzero value is true.
+ *  Both branches of `?:` and both operands of `&&` and `||` are evaluated.
+ *
+ *  Operands are numbers, the constants `pi` and `e`, calls to the functions
+ *  `abs`, `sqrt`, `exp`, `log`, `log10`, `sin`, `cos`, `tan`, `asin`,
+ *  `acos`, `atan`, `sinh`, `cosh`, `tanh`, `floor`, `ceil`, `round`, `sign`,
+ *  `atan2`, `pow`, `hypot`, `min` and `max`, and variables.  A variable
+ *  name starts with a letter or an underscore, and may contain letters,
+ *  digits, underscores, periods and square brackets.  Names containing any
+ *  other characters can be written in braces, e.g. `{der(x)}`.
+ *
+ *  Subexpressions with constant operands are folded at compile time.
+ */
+class compiled_expression
+{
+public:
+    /**
+     *  A function which is called with the name of each variable in the
+     *  expression, and which returns the index of its value in the array
+     *  passed to `evaluate()`.  It should throw if the name is unknown.
+     */
+    using variable_resolver = std::function<std::size_t(const std::string& name)>;
+
+    /**
+     *  Compiles an expression.
+     *
+     *  \throws std::invalid_argument on syntax errors, with the position of
+     *      the error in the message.
+     */
+    compiled_expression(std::string_view source, const variable_resolver& resolve);
+
+    /// The stack size required by `evaluate()`.
+    std::size_t stack_size() const noexcept { return stackSize_; }
+
+    /**
+     *  Evaluates the expression.
+     *
+     *  \param variables
+     *      The variable values, indexed as returned by the resolver.
+     *  \param stack
+     *      Scratch space of at least `stack_size()` elements.
+     */
+    double evaluate(const double* variables, double* stack) const noexcept;
+
+    /// Convenience overload which allocates its own stack.
+    double evaluate(const double* variables) const;
+
+private:
+    enum class opcode : std::uint8_t
+    {
+        constant,
+        variable,
+        negate,
+        logical_not,
+        add,
+        subtract,
+        multiply,
+        divide,
+        modulo,
+        power,
+        less,
+        less_equal,
+        greater,
+        greater_equal,
+        equal,
+        not_equal,
+        logical_and,
+        logical_or,
+        select,
+        call1,
+        call2,
+    };
+
+    struct instruction
+    {
+        opcode op;
+        // The variable index, or the function for calls.
+        std::size_t index;
+        double value;
+    };
+
+    class parser;
+
+    static double execute(
+        const instruction* begin,
+        const instruction* end,
+        const double* variables,
+        double* stack) noexcept;
+
+    std::vector<instruction> code_;
+    std::size_t stackSize_ = 0;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,246 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "expression_slave.hpp"
+
+#include <cosim/error.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+
+namespace cosimc
+{
+
+expression_slave::expression_slave(const std::vector<output>& outputs, const variable_resolver& resolve)
+{
+    if (outputs.empty()) {
+        throw std::invalid_argument("At least one expression must be given");
+    }
+    const auto numOutputs = static_cast<cosim::value_reference>(outputs.size());
+    std::unordered_map<std::string, std::size_t> inputIndices;
+    const auto resolveInput = [&](const std::string& name) {
+        const auto it = inputIndices.find(name);
+        if (it != inputIndices.end()) return it->second;
+        const auto type = resolve(name);
+        if (type == cosim::variable_type::string || type == cosim::variable_type::enumeration) {
+            throw std::invalid_argument("Only real, integer and boolean variables can be used in expressions: " + name);
+        }
+        const auto index = inputs_.size();
+        inputs_.push_back({name, type, numOutputs + static_cast<cosim::value_reference>(index)});
+        inputIndices.emplace(name, index);
+        return index;
+    };
+
+    modelDescription_.name = "expressions";
+    modelDescription_.description = "Derived signals";
+    std::unordered_set<std::string> names;
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        if (!names.insert(outputs[i].name).second) {
+            throw std::invalid_argument("More than one expression is named '" + outputs[i].name + "'");
+        }
+        expressions_.emplace_back(outputs[i].expression, resolveInput);
+        stack_.resize(std::max(stack_.size(), expressions_.back().stack_size()));
+
+        cosim::variable_description v;
+        v.name = outputs[i].name;
+        v.reference = static_cast<cosim::value_reference>(i);
+        v.type = cosim::variable_type::real;
+        v.causality = cosim::variable_causality::output;
+        v.variability = cosim::variable_variability::continuous;
+        modelDescription_.variables.push_back(std::move(v));
+    }
+    for (const auto& in : inputs_) {
+        if (names.count(in.name)) {
+            throw std::invalid_argument("The name '" + in.name + "' is used both for an expression and for a variable in an expression");
+        }
+        cosim::variable_description v;
+        v.name = in.name;
+        v.reference = in.reference;
+        v.type = in.type;
+        v.causality = cosim::variable_causality::input;
+        v.variability = in.type == cosim::variable_type::real
+            ? cosim::variable_variability::continuous
+            : cosim::variable_variability::discrete;
+        modelDescription_.variables.push_back(std::move(v));
+    }
+    inputValues_.resize(inputs_.size());
+    outputValues_.resize(outputs.size());
+}
+
+cosim::model_description expression_slave::model_description() const
+{
+    return modelDescription_;
+}
+
+void expression_slave::setup(cosim::time_point, std::optional<cosim::time_point>, std::optional<double>) { }
+
+void expression_slave::start_simulation() { }
+
+void expression_slave::end_simulation() { }
+
+cosim::step_result expression_slave::do_step(cosim::time_point, cosim::duration)
+{
+    return cosim::step_result::complete;
+}
+
+void expression_slave::get_real_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<double> values) const
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        if (variables[i] < outputValues_.size()) {
+            if (stale_) evaluate();
+            values[i] = outputValues_[variables[i]];
+        } else {
+            values[i] = inputValues_[input_index(variables[i], cosim::variable_type::real)];
+        }
+    }
+}
+
+void expression_slave::get_integer_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<int> values) const
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        values[i] = static_cast<int>(inputValues_[input_index(variables[i], cosim::variable_type::integer)]);
+    }
+}
+
+void expression_slave::get_boolean_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<bool> values) const
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        values[i] = inputValues_[input_index(variables[i], cosim::variable_type::boolean)] != 0.0;
+    }
+}
+
+void expression_slave::get_string_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<std::string>) const
+{
+    if (!variables.empty()) input_index(variables[0], cosim::variable_type::string);
+}
+
+void expression_slave::set_real_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<const double> values)
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        inputValues_[input_index(variables[i], cosim::variable_type::real)] = values[i];
+    }
+    stale_ = true;
+}
+
+void expression_slave::set_integer_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<const int> values)
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        inputValues_[input_index(variables[i], cosim::variable_type::integer)] = values[i];
+    }
+    stale_ = true;
+}
+
+void expression_slave::set_boolean_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<const bool> values)
+{
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        inputValues_[input_index(variables[i], cosim::variable_type::boolean)] = values[i] ? 1.0 : 0.0;
+    }
+    stale_ = true;
+}
+
+void expression_slave::set_string_variables(
+    gsl::span<const cosim::value_reference> variables,
+    gsl::span<const std::string>)
+{
+    if (!variables.empty()) input_index(variables[0], cosim::variable_type::string);
+}
+
+cosim::state_index expression_slave::save_state()
+{
+    const auto stateIndex = nextState_++;
+    states_.emplace(stateIndex, inputValues_);
+    return stateIndex;
+}
+
+void expression_slave::save_state(cosim::state_index stateIndex)
+{
+    saved_state(stateIndex);
+    states_[stateIndex] = inputValues_;
+}
+
+void expression_slave::restore_state(cosim::state_index stateIndex)
+{
+    inputValues_ = saved_state(stateIndex);
+    stale_ = true;
+}
+
+void expression_slave::release_state(cosim::state_index stateIndex)
+{
+    saved_state(stateIndex);
+    states_.erase(stateIndex);
+}
+
+cosim::serialization::node expression_slave::export_state(cosim::state_index stateIndex) const
+{
+    const auto& values = saved_state(stateIndex);
+    cosim::serialization::node exportedState;
+    exportedState.put("scheme_version", 0);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        exportedState.put("inputs." + std::to_string(i), values[i]);
+    }
+    return exportedState;
+}
+
+cosim::state_index expression_slave::import_state(const cosim::serialization::node& exportedState)
+{
+    if (exportedState.get<int>("scheme_version") != 0) {
+        throw cosim::error(
+            cosim::make_error_code(cosim::errc::bad_file),
+            "The serialisation scheme used in the exported state is not supported");
+    }
+    std::vector<double> values(inputValues_.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = exportedState.get<double>("inputs." + std::to_string(i));
+    }
+    const auto stateIndex = nextState_++;
+    states_.emplace(stateIndex, std::move(values));
+    return stateIndex;
+}
+
+std::size_t expression_slave::input_index(cosim::value_reference reference, cosim::variable_type type) const
+{
+    const auto index = static_cast<std::size_t>(reference) - outputValues_.size();
+    if (reference < outputValues_.size() || index >= inputs_.size() || inputs_[index].type != type) {
+        throw std::out_of_range("Invalid value reference: " + std::to_string(reference));
+    }
+    return index;
+}
+
+void expression_slave::evaluate() const
+{
+    for (std::size_t i = 0; i < expressions_.size(); ++i) {
+        outputValues_[i] = expressions_[i].evaluate(inputValues_.data(), stack_.data());
+    }
+    stale_ = false;
+}
+
+const std::vector<double>& expression_slave::saved_state(cosim::state_index stateIndex) const
+{
+    const auto it = states_.find(stateIndex);
+    if (it == states_.end()) {
+        throw cosim::error(
+            cosim::make_error_code(cosim::errc::unsupported_feature),
+            "Unknown state index");
+    }
+    return it->second;
+}
+
+} // namespace cosimc
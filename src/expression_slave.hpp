@@ -0,0 +1,129 @@
+/**
+ *  \file
+ *  \brief A slave whose outputs are expressions over its inputs.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_EXPRESSION_SLAVE_HPP
+#define LIBCOSIMC_EXPRESSION_SLAVE_HPP
+
+#include "expression.hpp"
+
+#include <cosim/model_description.hpp>
+#include <cosim/serialization.hpp>
+#include <cosim/slave.hpp>
+#include <cosim/time.hpp>
+
+#include <gsl/span>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A slave which computes derived signals.
+ *
+ *  Each output is a real variable whose value is a `compiled_expression`.
+ *  The variables referred to in the expressions become the inputs of the
+ *  slave, one per distinct name, which are meant to be connected to the
+ *  variables of other slaves.  The value references of the outputs are
+ *  0, 1, ..., in the order given, and those of the inputs follow.
+ *
+ *  The outputs are computed from the current input values whenever they are
+ *  read, so they are up to date as soon as the inputs have been set, even
+ *  without a step.  See `fixed_step_algorithm::set_derived()`.
+ */
+class expression_slave : public cosim::slave
+{
+public:
+    /// The definition of an output.
+    struct output
+    {
+        std::string name;
+        std::string expression;
+    };
+
+    /// An input, which is a variable referred to in the expressions.
+    struct input
+    {
+        std::string name;
+        cosim::variable_type type;
+        cosim::value_reference reference;
+    };
+
+    /**
+     *  A function which is called with the name of each distinct variable in
+     *  the expressions, and which returns its type.  It should throw if the
+     *  name is unknown.
+     */
+    using variable_resolver = std::function<cosim::variable_type(const std::string& name)>;
+
+    /**
+     *  Constructor.
+     *
+     *  \throws std::invalid_argument if an expression is invalid, if there
+     *      are no outputs, or if two outputs have the same name.
+     */
+    expression_slave(const std::vector<output>& outputs, const variable_resolver& resolve);
+
+    expression_slave(const expression_slave&) = delete;
+    expression_slave& operator=(const expression_slave&) = delete;
+
+    /// Returns the inputs.
+    const std::vector<input>& inputs() const noexcept { return inputs_; }
+
+    // cosim::slave methods
+    cosim::model_description model_description() const override;
+    void setup(
+        cosim::time_point startTime,
+        std::optional<cosim::time_point> stopTime,
+        std::optional<double> relativeTolerance) override;
+    void start_simulation() override;
+    void end_simulation() override;
+    cosim::step_result do_step(cosim::time_point currentT, cosim::duration deltaT) override;
+    void get_real_variables(gsl::span<const cosim::value_reference> variables, gsl::span<double> values) const override;
+    void get_integer_variables(gsl::span<const cosim::value_reference> variables, gsl::span<int> values) const override;
+    void get_boolean_variables(gsl::span<const cosim::value_reference> variables, gsl::span<bool> values) const override;
+    void get_string_variables(gsl::span<const cosim::value_reference> variables, gsl::span<std::string> values) const override;
+    void set_real_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const double> values) override;
+    void set_integer_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const int> values) override;
+    void set_boolean_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const bool> values) override;
+    void set_string_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const std::string> values) override;
+    cosim::state_index save_state() override;
+    void save_state(cosim::state_index stateIndex) override;
+    void restore_state(cosim::state_index stateIndex) override;
+    void release_state(cosim::state_index stateIndex) override;
+    cosim::serialization::node export_state(cosim::state_index stateIndex) const override;
+    cosim::state_index import_state(const cosim::serialization::node& exportedState) override;
+
+private:
+    // Returns the index in `inputValues_` of an input of the given type.
+    std::size_t input_index(cosim::value_reference reference, cosim::variable_type type) const;
+    void evaluate() const;
+    const std::vector<double>& saved_state(cosim::state_index stateIndex) const;
+
+    cosim::model_description modelDescription_;
+    std::vector<compiled_expression> expressions_;
+    std::vector<input> inputs_;
+    std::vector<double> inputValues_;
+
+    // The outputs are computed lazily, when they are read.
+    mutable std::vector<double> outputValues_;
+    mutable std::vector<double> stack_;
+    mutable bool stale_ = true;
+
+    std::unordered_map<cosim::state_index, std::vector<double>> states_;
+    cosim::state_index nextState_ = 0;
+};
+
+} // namespace cosimc
+#endif // header guard
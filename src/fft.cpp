@@ -0,0 +1,55 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "fft.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+
+namespace cosimc
+{
+
+fft_plan::fft_plan(std::size_t size)
+    : size_(size)
+    , bitReversed_(size)
+    , twiddles_(size / 2)
+{
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("The FFT length must be a power of two, and at least 2");
+    }
+    std::size_t bits = 0;
+    while ((std::size_t(1) << bits) < size) ++bits;
+    for (std::size_t i = 0; i < size; ++i) {
+        std::size_t r = 0;
+        for (std::size_t b = 0; b < bits; ++b) {
+            if (i & (std::size_t(1) << b)) r |= std::size_t(1) << (bits - 1 - b);
+        }
+        bitReversed_[i] = r;
+    }
+    const double pi = std::acos(-1.0);
+    for (std::size_t k = 0; k < size / 2; ++k) {
+        twiddles_[k] = std::polar(1.0, -2.0 * pi * static_cast<double>(k) / static_cast<double>(size));
+    }
+}
+
+void fft_plan::forward(std::complex<double>* data) const noexcept
+{
+    for (std::size_t i = 0; i < size_; ++i) {
+        if (i < bitReversed_[i]) std::swap(data[i], data[bitReversed_[i]]);
+    }
+    for (std::size_t half = 1; half < size_; half *= 2) {
+        const auto stride = size_ / (2 * half);
+        for (std::size_t start = 0; start < size_; start += 2 * half) {
+            for (std::size_t k = 0; k < half; ++k) {
+                const auto t = twiddles_[k * stride] * data[start + k + half];
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+} // namespace cosimc
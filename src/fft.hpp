@@ -0,0 +1,51 @@
+/**
+ *  \file
+ *  \brief A radix-2 fast Fourier transform.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_FFT_HPP
+#define LIBCOSIMC_FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  Precomputed tables for in-place FFTs of a fixed, power-of-two length.
+ *
+ *  This is an iterative Cooley-Tukey transform, which is sufficient for the
+ *  segment lengths used in spectral estimation.  It is not meant to compete
+ *  with dedicated FFT libraries.
+ */
+class fft_plan
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \throws std::invalid_argument if `size` is not a power of two, or is
+     *      less than 2.
+     */
+    explicit fft_plan(std::size_t size);
+
+    std::size_t size() const noexcept { return size_; }
+
+    /// Computes the forward transform of `data`, which must have length `size()`, in place.
+    void forward(std::complex<double>* data) const noexcept;
+
+private:
+    std::size_t size_;
+    std::vector<std::size_t> bitReversed_;
+    std::vector<std::complex<double>> twiddles_;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,799 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "fixed_step_algorithm.hpp"
+
+#include "error.hpp"
+
+#include <cosim/exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace cosimc
+{
+namespace
+{
+
+using steady_clock = std::chrono::steady_clock;
+
+// The time at which a step task started running, or `not_started`.
+using start_time = std::atomic<steady_clock::time_point>;
+constexpr auto not_started = steady_clock::time_point::min();
+
+bool same_io(const cosim::function_io_id& a, const cosim::function_io_id& b)
+{
+    return a.function == b.function &&
+        a.type == b.type &&
+        a.reference.group == b.reference.group &&
+        a.reference.group_instance == b.reference.group_instance &&
+        a.reference.io == b.reference.io &&
+        a.reference.io_instance == b.reference.io_instance;
+}
+
+[[noreturn]] void throw_unsupported_function_io_type()
+{
+    throw cosim::error(
+        cosim::make_error_code(cosim::errc::unsupported_feature),
+        "Only real and integer function variables are supported");
+}
+
+} // namespace
+
+
+fixed_step_algorithm::fixed_step_algorithm(cosim::duration baseStepSize, unsigned int workerThreadCount)
+    : baseStepSize_(baseStepSize)
+    , pool_(workerThreadCount)
+{
+    if (baseStepSize <= cosim::duration::zero()) {
+        throw std::invalid_argument("The base step size must be positive");
+    }
+}
+
+fixed_step_algorithm::~fixed_step_algorithm() noexcept = default;
+
+void fixed_step_algorithm::add_simulator(
+    cosim::simulator_index i,
+    cosim::simulator* s,
+    cosim::duration stepSizeHint)
+{
+    auto& info = simulators_[i];
+    info.sim = s;
+    info.name = s->name();
+    info.stepSizeHint = stepSizeHint;
+    info.decimationFactor = decimation_for(stepSizeHint);
+    info.currentFactor = info.decimationFactor;
+    info.nextStep = stepCounter_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_[i].decimationFactor = info.decimationFactor;
+}
+
+void fixed_step_algorithm::remove_simulator(cosim::simulator_index i)
+{
+    const auto targetsRemoved = [i](const auto& c) { return c.target.simulator == i; };
+    for (auto& s : simulators_) {
+        auto& conns = s.second.outgoingSimConnections;
+        conns.erase(std::remove_if(conns.begin(), conns.end(), targetsRemoved), conns.end());
+    }
+    for (auto& f : functions_) {
+        auto& conns = f.second.outgoingSimConnections;
+        conns.erase(std::remove_if(conns.begin(), conns.end(), targetsRemoved), conns.end());
+    }
+    simulators_.erase(i);
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_.erase(i);
+    for (auto& group : groups_) {
+        group.erase(std::remove(group.begin(), group.end(), i), group.end());
+    }
+}
+
+void fixed_step_algorithm::add_function(cosim::function_index i, cosim::function* f)
+{
+    functions_[i].fun = f;
+}
+
+void fixed_step_algorithm::connect_variables(cosim::variable_id output, cosim::variable_id input)
+{
+    auto& source = simulators_.at(output.simulator);
+    auto& target = simulators_.at(input.simulator);
+    source.sim->expose_for_getting(output.type, output.reference);
+    target.sim->expose_for_setting(input.type, input.reference);
+    source.outgoingSimConnections.push_back({output, input, nullptr});
+    std::lock_guard<std::mutex> lock(mutex_);
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::connect_variables(cosim::variable_id output, cosim::function_io_id input)
+{
+    auto& source = simulators_.at(output.simulator);
+    source.sim->expose_for_getting(output.type, output.reference);
+    source.outgoingFunConnections.push_back({output, input});
+}
+
+void fixed_step_algorithm::connect_variables(cosim::function_io_id output, cosim::variable_id input)
+{
+    auto& target = simulators_.at(input.simulator);
+    target.sim->expose_for_setting(input.type, input.reference);
+    functions_.at(output.function).outgoingSimConnections.push_back({output, input});
+}
+
+void fixed_step_algorithm::disconnect_variable(cosim::variable_id input)
+{
+    const auto targetsInput = [&input](const auto& c) { return c.target == input; };
+    for (auto& s : simulators_) {
+        auto& conns = s.second.outgoingSimConnections;
+        conns.erase(std::remove_if(conns.begin(), conns.end(), targetsInput), conns.end());
+    }
+    for (auto& f : functions_) {
+        auto& conns = f.second.outgoingSimConnections;
+        conns.erase(std::remove_if(conns.begin(), conns.end(), targetsInput), conns.end());
+    }
+}
+
+void fixed_step_algorithm::disconnect_variable(cosim::function_io_id input)
+{
+    const auto targetsInput = [&input](const connection_sf& c) { return same_io(c.target, input); };
+    for (auto& s : simulators_) {
+        auto& conns = s.second.outgoingFunConnections;
+        conns.erase(std::remove_if(conns.begin(), conns.end(), targetsInput), conns.end());
+    }
+}
+
+void fixed_step_algorithm::setup(cosim::time_point startTime, std::optional<cosim::time_point> stopTime)
+{
+    std::lock_guard<std::mutex> stepLock(stepMutex_);
+    startTime_ = startTime;
+    currentTime_ = startTime;
+    for (auto& s : simulators_) {
+        s.second.sim->setup(startTime, stopTime, std::nullopt);
+    }
+}
+
+void fixed_step_algorithm::initialize()
+{
+    std::lock_guard<std::mutex> stepLock(stepMutex_);
+    check_not_hung();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update_connection_processors();
+    }
+    // Iterate as many times as there are simulators, which is enough for
+    // initial values to propagate through any acyclic connection graph.
+    for (std::size_t n = 0; n < simulators_.size(); ++n) {
+        std::vector<std::future<void>> results;
+        for (auto& s : simulators_) {
+            const auto sim = s.second.sim;
+            results.push_back(pool_.submit([sim] { sim->do_iteration(); }));
+        }
+        std::exception_ptr firstError;
+        for (auto& r : results) {
+            try {
+                r.get();
+            } catch (...) {
+                if (!firstError) firstError = std::current_exception();
+            }
+        }
+        if (firstError) std::rethrow_exception(firstError);
+
+        for (auto& s : simulators_) {
+            transfer_variables(s.second.outgoingSimConnections, startTime_);
+            transfer_variables(s.second.outgoingFunConnections);
+        }
+        calculate_functions();
+    }
+}
+
+std::pair<cosim::duration, std::unordered_set<cosim::simulator_index>>
+fixed_step_algorithm::do_step(cosim::time_point currentT)
+{
+    std::lock_guard<std::mutex> stepLock(stepMutex_);
+    check_not_hung();
+    const auto stepStart = steady_clock::now();
+
+    struct pending_step
+    {
+        cosim::simulator_index index;
+        const simulator_info* info;
+        cosim::time_point t;
+        cosim::duration dt;
+        cosim::duration stepSize; // Less than `dt` when catching up after a thaw
+        std::chrono::nanoseconds timeout;
+        std::shared_ptr<start_time> started;
+        std::future<cosim::step_result> result;
+    };
+    // The simulators which are due for a step, arranged in lanes.  Each lane
+    // is stepped sequentially by one worker thread, while the lanes run in
+    // parallel.  Simulators which are not in a sequential group get a lane
+    // of their own.
+    std::vector<std::vector<pending_step>> lanes;
+    std::vector<cosim::simulator_index> derived;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // A new step size can only be applied when no simulator is in the
+        // middle of a step.  Until then, no step may extend past the point
+        // where the last of the ongoing steps ends.
+        std::int64_t alignmentStep = stepCounter_;
+        for (const auto& s : simulators_) {
+            alignmentStep = std::max(alignmentStep, s.second.nextStep);
+        }
+        if (pendingStepSize_ && alignmentStep == stepCounter_) {
+            baseStepSize_ = *pendingStepSize_;
+            pendingStepSize_.reset();
+            for (auto& s : simulators_) {
+                s.second.decimationFactor = decimation_for(s.second.stepSizeHint);
+            }
+        }
+
+        update_connection_processors();
+        shedder_.set_max_level(maxSheddingLevel_);
+        std::map<cosim::simulator_index, pending_step> due;
+        for (auto& [index, info] : simulators_) {
+            if (settings_[index].derived) derived.push_back(index);
+            if (info.nextStep != stepCounter_) continue;
+            // This is where changes to the decimation factor take effect,
+            // as the simulator has completed its previous step.
+            auto& settings = settings_[index];
+            if (settings.frozen) {
+                // Revisit frozen simulators at every base step, so they can
+                // be thawed without delay.
+                if (!info.frozenAt) info.frozenAt = currentT;
+                info.currentFactor = 1;
+                info.nextStep = stepCounter_ + 1;
+                continue;
+            }
+            settings.sheddingFactor = std::min(1 << shedder_.level(), settings.maxSheddingFactor);
+            settings.decimationFactor = info.decimationFactor * settings.sheddingFactor;
+            if (pendingStepSize_) {
+                settings.decimationFactor = static_cast<int>(std::min<std::int64_t>(
+                    settings.decimationFactor,
+                    alignmentStep - stepCounter_));
+            }
+            info.currentFactor = settings.decimationFactor;
+            info.nextStep = stepCounter_ + info.currentFactor;
+            // A thawed simulator catches up on the time it has been frozen,
+            // in steps of its usual size.
+            const auto t = info.frozenAt.value_or(currentT);
+            info.frozenAt.reset();
+            due.emplace(index, pending_step{
+                index,
+                &info,
+                t,
+                (currentT - t) + baseStepSize_ * info.currentFactor,
+                baseStepSize_ * info.currentFactor,
+                settings.stepTimeout,
+                std::make_shared<start_time>(not_started),
+                {}});
+        }
+        for (const auto& group : groups_) {
+            std::vector<pending_step> lane;
+            for (const auto index : group) {
+                const auto it = due.find(index);
+                if (it == due.end()) continue;
+                lane.push_back(std::move(it->second));
+                due.erase(it);
+            }
+            if (!lane.empty()) lanes.push_back(std::move(lane));
+        }
+        for (auto& entry : due) {
+            lanes.emplace_back();
+            lanes.back().push_back(std::move(entry.second));
+        }
+        numDegraded_ = static_cast<int>(std::count_if(
+            settings_.begin(),
+            settings_.end(),
+            [](const auto& entry) { return entry.second.sheddingFactor > 1; }));
+        numFrozen_ = static_cast<int>(std::count_if(
+            simulators_.begin(),
+            simulators_.end(),
+            [](const auto& entry) { return entry.second.frozenAt.has_value(); }));
+    }
+    // A connection to a simulator later in the same lane, along with the
+    // step which that simulator is about to take.
+    struct immediate_connection
+    {
+        connection_ss connection;
+        cosim::time_point targetStepStart;
+        cosim::duration targetStepSize;
+    };
+    struct step_task
+    {
+        cosim::simulator* sim;
+        cosim::time_point t;
+        cosim::duration dt;
+        cosim::duration stepSize;
+        std::shared_ptr<start_time> started;
+        std::promise<cosim::step_result> result;
+        // Connections whose values are transferred as soon as the step is
+        // complete.
+        std::vector<immediate_connection> immediateConnections;
+    };
+    // Lanes with a step timeout get a worker of their own, so that they
+    // never wait in the queue behind a simulator which hangs, and their
+    // timeouts can be counted from the time they are submitted.  The others
+    // share the bounded pool.
+    const auto watched = [](const std::vector<pending_step>& lane) {
+        return std::any_of(lane.begin(), lane.end(), [](const pending_step& p) {
+            return p.timeout > std::chrono::nanoseconds(0);
+        });
+    };
+    const auto numWatched = static_cast<std::size_t>(std::count_if(lanes.begin(), lanes.end(), watched));
+    if (numWatched > 0) {
+        if (!watchdogPool_) {
+            watchdogPool_ = std::make_unique<thread_pool>(static_cast<unsigned int>(numWatched));
+        }
+        watchdogPool_->ensure_size(numWatched);
+    }
+    const auto abandoned = std::make_shared<std::atomic<bool>>(false);
+    std::vector<steady_clock::time_point> submitted;
+    for (auto& lane : lanes) {
+        auto tasks = std::make_shared<std::vector<step_task>>();
+        for (auto p = lane.begin(); p != lane.end(); ++p) {
+            step_task task{p->info->sim, p->t, p->dt, p->stepSize, p->started, {}, {}};
+            for (const auto& c : p->info->outgoingSimConnections) {
+                const auto later = std::find_if(
+                    std::next(p),
+                    lane.end(),
+                    [&c](const pending_step& l) { return l.index == c.target.simulator; });
+                if (later != lane.end()) {
+                    task.immediateConnections.push_back({c, later->t, later->dt});
+                }
+            }
+            p->result = task.result.get_future();
+            tasks->push_back(std::move(task));
+        }
+        submitted.push_back(steady_clock::now());
+        auto& pool = watched(lane) ? *watchdogPool_ : pool_;
+        pool.submit([this, tasks, abandoned] {
+            for (auto& task : *tasks) {
+                if (*abandoned) {
+                    task.result.set_exception(std::make_exception_ptr(
+                        error(COSIM_ERRC_STEP_TIMEOUT, "The step was abandoned after another simulator timed out")));
+                    continue;
+                }
+                task.started->store(steady_clock::now());
+                try {
+                    // Any step shorter than the usual one comes first, so
+                    // the last ones are aligned with the other simulators.
+                    const auto end = task.t + task.dt;
+                    auto result = cosim::step_result::complete;
+                    for (auto t = task.t; t < end && result == cosim::step_result::complete;) {
+                        auto dt = (end - t) % task.stepSize;
+                        if (dt == cosim::duration::zero()) dt = task.stepSize;
+                        result = task.sim->do_step(t, dt);
+                        t += dt;
+                    }
+                    for (const auto& c : task.immediateConnections) {
+                        transfer_variable(c.connection, task.t + task.dt, c.targetStepStart, c.targetStepSize);
+                    }
+                    task.result.set_value(result);
+                } catch (...) {
+                    task.result.set_exception(std::current_exception());
+                }
+            }
+        });
+    }
+
+    const pending_step* timedOut = nullptr;
+    std::ostringstream errMessages;
+    for (std::size_t l = 0; l < lanes.size(); ++l) {
+        for (auto p = lanes[l].begin(); p != lanes[l].end(); ++p) {
+            const bool hasTimeout = p->timeout > std::chrono::nanoseconds(0);
+            const auto started = p->started->load();
+            if (timedOut && (!hasTimeout || started == not_started)) {
+                // The step has failed anyway, so don't wait for something
+                // which may never finish, or never start.
+                break;
+            }
+            if (hasTimeout) {
+                // Later simulators in a lane start as soon as the previous
+                // one, which we have already waited for, is done.
+                const auto queued = (p == lanes[l].begin())
+                    ? submitted[l]
+                    : (started == not_started ? steady_clock::now() : started);
+                if (p->result.wait_until(queued + p->timeout) != std::future_status::ready) {
+                    // The rest of the lane will never be stepped.
+                    if (!timedOut) timedOut = &*p;
+                    *abandoned = true;
+                    break;
+                }
+            }
+            try {
+                if (p->result.get() != cosim::step_result::complete) {
+                    errMessages << p->info->name << ": Step not complete" << std::endl;
+                }
+            } catch (const std::exception& e) {
+                errMessages << p->info->name << ": " << e.what() << std::endl;
+            }
+        }
+    }
+    if (timedOut) {
+        timedOutSimulator_ = timedOut->index;
+        hung_ = true;
+        std::ostringstream msg;
+        msg << "Simulator '" << timedOut->info->name << "' did not complete its step within "
+            << std::chrono::duration<double, std::milli>(timedOut->timeout).count()
+            << " ms and has been abandoned";
+        throw error(COSIM_ERRC_STEP_TIMEOUT, msg.str());
+    }
+    if (!errMessages.str().empty()) {
+        throw cosim::error(
+            cosim::make_error_code(cosim::errc::simulation_error),
+            errMessages.str());
+    }
+
+    ++stepCounter_;
+    std::unordered_set<cosim::simulator_index> finished;
+    for (auto& [index, info] : simulators_) {
+        if (info.nextStep == stepCounter_) {
+            finished.insert(index);
+            if (std::find(derived.begin(), derived.end(), index) != derived.end()) continue;
+            transfer_variables(info.outgoingSimConnections, currentT + baseStepSize_);
+            transfer_variables(info.outgoingFunConnections);
+        }
+    }
+    calculate_functions();
+    // Derived simulators only depend on simulators with lower indices, so
+    // one pass in index order brings chains of them up to date.
+    for (const auto index : derived) {
+        auto& info = simulators_.at(index);
+        info.sim->do_iteration();
+        transfer_variables(info.outgoingSimConnections, currentT + baseStepSize_);
+        transfer_variables(info.outgoingFunConnections);
+    }
+    update_load_shedding(steady_clock::now() - stepStart);
+    currentTime_ = currentT + baseStepSize_;
+    return {baseStepSize_, std::move(finished)};
+}
+
+void fixed_step_algorithm::set_step_timeout(cosim::simulator_index i, std::chrono::nanoseconds timeout)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_.at(i).stepTimeout = std::max(timeout, std::chrono::nanoseconds(0));
+}
+
+std::optional<cosim::simulator_index> fixed_step_algorithm::timed_out_simulator() const noexcept
+{
+    const auto index = timedOutSimulator_.load();
+    if (index < 0) return std::nullopt;
+    return index;
+}
+
+bool fixed_step_algorithm::has_hung_simulator() const noexcept
+{
+    return hung_;
+}
+
+void fixed_step_algorithm::between_steps(const std::function<void(cosim::time_point)>& action)
+{
+    std::lock_guard<std::mutex> stepLock(stepMutex_);
+    check_not_hung();
+    action(currentTime_);
+}
+
+void fixed_step_algorithm::add_sequential_group(std::vector<cosim::simulator_index> group)
+{
+    if (group.empty()) {
+        throw std::invalid_argument("A sequential group must contain at least one simulator");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = group.begin(); it != group.end(); ++it) {
+        if (!settings_.count(*it)) {
+            throw std::out_of_range("Invalid simulator index: " + std::to_string(*it));
+        }
+        const bool grouped = std::find(group.begin(), it, *it) != it ||
+            std::any_of(groups_.begin(), groups_.end(), [&](const auto& g) {
+                return std::find(g.begin(), g.end(), *it) != g.end();
+            });
+        if (grouped) {
+            throw std::invalid_argument(
+                "Simulator " + std::to_string(*it) + " is already in a sequential group");
+        }
+    }
+    groups_.push_back(std::move(group));
+}
+
+void fixed_step_algorithm::set_extrapolation_order(cosim::variable_id input, int order)
+{
+    if (input.type != cosim::variable_type::real) {
+        throw std::invalid_argument("Input extrapolation is only supported for real variables");
+    }
+    connection_options options;
+    options.extrapolation_order = order;
+    validate(options);
+    std::lock_guard<std::mutex> lock(mutex_);
+    inputSettings_[{input.simulator, input.reference}].extrapolationOrder = order;
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::set_default_extrapolation_order(int order)
+{
+    connection_options options;
+    options.extrapolation_order = order;
+    validate(options);
+    std::lock_guard<std::mutex> lock(mutex_);
+    defaultExtrapolationOrder_ = order;
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::set_delay(cosim::variable_id input, cosim::duration delay)
+{
+    if (input.type != cosim::variable_type::real) {
+        throw std::invalid_argument("Connection delays are only supported for real variables");
+    }
+    connection_options options;
+    options.delay = delay;
+    validate(options);
+    std::lock_guard<std::mutex> lock(mutex_);
+    inputSettings_[{input.simulator, input.reference}].delay = delay;
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::set_filter_time_constant(cosim::variable_id input, cosim::duration timeConstant)
+{
+    if (input.type != cosim::variable_type::real) {
+        throw std::invalid_argument("Connection filters are only supported for real variables");
+    }
+    connection_options options;
+    options.filter_time_constant = timeConstant;
+    validate(options);
+    std::lock_guard<std::mutex> lock(mutex_);
+    inputSettings_[{input.simulator, input.reference}].filterTimeConstant = timeConstant;
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::set_base_step_size(cosim::duration stepSize)
+{
+    if (stepSize <= cosim::duration::zero()) {
+        throw std::invalid_argument("The base step size must be positive");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stepSize == baseStepSize_) {
+        pendingStepSize_.reset();
+    } else {
+        pendingStepSize_ = stepSize;
+    }
+}
+
+cosim::duration fixed_step_algorithm::base_step_size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return baseStepSize_;
+}
+
+void fixed_step_algorithm::set_real_time_monitoring(
+    std::shared_ptr<const cosim::real_time_config> config,
+    std::shared_ptr<const cosim::real_time_metrics> metrics,
+    std::shared_ptr<const real_time_pacer> pacer)
+{
+    realTimeConfig_ = std::move(config);
+    realTimeMetrics_ = std::move(metrics);
+    pacer_ = std::move(pacer);
+}
+
+void fixed_step_algorithm::set_load_shedding(bool enable) noexcept
+{
+    loadShedding_ = enable;
+}
+
+void fixed_step_algorithm::set_max_shedding_factor(cosim::simulator_index i, int maxFactor)
+{
+    if (maxFactor < 1) {
+        throw std::invalid_argument("The maximum decimation factor must be at least 1");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_.at(i).maxSheddingFactor = maxFactor;
+    // The level at which all degradable simulators have reached their limit.
+    int maxFactorOverall = 1;
+    for (const auto& entry : settings_) {
+        maxFactorOverall = std::max(maxFactorOverall, entry.second.maxSheddingFactor);
+    }
+    maxSheddingLevel_ = 0;
+    while ((1 << maxSheddingLevel_) < maxFactorOverall) ++maxSheddingLevel_;
+}
+
+int fixed_step_algorithm::decimation_factor(cosim::simulator_index i) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settings_.at(i).decimationFactor;
+}
+
+int fixed_step_algorithm::num_degraded_simulators() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numDegraded_;
+}
+
+void fixed_step_algorithm::set_frozen(cosim::simulator_index i, bool frozen)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_.at(i).frozen = frozen;
+}
+
+bool fixed_step_algorithm::is_frozen(cosim::simulator_index i) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settings_.at(i).frozen;
+}
+
+int fixed_step_algorithm::num_frozen_simulators() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numFrozen_;
+}
+
+void fixed_step_algorithm::set_derived(cosim::simulator_index i)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_.at(i).derived = true;
+    connectionOptionsChanged_ = true;
+}
+
+void fixed_step_algorithm::update_load_shedding(std::chrono::nanoseconds busyTime)
+{
+    if (!realTimeConfig_ || !realTimeMetrics_ || !pacer_) return;
+    if (!loadShedding_ || !pacer_->enabled()) {
+        // Degraded simulators are restored as they complete their steps.
+        shedder_.reset();
+        return;
+    }
+    shedder_.step_complete(
+        busyTime,
+        baseStepSize_,
+        realTimeConfig_->real_time_factor_target,
+        realTimeMetrics_->rolling_average_real_time_factor,
+        realTimeConfig_->steps_to_monitor);
+}
+
+int fixed_step_algorithm::decimation_for(cosim::duration stepSizeHint) const
+{
+    if (stepSizeHint <= cosim::duration::zero()) return 1;
+    return static_cast<int>(std::max(
+        1L,
+        std::lround(static_cast<double>(stepSizeHint.count()) / baseStepSize_.count())));
+}
+
+// Must be called with `mutex_` held.
+void fixed_step_algorithm::update_connection_processors()
+{
+    if (!connectionOptionsChanged_) return;
+    for (auto& s : simulators_) {
+        for (auto& c : s.second.outgoingSimConnections) {
+            if (c.target.type != cosim::variable_type::real) continue;
+            // Derived simulators are refreshed with the values their inputs
+            // have at the end of the step, so those must be passed on as is.
+            if (settings_.at(c.target.simulator).derived) {
+                c.processor.reset();
+                continue;
+            }
+            connection_options options;
+            options.extrapolation_order = defaultExtrapolationOrder_;
+            const auto it = inputSettings_.find({c.target.simulator, c.target.reference});
+            if (it != inputSettings_.end()) {
+                options.extrapolation_order = it->second.extrapolationOrder.value_or(options.extrapolation_order);
+                options.delay = it->second.delay;
+                options.filter_time_constant = it->second.filterTimeConstant;
+            }
+            if (options.is_direct()) {
+                c.processor.reset();
+            } else if (!c.processor || c.processor->options() != options) {
+                c.processor = std::make_shared<connection_processor>(options);
+            }
+        }
+    }
+    connectionOptionsChanged_ = false;
+}
+
+void fixed_step_algorithm::check_not_hung() const
+{
+    if (hung_) {
+        throw error(
+            COSIM_ERRC_STEP_TIMEOUT,
+            "A simulator has previously timed out, and the simulation cannot continue");
+    }
+}
+
+void fixed_step_algorithm::transfer_variables(
+    const std::vector<connection_ss>& connections,
+    std::optional<cosim::time_point> t)
+{
+    for (const auto& c : connections) {
+        // The value is for the target's next step, which may not start
+        // right away if the target is decimated.
+        const auto& targetInfo = simulators_.at(c.target.simulator);
+        const auto stepStart = t
+            ? *t + baseStepSize_ * (targetInfo.nextStep - stepCounter_)
+            : cosim::time_point();
+        transfer_variable(c, t, stepStart, baseStepSize_ * targetInfo.currentFactor);
+    }
+}
+
+// Real values are passed through the connection's processor, if any, when
+// `t`, the time at which the source has the value, is given.
+void fixed_step_algorithm::transfer_variable(
+    const connection_ss& c,
+    std::optional<cosim::time_point> t,
+    cosim::time_point targetStepStart,
+    cosim::duration targetStepSize)
+{
+    const auto source = simulators_.at(c.source.simulator).sim;
+    const auto target = simulators_.at(c.target.simulator).sim;
+    switch (c.source.type) {
+        case cosim::variable_type::real:
+            if (t && c.processor) {
+                target->set_real(
+                    c.target.reference,
+                    c.processor->process(*t, source->get_real(c.source.reference), targetStepStart, targetStepSize));
+            } else {
+                target->set_real(c.target.reference, source->get_real(c.source.reference));
+            }
+            break;
+        case cosim::variable_type::integer:
+            target->set_integer(c.target.reference, source->get_integer(c.source.reference));
+            break;
+        case cosim::variable_type::boolean:
+            target->set_boolean(c.target.reference, source->get_boolean(c.source.reference));
+            break;
+        case cosim::variable_type::string:
+            target->set_string(c.target.reference, source->get_string(c.source.reference));
+            break;
+        default:
+            break;
+    }
+}
+
+void fixed_step_algorithm::transfer_variables(const std::vector<connection_sf>& connections)
+{
+    for (const auto& c : connections) {
+        const auto source = simulators_.at(c.source.simulator).sim;
+        const auto target = functions_.at(c.target.function).fun;
+        switch (c.source.type) {
+            case cosim::variable_type::real:
+                target->set_real(c.target.reference, source->get_real(c.source.reference));
+                break;
+            case cosim::variable_type::integer:
+                target->set_integer(c.target.reference, source->get_integer(c.source.reference));
+                break;
+            default:
+                throw_unsupported_function_io_type();
+        }
+    }
+}
+
+void fixed_step_algorithm::transfer_variables(const std::vector<connection_fs>& connections)
+{
+    for (const auto& c : connections) {
+        const auto source = functions_.at(c.source.function).fun;
+        const auto target = simulators_.at(c.target.simulator).sim;
+        switch (c.source.type) {
+            case cosim::variable_type::real:
+                target->set_real(c.target.reference, source->get_real(c.source.reference));
+                break;
+            case cosim::variable_type::integer:
+                target->set_integer(c.target.reference, source->get_integer(c.source.reference));
+                break;
+            default:
+                throw_unsupported_function_io_type();
+        }
+    }
+}
+
+void fixed_step_algorithm::calculate_functions()
+{
+    for (auto& f : functions_) {
+        f.second.fun->calculate();
+        transfer_variables(f.second.outgoingSimConnections);
+    }
+}
+
+} // namespace cosimc
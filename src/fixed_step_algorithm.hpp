@@ -0,0 +1,363 @@
+/**
+ *  \file
+ *  \brief A fixed-step co-simulation algorithm with step watchdogs.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_FIXED_STEP_ALGORITHM_HPP
+#define LIBCOSIMC_FIXED_STEP_ALGORITHM_HPP
+
+#include "connection_processor.hpp"
+#include "load_shedder.hpp"
+#include "real_time_pacer.hpp"
+#include "thread_pool.hpp"
+
+#include <cosim/algorithm/algorithm.hpp>
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/function/function.hpp>
+#include <cosim/model_description.hpp>
+#include <cosim/time.hpp>
+#include <cosim/timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A fixed-step algorithm which is used by the executions of the C API.
+ *
+ *  This works like `cosim::fixed_step_algorithm`: all simulators are stepped
+ *  in parallel, with an individual step size which is an integer multiple
+ *  (the decimation factor) of the base step size, and variables are
+ *  transferred between them after the step.
+ *
+ *  In addition, each simulator may be given a step timeout.  If a simulator
+ *  has not completed its step within its timeout (in wall-clock time) of the
+ *  step being submitted, the step is abandoned and a `cosimc::error` with
+ *  the code `COSIM_ERRC_STEP_TIMEOUT` is thrown.  After a timeout,
+ *  simulators which have not started their steps are not stepped, and
+ *  simulators without a timeout are not waited for.  The worker thread
+ *  which runs the offending simulator cannot be reclaimed, so after this
+ *  has happened, the algorithm refuses to do any more work, and it must
+ *  never be destroyed, since that would pull the simulator out from under
+ *  the hung thread.  Use `has_hung_simulator()` to check for this.
+ *
+ *  Finally, simulators may be marked as *degradable*.  When load shedding is
+ *  enabled and the simulation runs in real time but can't keep up, the
+ *  decimation factors of degradable simulators are doubled (up to a per-
+ *  simulator limit) until it can, and halved again when there is enough
+ *  headroom.  See `load_shedder` for the details.  A change of decimation
+ *  factor takes effect when a simulator has completed its current step, so
+ *  simulators are never stepped out of sync with the simulation time.
+ *
+ *  Simulators may also be put in *sequential groups*, for Gauss-Seidel
+ *  coupling of tightly coupled simulators.  The simulators in a group are
+ *  stepped one after another, in the specified order, on the same worker
+ *  thread, and outputs are transferred to the inputs of simulators later in
+ *  the group as soon as each step is complete.  Groups still run in
+ *  parallel with each other and with the ungrouped simulators.
+ *
+ *  The values passed through real connections may be processed on the way,
+ *  as specified with `connection_options`, e.g. to extrapolate inputs.
+ *  This is done in the transfer phase after each step, and also for the
+ *  immediate transfers within sequential groups, where the values are
+ *  processed for the step which the target is about to take.
+ *
+ *  Simulators may be *frozen*, so that they are not stepped and their outputs
+ *  keep their last values, which saves time on subsystems that are inactive
+ *  for long periods.  Like a change of decimation factor, freezing takes
+ *  effect when a simulator has completed its current step.  When thawed,
+ *  a simulator catches up with the simulation time in a series of steps of
+ *  its usual size, all of which count towards its step timeout.  Only if
+ *  the base step size was changed while it was frozen is the first of them
+ *  shorter.
+ *
+ *  Simulators may be marked as *derived*, meaning that their outputs are
+ *  functions of their current inputs, like those of an `expression_slave`.
+ *  After the transfer phase of each step, the derived simulators are
+ *  refreshed with `do_iteration()`, in index order, and their outputs are
+ *  transferred, so that derived values are not a step behind the values
+ *  they are derived from.  Connections to derived simulators are never
+ *  processed, so their inputs are the exact values at the end of the step.
+ *
+ *  The base step size may be changed between steps.  Simulators which are
+ *  in the middle of a decimated step complete it first, and until they all
+ *  have, other simulators are given shorter steps if needed so that all of
+ *  them arrive at the same time point, where the new step size takes effect.
+ */
+class fixed_step_algorithm : public cosim::algorithm
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param baseStepSize
+     *      The base step size.
+     *  \param workerThreadCount
+     *      The number of worker threads.  If zero, the number of hardware
+     *      threads is used.  Simulators with a step timeout, and the
+     *      sequential groups they are in, are stepped by separate, dedicated
+     *      threads.
+     */
+    explicit fixed_step_algorithm(cosim::duration baseStepSize, unsigned int workerThreadCount = 0);
+
+    ~fixed_step_algorithm() noexcept override;
+
+    fixed_step_algorithm(const fixed_step_algorithm&) = delete;
+    fixed_step_algorithm& operator=(const fixed_step_algorithm&) = delete;
+
+    // cosim::algorithm methods
+    void add_simulator(cosim::simulator_index i, cosim::simulator* s, cosim::duration stepSizeHint) override;
+    void remove_simulator(cosim::simulator_index i) override;
+    void add_function(cosim::function_index i, cosim::function* f) override;
+    void connect_variables(cosim::variable_id output, cosim::variable_id input) override;
+    void connect_variables(cosim::variable_id output, cosim::function_io_id input) override;
+    void connect_variables(cosim::function_io_id output, cosim::variable_id input) override;
+    void disconnect_variable(cosim::variable_id input) override;
+    void disconnect_variable(cosim::function_io_id input) override;
+    void setup(cosim::time_point startTime, std::optional<cosim::time_point> stopTime) override;
+    void initialize() override;
+    std::pair<cosim::duration, std::unordered_set<cosim::simulator_index>> do_step(cosim::time_point currentT) override;
+
+    /**
+     *  Sets the maximum wall-clock time that a simulator may spend in a
+     *  single call to `do_step()`.
+     *
+     *  May be called at any time, and takes effect from the next step.
+     *  A zero or negative timeout disables the watchdog for the simulator.
+     */
+    void set_step_timeout(cosim::simulator_index i, std::chrono::nanoseconds timeout);
+
+    /**
+     *  Adds a sequential group, which takes effect from the next step.
+     *
+     *  The simulators are stepped in the order given, and a simulator can
+     *  only be a member of one group.
+     */
+    void add_sequential_group(std::vector<cosim::simulator_index> group);
+
+    /**
+     *  Sets the order of the input extrapolation for the real connection to
+     *  `input`, which takes effect from the next step.
+     *
+     *  The setting is retained if the input is disconnected and reconnected.
+     */
+    void set_extrapolation_order(cosim::variable_id input, int order);
+
+    /**
+     *  Sets the order of the input extrapolation for all real connections
+     *  which have not been given one with `set_extrapolation_order()`.
+     */
+    void set_default_extrapolation_order(int order);
+
+    /**
+     *  Sets a transport delay on the real connection to `input`, which takes
+     *  effect from the next step.  A zero delay removes it.
+     *
+     *  The setting is retained if the input is disconnected and reconnected.
+     */
+    void set_delay(cosim::variable_id input, cosim::duration delay);
+
+    /**
+     *  Sets the time constant of a first-order low-pass filter on the real
+     *  connection to `input`, which takes effect from the next step.  A zero
+     *  time constant removes the filter.
+     *
+     *  The setting is retained if the input is disconnected and reconnected.
+     */
+    void set_filter_time_constant(cosim::variable_id input, cosim::duration timeConstant);
+
+    /**
+     *  Changes the base step size.
+     *
+     *  May be called at any time.  The change takes effect as soon as all
+     *  simulators have completed their current steps.
+     */
+    void set_base_step_size(cosim::duration stepSize);
+
+    /// Returns the base step size which is currently used.
+    cosim::duration base_step_size() const;
+
+    /// Returns the index of the simulator which timed out, if any.
+    std::optional<cosim::simulator_index> timed_out_simulator() const noexcept;
+
+    /// Returns whether a simulator has timed out and is still stuck in a step.
+    bool has_hung_simulator() const noexcept;
+
+    /**
+     *  Calls `action` with the current simulation time while no step is in
+     *  progress, first waiting for an ongoing step to complete.
+     *
+     *  This is for changes which can't be deferred to the next step, like
+     *  replacing a simulator's slave.  `action` must not step the algorithm.
+     */
+    void between_steps(const std::function<void(cosim::time_point)>& action);
+
+    /**
+     *  Gives the algorithm access to the real-time settings and measurements
+     *  of the execution, which are needed for load shedding, and to the
+     *  pacer, which tells whether the execution runs in real time.
+     */
+    void set_real_time_monitoring(
+        std::shared_ptr<const cosim::real_time_config> config,
+        std::shared_ptr<const cosim::real_time_metrics> metrics,
+        std::shared_ptr<const real_time_pacer> pacer);
+
+    /// Enables or disables load shedding.
+    void set_load_shedding(bool enable) noexcept;
+
+    /**
+     *  Specifies how much a simulator's decimation factor may be multiplied
+     *  by load shedding.  1 means that the simulator is not degradable.
+     */
+    void set_max_shedding_factor(cosim::simulator_index i, int maxFactor);
+
+    /// Returns the decimation factor currently used for a simulator.
+    int decimation_factor(cosim::simulator_index i) const;
+
+    /// Returns the number of simulators which currently have been degraded.
+    int num_degraded_simulators() const;
+
+    /// Freezes or thaws a simulator, which takes effect from its next step.
+    void set_frozen(cosim::simulator_index i, bool frozen);
+
+    /// Returns whether a simulator has been frozen with `set_frozen()`.
+    bool is_frozen(cosim::simulator_index i) const;
+
+    /// Returns the number of simulators which currently are frozen.
+    int num_frozen_simulators() const;
+
+    /**
+     *  Marks a simulator as derived, which takes effect from the next step.
+     *  The simulator must be stepped with a decimation factor of 1.
+     */
+    void set_derived(cosim::simulator_index i);
+
+private:
+    struct connection_ss
+    {
+        cosim::variable_id source;
+        cosim::variable_id target;
+        std::shared_ptr<connection_processor> processor;
+    };
+
+    struct connection_sf
+    {
+        cosim::variable_id source;
+        cosim::function_io_id target;
+    };
+
+    struct connection_fs
+    {
+        cosim::function_io_id source;
+        cosim::variable_id target;
+    };
+
+    struct simulator_info
+    {
+        cosim::simulator* sim = nullptr;
+        std::string name;
+        cosim::duration stepSizeHint{0};
+        int decimationFactor = 1; // Before load shedding
+        int currentFactor = 1;
+        std::int64_t nextStep = 0;
+        std::optional<cosim::time_point> frozenAt; // The simulator's own time, while frozen
+        std::vector<connection_ss> outgoingSimConnections;
+        std::vector<connection_sf> outgoingFunConnections;
+    };
+
+    struct function_info
+    {
+        cosim::function* fun = nullptr;
+        std::vector<connection_fs> outgoingSimConnections;
+    };
+
+    // Connection settings, per input variable.
+    struct input_settings
+    {
+        std::optional<int> extrapolationOrder;
+        cosim::duration delay{0};
+        cosim::duration filterTimeConstant{0};
+    };
+
+    struct simulator_settings
+    {
+        std::chrono::nanoseconds stepTimeout{0};
+        int maxSheddingFactor = 1;
+        int sheddingFactor = 1;
+        int decimationFactor = 1;
+        bool frozen = false;
+        bool derived = false;
+    };
+
+    int decimation_for(cosim::duration stepSizeHint) const;
+    void check_not_hung() const;
+    void update_connection_processors();
+    void update_load_shedding(std::chrono::nanoseconds busyTime);
+    void transfer_variables(
+        const std::vector<connection_ss>& connections,
+        std::optional<cosim::time_point> t = std::nullopt);
+    void transfer_variable(
+        const connection_ss& connection,
+        std::optional<cosim::time_point> t,
+        cosim::time_point targetStepStart,
+        cosim::duration targetStepSize);
+    void transfer_variables(const std::vector<connection_sf>& connections);
+    void transfer_variables(const std::vector<connection_fs>& connections);
+    void calculate_functions();
+
+    cosim::duration baseStepSize_; // Only changed with `mutex_` held
+    cosim::time_point startTime_;
+
+    // Held while the simulators are being initialised or stepped.
+    std::mutex stepMutex_;
+    cosim::time_point currentTime_; // Only accessed with `stepMutex_` held
+    std::map<cosim::simulator_index, simulator_info> simulators_;
+    std::map<cosim::function_index, function_info> functions_;
+    std::int64_t stepCounter_ = 0;
+
+    // Settings which may be changed from other threads while stepping.
+    mutable std::mutex mutex_;
+    std::unordered_map<cosim::simulator_index, simulator_settings> settings_;
+    std::optional<cosim::duration> pendingStepSize_;
+    std::vector<std::vector<cosim::simulator_index>> groups_;
+    std::map<std::pair<cosim::simulator_index, cosim::value_reference>, input_settings> inputSettings_;
+    int defaultExtrapolationOrder_ = 0;
+    bool connectionOptionsChanged_ = false;
+    int maxSheddingLevel_ = 0;
+    int numDegraded_ = 0;
+    int numFrozen_ = 0;
+
+    std::atomic<cosim::simulator_index> timedOutSimulator_{-1};
+    std::atomic<bool> hung_{false};
+    std::shared_ptr<const cosim::real_time_config> realTimeConfig_;
+    std::shared_ptr<const cosim::real_time_metrics> realTimeMetrics_;
+    std::shared_ptr<const real_time_pacer> pacer_;
+    std::atomic<bool> loadShedding_{false};
+    load_shedder shedder_;
+    thread_pool pool_;
+    // Has one worker for each simulator, or sequential group, with a step
+    // timeout, so that those never wait in the queue behind others.
+    // Created at the first step where a timeout is in effect.
+    std::unique_ptr<thread_pool> watchdogPool_;
+};
+
+} // namespace cosimc
+#endif // header guard
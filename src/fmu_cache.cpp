@@ -0,0 +1,169 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "fmu_cache.hpp"
+
+#include "parallel_unzip.hpp"
+
+#include <cosim/fmi/importer.hpp>
+#include <cosim/utility/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// The names of the binary directories which can hold code for this
+// platform, in FMI 1.0/2.0 and FMI 3.0 style.
+#if defined(_WIN64)
+const char* const platformDirs[] = {"win64", "x86_64-windows"};
+#elif defined(_WIN32)
+const char* const platformDirs[] = {"win32", "x86-windows"};
+#elif defined(__APPLE__) && defined(__aarch64__)
+const char* const platformDirs[] = {"darwin64", "aarch64-darwin"};
+#elif defined(__APPLE__)
+const char* const platformDirs[] = {"darwin64", "x86_64-darwin"};
+#elif defined(__linux__) && defined(__aarch64__)
+const char* const platformDirs[] = {"linux64", "aarch64-linux"};
+#elif defined(__linux__) && defined(__x86_64__)
+const char* const platformDirs[] = {"linux64", "x86_64-linux"};
+#elif defined(__linux__) && defined(__i386__)
+const char* const platformDirs[] = {"linux32", "x86-linux"};
+#else
+#    define LIBCOSIMC_UNKNOWN_FMU_PLATFORM
+#endif
+
+bool starts_with(const std::string& s, const std::string& prefix)
+{
+    return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+// The needed entries of an FMU, unpacked once, from which the files of each
+// instance are taken.
+struct unpacked_fmu
+{
+    cosim::utility::temp_dir dir;
+    std::vector<std::string> entries;
+};
+
+struct cached_fmu
+{
+    cosim::filesystem::file_time_type modified;
+    std::uintmax_t size = 0;
+    std::weak_ptr<const unpacked_fmu> unpacked;
+};
+
+struct fmu_cache
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, cached_fmu> fmus;
+};
+
+fmu_cache& get_fmu_cache()
+{
+    static fmu_cache cache;
+    return cache;
+}
+
+std::shared_ptr<const unpacked_fmu> unpack_fmu(const cosim::filesystem::path& fmuPath)
+{
+    const auto path = cosim::filesystem::canonical(fmuPath);
+    const auto modified = cosim::filesystem::last_write_time(path);
+    const auto size = cosim::filesystem::file_size(path);
+
+    auto& cache = get_fmu_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (auto it = cache.fmus.begin(); it != cache.fmus.end();) {
+        it = it->second.unpacked.expired() ? cache.fmus.erase(it) : std::next(it);
+    }
+    auto& cached = cache.fmus[path.string()];
+    if (auto unpacked = cached.unpacked.lock();
+        unpacked && cached.modified == modified && cached.size == size) {
+        return unpacked;
+    }
+
+    auto unpacked = std::make_shared<unpacked_fmu>();
+    unpacked->entries = list_zip_files(path);
+    unpacked->entries.erase(
+        std::remove_if(unpacked->entries.begin(), unpacked->entries.end(), [](const std::string& e) {
+            return !is_needed_fmu_entry(e);
+        }),
+        unpacked->entries.end());
+    extract_zip_entries(path, unpacked->entries, unpacked->dir.path());
+
+    cached.unpacked = unpacked;
+    cached.modified = modified;
+    cached.size = size;
+    return unpacked;
+}
+
+// Gives an instance its own copy of an unpacked FMU.  Binaries are copied,
+// since the dynamic loader would load a hard-linked library only once.
+// Everything else is hard-linked, or copied if that fails.
+void link_fmu_files(const unpacked_fmu& unpacked, const cosim::filesystem::path& targetDir)
+{
+    for (const auto& entry : unpacked.entries) {
+        const auto from = unpacked.dir.path() / entry;
+        const auto to = targetDir / entry;
+        cosim::filesystem::create_directories(to.parent_path());
+        std::error_code linkError;
+        if (!starts_with(entry, "binaries/")) {
+            cosim::filesystem::create_hard_link(from, to, linkError);
+            if (!linkError) continue;
+        }
+        cosim::filesystem::copy_file(from, to);
+    }
+}
+
+// An FMU instance along with the files it was loaded from, which are removed
+// after the instance is destroyed.
+struct owning_slave
+{
+    std::shared_ptr<const unpacked_fmu> unpacked;
+    cosim::utility::temp_dir dir;
+    std::shared_ptr<cosim::slave> slave;
+};
+
+} // namespace
+
+
+bool is_needed_fmu_entry(const std::string& entryName)
+{
+    if (starts_with(entryName, "documentation/") || starts_with(entryName, "sources/")) {
+        return false;
+    }
+    if (!starts_with(entryName, "binaries/")) return true;
+#ifdef LIBCOSIMC_UNKNOWN_FMU_PLATFORM
+    return true;
+#else
+    return std::any_of(std::begin(platformDirs), std::end(platformDirs), [&](const char* dir) {
+        return starts_with(entryName, std::string("binaries/") + dir + '/');
+    });
+#endif
+}
+
+std::shared_ptr<cosim::slave> instantiate_local_slave(
+    const cosim::filesystem::path& fmuPath,
+    std::string_view instanceName)
+{
+    auto owner = std::make_shared<owning_slave>();
+    owner->unpacked = unpack_fmu(fmuPath);
+    link_fmu_files(*owner->unpacked, owner->dir.path());
+    // A separate importer, as importers share FMUs with the same GUID.
+    const auto fmu = cosim::fmi::importer::create()->import_unpacked(owner->dir.path());
+    owner->slave = fmu->instantiate_slave(instanceName);
+    return std::shared_ptr<cosim::slave>(owner, owner->slave.get());
+}
+
+} // namespace cosimc
@@ -0,0 +1,54 @@
+/**
+ *  \file
+ *  \brief A process-wide cache of selectively unpacked FMUs.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_FMU_CACHE_HPP
+#define LIBCOSIMC_FMU_CACHE_HPP
+
+#include <cosim/fs_portability.hpp>
+#include <cosim/slave.hpp>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+
+namespace cosimc
+{
+
+/**
+ *  Returns whether an FMU archive entry is needed to instantiate the FMU on
+ *  this platform.
+ *
+ *  Documentation, source code (which we cannot build anyway) and binaries
+ *  for other platforms are not.  On platforms we do not recognise, all
+ *  binaries are considered needed.
+ */
+bool is_needed_fmu_entry(const std::string& entryName);
+
+/**
+ *  Instantiates an FMU, unpacking it only once for all its instances.
+ *
+ *  The first instantiation of an FMU extracts the entries for which
+ *  `is_needed_fmu_entry()` is true, in parallel, into a temporary directory.
+ *  Each instance then gets a directory of its own, where the binaries are
+ *  copies, so that every instance loads a separate copy of the library as
+ *  before, and all other files are hard links to the shared extraction.
+ *  The FMU is unpacked again if its file has been modified.
+ *
+ *  An instance's directory is removed when the slave is destroyed, and the
+ *  shared extraction when the last instance made from it is.
+ *
+ *  This function is thread safe.
+ */
+std::shared_ptr<cosim::slave> instantiate_local_slave(
+    const cosim::filesystem::path& fmuPath,
+    std::string_view instanceName);
+
+} // namespace cosimc
+#endif // header guard
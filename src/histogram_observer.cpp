@@ -0,0 +1,300 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "histogram_observer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace cosimc
+{
+
+histogram::histogram(bin_scale scale, double min, double max, std::size_t numBins)
+    : scale_(scale)
+    , min_(min)
+    , max_(max)
+    , counts_(numBins)
+{
+    if (numBins == 0) {
+        throw std::invalid_argument("A histogram must have at least one bin");
+    }
+    if (!(max > min)) {
+        throw std::invalid_argument("The upper limit of a histogram must be greater than the lower limit");
+    }
+    if (scale == bin_scale::logarithmic) {
+        if (!(min > 0.0)) {
+            throw std::invalid_argument("The lower limit of a histogram with logarithmic bins must be positive");
+        }
+        offset_ = std::log(min);
+        scaleFactor_ = static_cast<double>(numBins) / (std::log(max) - offset_);
+    } else {
+        offset_ = min;
+        scaleFactor_ = static_cast<double>(numBins) / (max - min);
+    }
+}
+
+void histogram::add(double value) noexcept
+{
+    if (std::isnan(value)) return;
+    if (samples_ == 0) {
+        minSeen_ = maxSeen_ = value;
+    } else {
+        minSeen_ = std::min(minSeen_, value);
+        maxSeen_ = std::max(maxSeen_, value);
+    }
+    ++samples_;
+    sum_ += value;
+
+    if (value < min_) {
+        ++underflow_;
+    } else if (value >= max_) {
+        ++overflow_;
+    } else {
+        const auto x = scale_ == bin_scale::logarithmic ? std::log(value) : value;
+        // Rounding may put values just below the upper limit out of range.
+        const auto bin = static_cast<std::size_t>(std::max(0.0, (x - offset_) * scaleFactor_));
+        ++counts_[std::min(bin, counts_.size() - 1)];
+    }
+}
+
+std::vector<double> histogram::bin_edges() const
+{
+    const auto numBins = counts_.size();
+    std::vector<double> edges(numBins + 1);
+    for (std::size_t i = 0; i <= numBins; ++i) {
+        const auto x = offset_ + static_cast<double>(i) / scaleFactor_;
+        edges[i] = scale_ == bin_scale::logarithmic ? std::exp(x) : x;
+    }
+    edges.front() = min_;
+    edges.back() = max_;
+    return edges;
+}
+
+double histogram::min() const noexcept
+{
+    return samples_ ? minSeen_ : std::numeric_limits<double>::quiet_NaN();
+}
+
+double histogram::max() const noexcept
+{
+    return samples_ ? maxSeen_ : std::numeric_limits<double>::quiet_NaN();
+}
+
+double histogram::mean() const noexcept
+{
+    return samples_ ? sum_ / static_cast<double>(samples_) : std::numeric_limits<double>::quiet_NaN();
+}
+
+
+rainflow_counter::rainflow_counter(double maxRange, std::size_t numBins)
+    : counted_(numBins)
+{
+    if (numBins == 0) {
+        throw std::invalid_argument("Rainflow counting needs at least one range bin");
+    }
+    if (!(maxRange > 0.0)) {
+        throw std::invalid_argument("The maximum rainflow range must be positive");
+    }
+    binWidth_ = maxRange / static_cast<double>(numBins);
+}
+
+void rainflow_counter::add(double value)
+{
+    if (std::isnan(value)) return;
+    if (!last_) {
+        // The first value of a series is always a reversal.
+        add_reversal(value);
+        last_ = value;
+        hasDirection_ = false;
+        return;
+    }
+    if (value == *last_) return;
+    const bool rising = value > *last_;
+    if (hasDirection_ && rising != rising_) {
+        // The previous value was a turning point.
+        add_reversal(*last_);
+    }
+    rising_ = rising;
+    hasDirection_ = true;
+    last_ = value;
+}
+
+void rainflow_counter::break_series() noexcept
+{
+    if (last_ && hasDirection_) residue_.push_back(*last_);
+    for (std::size_t i = 1; i < residue_.size(); ++i) {
+        count(std::abs(residue_[i] - residue_[i - 1]), 0.5);
+    }
+    residue_.clear();
+    last_.reset();
+    hasDirection_ = false;
+}
+
+std::vector<double> rainflow_counter::cycles() const
+{
+    auto result = counted_;
+    const auto addHalfCycle = [&](double range) {
+        const auto bin = static_cast<std::size_t>(range / binWidth_);
+        result[std::min(bin, result.size() - 1)] += 0.5;
+    };
+    for (std::size_t i = 1; i < residue_.size(); ++i) {
+        addHalfCycle(std::abs(residue_[i] - residue_[i - 1]));
+    }
+    // The last value is not yet a confirmed reversal, but it ends the series
+    // so far.
+    if (last_ && hasDirection_ && !residue_.empty()) {
+        addHalfCycle(std::abs(*last_ - residue_.back()));
+    }
+    return result;
+}
+
+void rainflow_counter::add_reversal(double value)
+{
+    residue_.push_back(value);
+    // Four-point method: with the last four reversals A, B, C and D, the
+    // range B-C is a closed cycle if it is no larger than A-B and C-D.
+    while (residue_.size() >= 4) {
+        const auto n = residue_.size();
+        const auto inner = std::abs(residue_[n - 3] - residue_[n - 2]);
+        if (inner > std::abs(residue_[n - 4] - residue_[n - 3]) ||
+            inner > std::abs(residue_[n - 2] - residue_[n - 1])) {
+            break;
+        }
+        count(inner, 1.0);
+        residue_.erase(residue_.end() - 3, residue_.end() - 1);
+    }
+    if (residue_.size() > maxResidue) {
+        count(std::abs(residue_[1] - residue_[0]), 0.5);
+        residue_.erase(residue_.begin());
+    }
+}
+
+void rainflow_counter::count(double range, double cycles) noexcept
+{
+    const auto bin = static_cast<std::size_t>(range / binWidth_);
+    counted_[std::min(bin, counted_.size() - 1)] += cycles;
+}
+
+
+std::size_t histogram_observer::add_histogram(
+    cosim::variable_id variable,
+    bin_scale scale,
+    double min,
+    double max,
+    std::size_t numBins,
+    bool rainflow)
+{
+    if (variable.type == cosim::variable_type::string || variable.type == cosim::variable_type::enumeration) {
+        throw std::invalid_argument("Histograms can only be made of real, integer and boolean variables");
+    }
+    entry e{variable, histogram(scale, min, max, numBins), std::nullopt};
+    if (rainflow) e.rainflow.emplace(max - min, numBins);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    expose(e);
+    entries_.push_back(std::move(e));
+    return entries_.size() - 1;
+}
+
+histogram_observer::result histogram_observer::get(std::size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= entries_.size()) {
+        throw std::out_of_range("Invalid histogram index: " + std::to_string(index));
+    }
+    const auto& e = entries_[index];
+    result r;
+    r.counts = e.values.counts();
+    r.binEdges = e.values.bin_edges();
+    r.underflow = e.values.underflow();
+    r.overflow = e.values.overflow();
+    r.samples = e.values.samples();
+    r.min = e.values.min();
+    r.max = e.values.max();
+    r.mean = e.values.mean();
+    if (e.rainflow) {
+        r.cycles = e.rainflow->cycles();
+        r.rangeBinWidth = (r.binEdges.back() - r.binEdges.front()) / static_cast<double>(r.cycles.size());
+    }
+    return r;
+}
+
+void histogram_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* sim,
+    cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_[index] = sim;
+    for (const auto& e : entries_) {
+        if (e.variable.simulator == index) expose(e);
+    }
+}
+
+void histogram_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_.erase(index);
+}
+
+void histogram_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void histogram_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void histogram_observer::simulation_initialized(cosim::step_number, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& e : entries_) sample(e);
+}
+
+void histogram_observer::step_complete(cosim::step_number, cosim::duration, cosim::time_point) { }
+
+void histogram_observer::simulator_step_complete(
+    cosim::simulator_index index,
+    cosim::step_number,
+    cosim::duration,
+    cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& e : entries_) {
+        if (e.variable.simulator == index) sample(e);
+    }
+}
+
+void histogram_observer::state_restored(cosim::step_number, cosim::time_point)
+{
+    // The series is discontinuous at a restore, so cycles must not span it.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& e : entries_) {
+        if (e.rainflow) e.rainflow->break_series();
+    }
+}
+
+void histogram_observer::sample(entry& e)
+{
+    const auto it = simulators_.find(e.variable.simulator);
+    if (it == simulators_.end()) return;
+    double value = 0.0;
+    switch (e.variable.type) {
+        case cosim::variable_type::real: value = it->second->get_real(e.variable.reference); break;
+        case cosim::variable_type::integer: value = it->second->get_integer(e.variable.reference); break;
+        case cosim::variable_type::boolean: value = it->second->get_boolean(e.variable.reference) ? 1.0 : 0.0; break;
+        default: return;
+    }
+    e.values.add(value);
+    if (e.rainflow) e.rainflow->add(value);
+}
+
+void histogram_observer::expose(const entry& e)
+{
+    const auto it = simulators_.find(e.variable.simulator);
+    if (it != simulators_.end()) it->second->expose_for_getting(e.variable.type, e.variable.reference);
+}
+
+} // namespace cosimc
@@ -0,0 +1,219 @@
+/**
+ *  \file
+ *  \brief An observer which builds value distributions while a simulation
+ *  is running.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_HISTOGRAM_OBSERVER_HPP
+#define LIBCOSIMC_HISTOGRAM_OBSERVER_HPP
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Bin spacing for histograms.
+enum class bin_scale
+{
+    linear,
+    logarithmic,
+};
+
+/**
+ *  A histogram with a fixed number of bins between two limits.
+ *
+ *  Values below the lower limit or at or above the upper limit are counted
+ *  separately, as underflow and overflow.
+ */
+class histogram
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \throws std::invalid_argument if `numBins` is zero, if `max <= min`,
+     *      or if `min <= 0` with logarithmic bins.
+     */
+    histogram(bin_scale scale, double min, double max, std::size_t numBins);
+
+    /// Adds a value.  NaN values are ignored.
+    void add(double value) noexcept;
+
+    /// Returns the edges of the bins, of which there are one more than bins.
+    std::vector<double> bin_edges() const;
+
+    const std::vector<std::uint64_t>& counts() const noexcept { return counts_; }
+    std::uint64_t underflow() const noexcept { return underflow_; }
+    std::uint64_t overflow() const noexcept { return overflow_; }
+    std::uint64_t samples() const noexcept { return samples_; }
+    /// The smallest value added, or NaN if there are none.
+    double min() const noexcept;
+    /// The largest value added, or NaN if there are none.
+    double max() const noexcept;
+    /// The mean of the values added, or NaN if there are none.
+    double mean() const noexcept;
+
+private:
+    bin_scale scale_;
+    double min_;
+    double max_;
+    // Maps a value (or its logarithm) to a fractional bin index.
+    double offset_;
+    double scaleFactor_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t underflow_ = 0;
+    std::uint64_t overflow_ = 0;
+    std::uint64_t samples_ = 0;
+    double sum_ = 0.0;
+    double minSeen_ = 0.0;
+    double maxSeen_ = 0.0;
+};
+
+
+/**
+ *  Streaming rainflow cycle counting, as used in fatigue analysis.
+ *
+ *  Reversals (turning points) are extracted from the series as values are
+ *  added, and closed cycles are counted with the four-point method as soon
+ *  as they are found.  The ranges of the cycles are binned between zero and
+ *  `maxRange`, with larger ranges counted in the last bin.
+ *
+ *  The residue, the reversals which have not yet formed closed cycles, is
+ *  counted as half cycles when the counts are retrieved.  The residue is
+ *  bounded by `maxResidue` reversals; if it grows beyond that, its oldest
+ *  range is counted as a half cycle and dropped, so memory use is constant.
+ */
+class rainflow_counter
+{
+public:
+    /// The most reversals kept in the residue.
+    static constexpr std::size_t maxResidue = 4096;
+
+    /**
+     *  Constructor.
+     *
+     *  \throws std::invalid_argument if `numBins` is zero or `maxRange` is
+     *      not positive.
+     */
+    rainflow_counter(double maxRange, std::size_t numBins);
+
+    /// Adds the next value in the series.  NaN values are ignored.
+    void add(double value);
+
+    /**
+     *  Ends the current series, so that the next value added starts a new
+     *  one.  The residue of the current series is counted as half cycles.
+     */
+    void break_series() noexcept;
+
+    /// Returns the number of cycles per range bin, including the residue.
+    std::vector<double> cycles() const;
+
+private:
+    void add_reversal(double value);
+    void count(double range, double cycles) noexcept;
+
+    double binWidth_;
+    std::vector<double> counted_;
+    std::vector<double> residue_;
+    // The last value seen, which is a reversal candidate.
+    std::optional<double> last_;
+    // Whether `last_` differs from the previous reversal, and if so,
+    // whether the series was rising towards it.
+    bool hasDirection_ = false;
+    bool rising_ = false;
+};
+
+
+/**
+ *  An observer which maintains histograms, and optionally rainflow cycle
+ *  counts, of variable values.
+ *
+ *  A variable is sampled after every step taken by its simulator, and at
+ *  initialization.  Memory use is constant regardless of the length of the
+ *  simulation.  Real, integer and boolean variables are supported.
+ */
+class histogram_observer : public cosim::observer
+{
+public:
+    /// A snapshot of a histogram and its rainflow counts.
+    struct result
+    {
+        std::vector<std::uint64_t> counts;
+        std::vector<double> binEdges;
+        std::uint64_t underflow = 0;
+        std::uint64_t overflow = 0;
+        std::uint64_t samples = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        /// Empty unless rainflow counting was enabled.
+        std::vector<double> cycles;
+        /// The width of the rainflow range bins, which start at zero.
+        double rangeBinWidth = 0.0;
+    };
+
+    histogram_observer() = default;
+
+    histogram_observer(const histogram_observer&) = delete;
+    histogram_observer& operator=(const histogram_observer&) = delete;
+
+    /**
+     *  Adds a histogram of a variable and returns its index.
+     *
+     *  If `rainflow` is true, the cycles are also counted, in `numBins`
+     *  range bins between zero and `max - min`.
+     */
+    std::size_t add_histogram(
+        cosim::variable_id variable,
+        bin_scale scale,
+        double min,
+        double max,
+        std::size_t numBins,
+        bool rainflow);
+
+    /// Returns a snapshot of a histogram.  Thread safe.
+    result get(std::size_t index) const;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+private:
+    struct entry
+    {
+        cosim::variable_id variable;
+        histogram values;
+        std::optional<rainflow_counter> rainflow;
+    };
+
+    void sample(entry& e);
+    void expose(const entry& e);
+
+    std::unordered_map<cosim::simulator_index, cosim::observable*> simulators_;
+    mutable std::mutex mutex_;
+    std::vector<entry> entries_;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,180 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "latency_observer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace cosimc
+{
+
+void latency_observer::sample_buffer::add(std::chrono::nanoseconds sample)
+{
+    if (samples.size() < sampleCapacity) {
+        samples.push_back(sample);
+    } else {
+        samples[next] = sample;
+    }
+    next = (next + 1) % sampleCapacity;
+}
+
+latency_observer::distribution latency_observer::sample_buffer::compute() const
+{
+    distribution d;
+    if (samples.empty()) return d;
+
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const auto percentile = [&sorted](double p) {
+        return sorted[static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)];
+    };
+    std::chrono::nanoseconds sum{0};
+    for (const auto s : sorted) sum += s;
+
+    d.min = sorted.front();
+    d.mean = sum / static_cast<std::int64_t>(sorted.size());
+    d.p50 = percentile(0.5);
+    d.p90 = percentile(0.9);
+    d.p99 = percentile(0.99);
+    d.max = sorted.back();
+    return d;
+}
+
+
+latency_observer::latency_observer(std::shared_ptr<override_manipulator> manipulator)
+    : manipulator_(std::move(manipulator))
+{
+    manipulator_->enable_submission_stamping();
+}
+
+std::size_t latency_observer::add_pair(cosim::variable_id input, cosim::variable_id output)
+{
+    for (const auto& v : {input, output}) {
+        if (v.type == cosim::variable_type::string || v.type == cosim::variable_type::enumeration) {
+            throw std::invalid_argument("Latency can only be measured for real, integer and boolean variables");
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pair_state pair;
+    pair.input = input;
+    pair.output = output;
+    expose(pair);
+    pairs_.push_back(std::move(pair));
+    return pairs_.size() - 1;
+}
+
+latency_observer::pair_statistics latency_observer::stats(std::size_t pair) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pair >= pairs_.size()) {
+        throw std::out_of_range("Invalid latency pair index: " + std::to_string(pair));
+    }
+    const auto& p = pairs_[pair];
+    pair_statistics s;
+    s.samples = p.samples;
+    s.unmatched = p.unmatched;
+    s.queueing = p.queueing.compute();
+    s.processing = p.processing.compute();
+    s.total = p.total.compute();
+    return s;
+}
+
+void latency_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* sim,
+    cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_[index] = sim;
+    for (auto& pair : pairs_) {
+        if (pair.output.simulator == index) expose(pair);
+    }
+}
+
+void latency_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_.erase(index);
+}
+
+void latency_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void latency_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void latency_observer::simulation_initialized(cosim::step_number, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : pairs_) pair.lastOutput = read(pair.output);
+}
+
+void latency_observer::step_complete(cosim::step_number, cosim::duration, cosim::time_point)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : pairs_) {
+        const auto stamp = manipulator_->last_applied_submission(
+            pair.input.simulator,
+            pair.input.type,
+            pair.input.reference);
+        if (stamp && stamp->sequence != pair.lastSequence) {
+            // An override was applied at the start of this step.
+            if (pair.pending) ++pair.unmatched;
+            pair.lastSequence = stamp->sequence;
+            pair.pending = true;
+            pair.stamp = *stamp;
+            pair.baseline = pair.lastOutput;
+        }
+
+        const auto output = read(pair.output);
+        if (pair.pending && output != pair.baseline) {
+            pair.queueing.add(pair.stamp.applied - pair.stamp.submitted);
+            pair.processing.add(now - pair.stamp.applied);
+            pair.total.add(now - pair.stamp.submitted);
+            ++pair.samples;
+            pair.pending = false;
+        }
+        pair.lastOutput = output;
+    }
+}
+
+void latency_observer::simulator_step_complete(
+    cosim::simulator_index,
+    cosim::step_number,
+    cosim::duration,
+    cosim::time_point)
+{
+}
+
+void latency_observer::state_restored(cosim::step_number, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : pairs_) {
+        pair.lastOutput = read(pair.output);
+        pair.pending = false;
+    }
+}
+
+double latency_observer::read(const cosim::variable_id& variable) const
+{
+    const auto it = simulators_.find(variable.simulator);
+    if (it == simulators_.end()) return 0.0;
+    switch (variable.type) {
+        case cosim::variable_type::real: return it->second->get_real(variable.reference);
+        case cosim::variable_type::integer: return it->second->get_integer(variable.reference);
+        case cosim::variable_type::boolean: return it->second->get_boolean(variable.reference) ? 1.0 : 0.0;
+        default: return 0.0;
+    }
+}
+
+void latency_observer::expose(const pair_state& pair)
+{
+    const auto it = simulators_.find(pair.output.simulator);
+    if (it != simulators_.end()) it->second->expose_for_getting(pair.output.type, pair.output.reference);
+}
+
+} // namespace cosimc
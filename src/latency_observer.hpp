@@ -0,0 +1,145 @@
+/**
+ *  \file
+ *  \brief An observer which measures the latency from overriding an input
+ *  to the corresponding output changing.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_LATENCY_OBSERVER_HPP
+#define LIBCOSIMC_LATENCY_OBSERVER_HPP
+
+#include "override_manipulator.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  An observer which measures end-to-end latency through the simulation.
+ *
+ *  The observer is attached to an `override_manipulator`, and measures,
+ *  for given pairs of variables, the wall-clock time from an immediate
+ *  override of the first variable being submitted to the manipulator until
+ *  a change in the second variable has been published to observers.  The
+ *  latency is split into the time the override waited to be applied, at the
+ *  start of the next step, and the time from then until the output changed
+ *  and the step in which it did ended.
+ *
+ *  An output is considered to respond to an override when it first differs
+ *  from its value before the step in which the override was applied.  If
+ *  another override of the input is applied before the output responds, the
+ *  earlier one is counted as unmatched.
+ *
+ *  Distributions are computed from the most recent `sampleCapacity` samples.
+ */
+class latency_observer : public cosim::observer
+{
+public:
+    /// The number of samples kept per distribution.
+    static constexpr std::size_t sampleCapacity = 4096;
+
+    /// A latency distribution.
+    struct distribution
+    {
+        std::chrono::nanoseconds min{0};
+        std::chrono::nanoseconds mean{0};
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p90{0};
+        std::chrono::nanoseconds p99{0};
+        std::chrono::nanoseconds max{0};
+    };
+
+    /// Latency statistics for a pair of variables.
+    struct pair_statistics
+    {
+        /// The total number of measurements.
+        std::uint64_t samples = 0;
+        /// The number of overrides which were superseded before the output responded.
+        std::uint64_t unmatched = 0;
+        /// From submission until the override was applied.
+        distribution queueing;
+        /// From the override being applied until the output was published.
+        distribution processing;
+        /// From submission until the output was published.
+        distribution total;
+    };
+
+    /// Constructor.  Enables submission stamping on `manipulator`.
+    explicit latency_observer(std::shared_ptr<override_manipulator> manipulator);
+
+    latency_observer(const latency_observer&) = delete;
+    latency_observer& operator=(const latency_observer&) = delete;
+
+    /**
+     *  Adds a pair of variables to measure the latency between, and returns
+     *  its index.  Should be called before the simulation is started.
+     */
+    std::size_t add_pair(cosim::variable_id input, cosim::variable_id output);
+
+    /// Returns the statistics for a pair.  Thread safe.
+    pair_statistics stats(std::size_t pair) const;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+private:
+    // The most recent samples of a latency, in a ring buffer.
+    struct sample_buffer
+    {
+        std::vector<std::chrono::nanoseconds> samples;
+        std::size_t next = 0;
+
+        void add(std::chrono::nanoseconds sample);
+        distribution compute() const;
+    };
+
+    struct pair_state
+    {
+        cosim::variable_id input;
+        cosim::variable_id output;
+        double lastOutput = 0.0;
+        std::uint64_t lastSequence = 0;
+        bool pending = false;
+        override_manipulator::submission_stamp stamp;
+        double baseline = 0.0;
+        std::uint64_t samples = 0;
+        std::uint64_t unmatched = 0;
+        sample_buffer queueing;
+        sample_buffer processing;
+        sample_buffer total;
+    };
+
+    double read(const cosim::variable_id& variable) const;
+    void expose(const pair_state& pair);
+
+    std::shared_ptr<override_manipulator> manipulator_;
+    std::unordered_map<cosim::simulator_index, cosim::observable*> simulators_;
+
+    mutable std::mutex mutex_;
+    std::vector<pair_state> pairs_;
+};
+
+} // namespace cosimc
+#endif // header guard
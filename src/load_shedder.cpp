@@ -0,0 +1,69 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "load_shedder.hpp"
+
+#include <algorithm>
+
+
+namespace cosimc
+{
+namespace
+{
+constexpr double degradeThreshold = 0.95;
+constexpr double restoreThreshold = 0.5;
+} // namespace
+
+
+void load_shedder::set_max_level(int maxLevel) noexcept
+{
+    maxLevel_ = std::max(0, maxLevel);
+    level_ = std::min(level_, maxLevel_);
+}
+
+void load_shedder::reset() noexcept
+{
+    level_ = 0;
+    stepsInWindow_ = 0;
+    cooldown_ = 0;
+    busyTime_ = 0.0;
+    availableTime_ = 0.0;
+}
+
+std::optional<int> load_shedder::step_complete(
+    std::chrono::nanoseconds busyTime,
+    cosim::duration stepSize,
+    double rtfTarget,
+    double rollingRtf,
+    int window)
+{
+    if (rtfTarget <= 0.0) return std::nullopt;
+
+    busyTime_ += std::chrono::duration<double>(busyTime).count();
+    availableTime_ += std::chrono::duration<double>(stepSize).count() / rtfTarget;
+    if (++stepsInWindow_ < std::max(1, window)) return std::nullopt;
+
+    const double load = busyTime_ / availableTime_;
+    stepsInWindow_ = 0;
+    busyTime_ = 0.0;
+    availableTime_ = 0.0;
+
+    if (cooldown_ > 0) {
+        --cooldown_;
+        return std::nullopt;
+    }
+    if (rollingRtf < degradeThreshold * rtfTarget && level_ < maxLevel_) {
+        ++level_;
+        cooldown_ = 1;
+        return level_;
+    }
+    if (level_ > 0 && load < restoreThreshold) {
+        --level_;
+        cooldown_ = 1;
+        return level_;
+    }
+    return std::nullopt;
+}
+
+} // namespace cosimc
@@ -0,0 +1,84 @@
+/**
+ *  \file
+ *  \brief Real-time load shedding control.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_LOAD_SHEDDER_HPP
+#define LIBCOSIMC_LOAD_SHEDDER_HPP
+
+#include <cosim/time.hpp>
+
+#include <chrono>
+#include <optional>
+
+
+namespace cosimc
+{
+
+/**
+ *  Decides when to shed load in a real-time simulation.
+ *
+ *  The shedder maintains a *level*, where level `n` means that degradable
+ *  simulators should have their decimation factor multiplied by `2^n`.
+ *  It is fed the wall-clock time spent computing each step, and at the end
+ *  of every monitoring window (whose length is the number of steps used for
+ *  the rolling average real time factor) it compares:
+ *
+ *    - the rolling average real time factor against the target.  If it is
+ *      more than 5% below the target, the level is increased.
+ *
+ *    - the *load*, i.e., the ratio of the computation time to the wall-clock
+ *      time available for the window.  If this has dropped below 50%, there
+ *      is enough headroom to halve the decimation, and the level is
+ *      decreased.
+ *
+ *  After each change, one window is skipped to let the measurements settle.
+ */
+class load_shedder
+{
+public:
+    /// Returns the current level.
+    int level() const noexcept { return level_; }
+
+    /// Sets the maximum level, lowering the current level if necessary.
+    void set_max_level(int maxLevel) noexcept;
+
+    /// Resets the level to zero and discards all measurements.
+    void reset() noexcept;
+
+    /**
+     *  Records a completed step and returns the new level if it changed.
+     *
+     *  \param busyTime
+     *      The wall-clock time spent computing the step.
+     *  \param stepSize
+     *      The simulated length of the step.
+     *  \param rtfTarget
+     *      The real time factor target.
+     *  \param rollingRtf
+     *      The current rolling average real time factor.
+     *  \param window
+     *      The number of steps over which to measure.
+     */
+    std::optional<int> step_complete(
+        std::chrono::nanoseconds busyTime,
+        cosim::duration stepSize,
+        double rtfTarget,
+        double rollingRtf,
+        int window);
+
+private:
+    int level_ = 0;
+    int maxLevel_ = 0;
+    int stepsInWindow_ = 0;
+    int cooldown_ = 0;
+    double busyTime_ = 0.0;
+    double availableTime_ = 0.0;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(_WIN32) && !defined(NOMINMAX)
+#    define NOMINMAX
+#endif
+
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+
+namespace cosimc
+{
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(const cosim::filesystem::path& path)
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " '" + path.string() + "'");
+    };
+
+    fileHandle_ = CreateFileW(
+        path.native().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (fileHandle_ == INVALID_HANDLE_VALUE) {
+        fileHandle_ = nullptr;
+        fail("Failed to open");
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle_, &fileSize)) fail("Failed to determine size of");
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size_ == 0) return;
+
+    mappingHandle_ = CreateFileMappingW(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle_) fail("Failed to map");
+    data_ = static_cast<const char*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) fail("Failed to map");
+}
+
+mapped_file::~mapped_file() noexcept
+{
+    unmap();
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (data_) UnmapViewOfFile(data_);
+    if (mappingHandle_) CloseHandle(mappingHandle_);
+    if (fileHandle_) CloseHandle(fileHandle_);
+    data_ = nullptr;
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+}
+
+#else
+
+mapped_file::mapped_file(const cosim::filesystem::path& path)
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(errno, std::generic_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " '" + path.string() + "'");
+    };
+
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) fail("Failed to open");
+    struct stat fileStatus;
+    if (::fstat(fd_, &fileStatus) != 0) fail("Failed to determine size of");
+    size_ = static_cast<std::size_t>(fileStatus.st_size);
+    if (size_ == 0) return;
+
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) fail("Failed to map");
+    data_ = static_cast<const char*>(addr);
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+}
+
+mapped_file::~mapped_file() noexcept
+{
+    unmap();
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+}
+
+#endif
+
+} // namespace cosimc
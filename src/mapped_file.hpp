@@ -0,0 +1,65 @@
+/**
+ *  \file
+ *  \brief Read-only memory-mapped files.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_MAPPED_FILE_HPP
+#define LIBCOSIMC_MAPPED_FILE_HPP
+
+#include <cosim/fs_portability.hpp>
+
+#include <cstddef>
+
+
+namespace cosimc
+{
+
+/**
+ *  A read-only memory mapping of an entire file.
+ *
+ *  The mapping is hinted for sequential access, which makes it suitable for
+ *  streaming through large recordings without reading them into memory
+ *  up front.
+ */
+class mapped_file
+{
+public:
+    /**
+     *  Maps the file at `path`.
+     *
+     *  \throws std::system_error if the file could not be opened or mapped.
+     */
+    explicit mapped_file(const cosim::filesystem::path& path);
+
+    ~mapped_file() noexcept;
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&&) = delete;
+    mapped_file& operator=(mapped_file&&) = delete;
+
+    /// The start of the mapped file contents.
+    const char* data() const noexcept { return data_; }
+
+    /// The size of the file, in bytes.
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    void unmap() noexcept;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace cosimc
+#endif // header guard
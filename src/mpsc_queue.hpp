@@ -0,0 +1,115 @@
+/**
+ *  \file
+ *  \brief A bounded, lock-free multi-producer single-consumer queue.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_MPSC_QUEUE_HPP
+#define LIBCOSIMC_MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+
+namespace cosimc
+{
+
+/**
+ *  A bounded queue which any number of threads may push to, and one thread
+ *  may pop from, without locking.
+ *
+ *  This is D. Vyukov's bounded queue: every cell carries a sequence number
+ *  which tells whether it is ready to be written for a given lap around
+ *  the ring, or ready to be read.  Producers claim cells by incrementing the
+ *  tail index with a CAS, so they never wait for each other except to retry
+ *  the CAS, and never wait for the consumer.  A push to a full queue fails
+ *  immediately.
+ */
+template<typename T>
+class mpsc_queue
+{
+public:
+    /// Constructor.  `capacity` is rounded up to a power of two.
+    explicit mpsc_queue(std::size_t capacity)
+    {
+        if (capacity == 0) throw std::invalid_argument("Queue capacity must be positive");
+        std::size_t size = 1;
+        while (size < capacity) size *= 2;
+        cells_ = std::make_unique<cell[]>(size);
+        mask_ = size - 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /// Returns the capacity of the queue.
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    /// Adds an element, or returns false if the queue is full.  Thread safe.
+    bool try_push(T value)
+    {
+        auto pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = cells_[pos & mask_];
+            const auto seq = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = std::move(value);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     *  Removes the oldest element, or returns false if the queue is empty.
+     *  May only be called by one thread at a time.
+     */
+    bool try_pop(T& value)
+    {
+        auto& c = cells_[head_ & mask_];
+        const auto seq = c.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(head_ + 1) < 0) {
+            return false;
+        }
+        value = std::move(c.value);
+        c.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+private:
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Producers and the consumer work on opposite ends, so keep them on
+    // separate cache lines.
+    static constexpr std::size_t cacheLineSize = 64;
+
+    std::unique_ptr<cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(cacheLineSize) std::atomic<std::size_t> tail_{0};
+    alignas(cacheLineSize) std::size_t head_ = 0;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,364 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "override_manipulator.hpp"
+
+#include "error.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+
+namespace cosimc
+{
+namespace
+{
+
+double seconds(cosim::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+template<typename T>
+std::function<T(T, cosim::duration)> constant_modifier(const std::variant<std::monostate, double, int, bool, std::string>& value)
+{
+    if (const auto v = std::get_if<T>(&value)) {
+        return [x = *v](T, cosim::duration) { return x; };
+    }
+    return nullptr;
+}
+
+} // namespace
+
+
+override_manipulator::override_manipulator(std::size_t queueCapacity)
+    : submissions_(queueCapacity)
+    , variableTable_(std::make_shared<variable_table>())
+{
+}
+
+override_manipulator::~override_manipulator() noexcept = default;
+
+void override_manipulator::simulator_added(
+    cosim::simulator_index index,
+    cosim::manipulable* sim,
+    cosim::time_point)
+{
+    simulator_entry entry;
+    entry.sim = sim;
+    auto variables = std::make_shared<variable_set>();
+    for (const auto& v : sim->model_description().variables) {
+        if (v.type == cosim::variable_type::enumeration) continue;
+        variables->emplace(v.type, v.reference);
+        // Parameters are set the same way as inputs.
+        if (v.causality == cosim::variable_causality::input ||
+            v.causality == cosim::variable_causality::parameter) {
+            entry.inputs.emplace(v.type, v.reference);
+        }
+    }
+    entry.variables = std::move(variables);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto table = std::make_shared<variable_table>(*variableTable_);
+    (*table)[index] = entry.variables;
+    std::atomic_store(&variableTable_, std::shared_ptr<const variable_table>(std::move(table)));
+    simulators_[index] = std::move(entry);
+}
+
+void override_manipulator::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto table = std::make_shared<variable_table>(*variableTable_);
+    table->erase(index);
+    std::atomic_store(&variableTable_, std::shared_ptr<const variable_table>(std::move(table)));
+    simulators_.erase(index);
+    const auto ofSimulator = [index](const auto& entry) { return std::get<0>(entry.first) == index; };
+    for (auto it = ramps_.begin(); it != ramps_.end();) {
+        it = ofSimulator(*it) ? ramps_.erase(it) : std::next(it);
+    }
+    for (auto it = generations_.begin(); it != generations_.end();) {
+        it = ofSimulator(*it) ? generations_.erase(it) : std::next(it);
+    }
+    for (auto it = stamps_.begin(); it != stamps_.end();) {
+        it = ofSimulator(*it) ? stamps_.erase(it) : std::next(it);
+    }
+}
+
+void override_manipulator::step_commencing(cosim::time_point currentTime)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    action a;
+    while (submissions_.try_pop(a)) {
+        if (a.submitted != std::chrono::steady_clock::time_point()) {
+            stamps_[a.variable] = {a.submitted, std::chrono::steady_clock::now(), ++stampSequence_};
+        }
+        apply(a, currentTime);
+    }
+
+    while (!schedule_.empty() && schedule_.top().time <= currentTime) {
+        const auto s = schedule_.top();
+        schedule_.pop();
+        apply(s.what, s.time);
+    }
+
+    for (auto it = ramps_.begin(); it != ramps_.end();) {
+        if (currentTime >= it->second.start + it->second.duration) {
+            set_modifier(it->first, it->second.target);
+            it = ramps_.erase(it);
+        } else {
+            set_ramp_modifier(it->first, it->second, currentTime);
+            ++it;
+        }
+    }
+}
+
+void override_manipulator::override_real_variable(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    double value)
+{
+    add_action({{index, cosim::variable_type::real, variable}, value});
+}
+
+void override_manipulator::override_integer_variable(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    int value)
+{
+    add_action({{index, cosim::variable_type::integer, variable}, value});
+}
+
+void override_manipulator::override_boolean_variable(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    bool value)
+{
+    add_action({{index, cosim::variable_type::boolean, variable}, value});
+}
+
+void override_manipulator::override_string_variable(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    const std::string& value)
+{
+    add_action({{index, cosim::variable_type::string, variable}, value});
+}
+
+void override_manipulator::reset_variable(
+    cosim::simulator_index index,
+    cosim::variable_type type,
+    cosim::value_reference variable)
+{
+    add_action({{index, type, variable}, std::monostate()});
+}
+
+void override_manipulator::schedule_real_override(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    double value,
+    cosim::time_point activationTime,
+    cosim::duration rampDuration,
+    cosim::duration holdDuration)
+{
+    if (rampDuration < cosim::duration::zero() || holdDuration < cosim::duration::zero()) {
+        throw std::invalid_argument("Ramp and hold durations must be non-negative");
+    }
+    const variable_key key{index, cosim::variable_type::real, variable};
+    std::lock_guard<std::mutex> lock(mutex_);
+    check_variable(key);
+    schedule(activationTime, {key, value, rampDuration, holdDuration});
+}
+
+void override_manipulator::schedule_integer_override(
+    cosim::simulator_index index,
+    cosim::value_reference variable,
+    int value,
+    cosim::time_point activationTime,
+    cosim::duration holdDuration)
+{
+    if (holdDuration < cosim::duration::zero()) {
+        throw std::invalid_argument("The hold duration must be non-negative");
+    }
+    const variable_key key{index, cosim::variable_type::integer, variable};
+    std::lock_guard<std::mutex> lock(mutex_);
+    check_variable(key);
+    schedule(activationTime, {key, value, cosim::duration::zero(), holdDuration});
+}
+
+void override_manipulator::schedule_reset(
+    cosim::simulator_index index,
+    cosim::variable_type type,
+    cosim::value_reference variable,
+    cosim::time_point activationTime)
+{
+    const variable_key key{index, type, variable};
+    std::lock_guard<std::mutex> lock(mutex_);
+    check_variable(key);
+    schedule(activationTime, {key, std::monostate()});
+}
+
+std::uint64_t override_manipulator::overflow_count() const noexcept
+{
+    return overflowCount_;
+}
+
+void override_manipulator::enable_submission_stamping() noexcept
+{
+    stampSubmissions_ = true;
+}
+
+std::optional<override_manipulator::submission_stamp> override_manipulator::last_applied_submission(
+    cosim::simulator_index index,
+    cosim::variable_type type,
+    cosim::value_reference variable)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = stamps_.find({index, type, variable});
+    if (it == stamps_.end()) return std::nullopt;
+    return it->second;
+}
+
+void override_manipulator::add_action(action a)
+{
+    // This must not lock `mutex_`, which is held while stepping.  Actions
+    // for simulators which are removed before they are applied are dropped
+    // in apply().
+    check_variable(a.variable);
+    if (stampSubmissions_) a.submitted = std::chrono::steady_clock::now();
+    if (!submissions_.try_push(std::move(a))) {
+        ++overflowCount_;
+        throw error(
+            COSIM_ERRC_QUEUE_FULL,
+            "The override queue is full (capacity " + std::to_string(submissions_.capacity()) + ")");
+    }
+}
+
+// Must be called with `mutex_` held.
+void override_manipulator::schedule(cosim::time_point time, action a)
+{
+    schedule_.push({time, sequence_++, std::move(a)});
+}
+
+void override_manipulator::check_variable(const variable_key& variable) const
+{
+    const auto& [index, type, reference] = variable;
+    const auto table = std::atomic_load(&variableTable_);
+    const auto it = table->find(index);
+    if (it == table->end()) {
+        throw std::out_of_range("Invalid simulator index: " + std::to_string(index));
+    }
+    if (!it->second->count({type, reference})) {
+        throw std::out_of_range(
+            "Simulator " + std::to_string(index) + " has no variable of the given type " +
+            "with value reference " + std::to_string(reference));
+    }
+}
+
+// Must be called with `mutex_` held.  `time` is the time at which the
+// action was due, which may be earlier than the current time.
+void override_manipulator::apply(const action& a, cosim::time_point time)
+{
+    // The simulator may have been removed, or replaced by one with other
+    // variables, since the action was checked.
+    const auto sim = simulators_.find(std::get<0>(a.variable));
+    if (sim == simulators_.end()) return;
+    const auto& [index, type, reference] = a.variable;
+    if (!sim->second.variables->count({type, reference})) return;
+
+    auto& generation = generations_[a.variable];
+    // An expiry only applies if the override it was scheduled for has not
+    // been superseded.
+    if (a.generation != 0 && a.generation != generation) return;
+    ++generation;
+
+    ramps_.erase(a.variable);
+    const auto target = std::get_if<double>(&a.value);
+    if (target && a.rampDuration > cosim::duration::zero()) {
+        // The modifier is set in step_commencing().
+        ramps_.emplace(a.variable, ramp{time, a.rampDuration, *target});
+    } else {
+        set_modifier(a.variable, a.value);
+    }
+
+    if (a.holdDuration > cosim::duration::zero()) {
+        action expiry{a.variable, std::monostate()};
+        expiry.generation = generation;
+        schedule(time + a.holdDuration, std::move(expiry));
+    }
+}
+
+void override_manipulator::set_modifier(const variable_key& variable, const override_value& value)
+{
+    const auto& [index, type, reference] = variable;
+    const auto& entry = simulators_.at(index);
+    const bool input = entry.inputs.count({type, reference}) > 0;
+    entry.sim->expose_for_setting(type, reference);
+    switch (type) {
+        case cosim::variable_type::real: {
+            auto m = constant_modifier<double>(value);
+            if (input) {
+                entry.sim->set_real_input_modifier(reference, std::move(m));
+            } else {
+                entry.sim->set_real_output_modifier(reference, std::move(m));
+            }
+            break;
+        }
+        case cosim::variable_type::integer: {
+            auto m = constant_modifier<int>(value);
+            if (input) {
+                entry.sim->set_integer_input_modifier(reference, std::move(m));
+            } else {
+                entry.sim->set_integer_output_modifier(reference, std::move(m));
+            }
+            break;
+        }
+        case cosim::variable_type::boolean: {
+            auto m = constant_modifier<bool>(value);
+            if (input) {
+                entry.sim->set_boolean_input_modifier(reference, std::move(m));
+            } else {
+                entry.sim->set_boolean_output_modifier(reference, std::move(m));
+            }
+            break;
+        }
+        case cosim::variable_type::string: {
+            std::function<std::string(std::string_view, cosim::duration)> m;
+            if (const auto v = std::get_if<std::string>(&value)) {
+                m = [x = *v](std::string_view, cosim::duration) { return x; };
+            }
+            if (input) {
+                entry.sim->set_string_input_modifier(reference, std::move(m));
+            } else {
+                entry.sim->set_string_output_modifier(reference, std::move(m));
+            }
+            break;
+        }
+        default:
+            throw std::invalid_argument("Variable type not supported by override manipulator");
+    }
+}
+
+void override_manipulator::set_ramp_modifier(
+    const variable_key& variable,
+    const ramp& r,
+    cosim::time_point currentTime)
+{
+    const auto& [index, type, reference] = variable;
+    const auto& entry = simulators_.at(index);
+    const double fraction = std::clamp(seconds(currentTime - r.start) / seconds(r.duration), 0.0, 1.0);
+    auto m = [fraction, target = r.target](double original, cosim::duration) {
+        return original + fraction * (target - original);
+    };
+    entry.sim->expose_for_setting(type, reference);
+    if (entry.inputs.count({type, reference})) {
+        entry.sim->set_real_input_modifier(reference, std::move(m));
+    } else {
+        entry.sim->set_real_output_modifier(reference, std::move(m));
+    }
+}
+
+} // namespace cosimc
@@ -0,0 +1,243 @@
+/**
+ *  \file
+ *  \brief A manipulator which overrides variable values, immediately or on
+ *  a schedule.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_OVERRIDE_MANIPULATOR_HPP
+#define LIBCOSIMC_OVERRIDE_MANIPULATOR_HPP
+
+#include "mpsc_queue.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/manipulator/manipulator.hpp>
+#include <cosim/model_description.hpp>
+#include <cosim/time.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A manipulator which overrides the values of variables.
+ *
+ *  This works like `cosim::override_manipulator`: an override replaces the
+ *  value of an input or parameter before it is passed to the simulator, or
+ *  the value of any other variable before it is passed on to connected
+ *  inputs and observers, until it is reset.
+ *
+ *  In addition, overrides may be scheduled to take effect at a given
+ *  simulation time, optionally ramping linearly from the variable's own
+ *  value to the override value over a given duration, and optionally
+ *  expiring after a given duration.  Scheduled overrides are kept in a
+ *  time-ordered queue and applied in `step_commencing()`, i.e., at the start
+ *  of the first step which starts at or after their activation time.  A
+ *  ramp is evaluated at the start of each step, and held over the step.
+ *
+ *  A new override of a variable, whether immediate or scheduled, supersedes
+ *  any ongoing ramp or pending expiry of a previous one.
+ *
+ *  Immediate overrides and resets may be submitted from any number of
+ *  threads while the simulation is running.  They are passed through a
+ *  bounded lock-free queue which is drained in `step_commencing()`, so
+ *  submitting threads never block the stepping thread, nor each other.  If
+ *  the queue is full, the submission fails with `COSIM_ERRC_QUEUE_FULL`,
+ *  and is counted in `overflow_count()`.
+ *
+ *  For latency measurements, immediate overrides may be stamped with the
+ *  wall-clock time at which they were submitted and the time at which they
+ *  were applied, at the start of the following step.
+ */
+class override_manipulator : public cosim::manipulator
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param queueCapacity
+     *      The maximum number of immediate overrides and resets which may be
+     *      submitted between two steps, rounded up to a power of two.
+     */
+    explicit override_manipulator(std::size_t queueCapacity = 4096);
+    ~override_manipulator() noexcept override;
+
+    override_manipulator(const override_manipulator&) = delete;
+    override_manipulator& operator=(const override_manipulator&) = delete;
+
+    // cosim::manipulator methods
+    void simulator_added(cosim::simulator_index, cosim::manipulable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void step_commencing(cosim::time_point currentTime) override;
+
+    /// Overrides the value of a real variable from the next step.
+    void override_real_variable(cosim::simulator_index index, cosim::value_reference variable, double value);
+
+    /// Overrides the value of an integer variable from the next step.
+    void override_integer_variable(cosim::simulator_index index, cosim::value_reference variable, int value);
+
+    /// Overrides the value of a boolean variable from the next step.
+    void override_boolean_variable(cosim::simulator_index index, cosim::value_reference variable, bool value);
+
+    /// Overrides the value of a string variable from the next step.
+    void override_string_variable(cosim::simulator_index index, cosim::value_reference variable, const std::string& value);
+
+    /// Removes any override of a variable from the next step.
+    void reset_variable(cosim::simulator_index index, cosim::variable_type type, cosim::value_reference variable);
+
+    /**
+     *  Schedules an override of a real variable.
+     *
+     *  \param activationTime
+     *      The simulation time at which the override takes effect.
+     *  \param rampDuration
+     *      If positive, the value is ramped linearly from the variable's own
+     *      value to `value` over this duration.
+     *  \param holdDuration
+     *      If positive, the override is reset when this much time has passed
+     *      since `activationTime`.
+     */
+    void schedule_real_override(
+        cosim::simulator_index index,
+        cosim::value_reference variable,
+        double value,
+        cosim::time_point activationTime,
+        cosim::duration rampDuration,
+        cosim::duration holdDuration);
+
+    /**
+     *  Schedules an override of an integer variable.
+     *
+     *  The parameters have the same meaning as for `schedule_real_override()`.
+     */
+    void schedule_integer_override(
+        cosim::simulator_index index,
+        cosim::value_reference variable,
+        int value,
+        cosim::time_point activationTime,
+        cosim::duration holdDuration);
+
+    /// Returns the number of submissions which failed because the queue was full.
+    std::uint64_t overflow_count() const noexcept;
+
+    /// Wall-clock stamps of an immediate override.
+    struct submission_stamp
+    {
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point applied;
+        /// Increases with every stamped override which is applied.
+        std::uint64_t sequence = 0;
+    };
+
+    /// Enables stamping of immediate overrides which are submitted from now on.
+    void enable_submission_stamping() noexcept;
+
+    /// Returns the stamps of the last stamped override of a variable which has been applied, if any.
+    std::optional<submission_stamp> last_applied_submission(
+        cosim::simulator_index index,
+        cosim::variable_type type,
+        cosim::value_reference variable);
+
+    /// Schedules a reset of a variable.
+    void schedule_reset(
+        cosim::simulator_index index,
+        cosim::variable_type type,
+        cosim::value_reference variable,
+        cosim::time_point activationTime);
+
+private:
+    using variable_key = std::tuple<cosim::simulator_index, cosim::variable_type, cosim::value_reference>;
+
+    // An override value, where `std::monostate` means "reset".
+    using override_value = std::variant<std::monostate, double, int, bool, std::string>;
+
+    struct action
+    {
+        variable_key variable;
+        override_value value;
+        cosim::duration rampDuration{0};
+        cosim::duration holdDuration{0};
+        std::uint64_t generation = 0; // For expiries, the override they end
+        std::chrono::steady_clock::time_point submitted{}; // Epoch if not stamped
+    };
+
+    struct scheduled_action
+    {
+        cosim::time_point time;
+        std::uint64_t sequence;
+        action what;
+
+        bool operator>(const scheduled_action& other) const noexcept
+        {
+            return std::tie(time, sequence) > std::tie(other.time, other.sequence);
+        }
+    };
+
+    struct ramp
+    {
+        cosim::time_point start;
+        cosim::duration duration;
+        double target;
+    };
+
+    using variable_set = std::set<std::pair<cosim::variable_type, cosim::value_reference>>;
+
+    struct simulator_entry
+    {
+        cosim::manipulable* sim = nullptr;
+        // The variables which can be overridden
+        std::shared_ptr<const variable_set> variables;
+        // Inputs and parameters, which get input modifiers
+        variable_set inputs;
+    };
+
+    using variable_table = std::unordered_map<cosim::simulator_index, std::shared_ptr<const variable_set>>;
+
+    void add_action(action a);
+    void schedule(cosim::time_point time, action a);
+    void check_variable(const variable_key& variable) const;
+    void apply(const action& a, cosim::time_point time);
+    void set_modifier(const variable_key& variable, const override_value& value);
+    void set_ramp_modifier(const variable_key& variable, const ramp& r, cosim::time_point currentTime);
+
+    // Immediate actions, which are submitted without locking
+    mpsc_queue<action> submissions_;
+    // The variables of each simulator, for checking immediate actions.  The
+    // table is replaced, never modified, with `mutex_` held, and it is only
+    // accessed with `std::atomic_load()` and `std::atomic_store()`.
+    std::shared_ptr<const variable_table> variableTable_;
+    std::atomic<std::uint64_t> overflowCount_{0};
+    std::atomic<bool> stampSubmissions_{false};
+
+    std::mutex mutex_;
+    std::unordered_map<cosim::simulator_index, simulator_entry> simulators_;
+    std::priority_queue<scheduled_action, std::vector<scheduled_action>, std::greater<>> schedule_;
+    std::uint64_t sequence_ = 0;
+    std::map<variable_key, std::uint64_t> generations_;
+    std::map<variable_key, ramp> ramps_;
+    std::map<variable_key, submission_stamp> stamps_;
+    std::uint64_t stampSequence_ = 0;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "packet_layout.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// Byte order is handled with shifts, so this works the same on hosts of
+// either endianness.
+void store_bits(std::uint64_t bits, std::size_t size, bool bigEndian, char* out)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto shift = 8 * (bigEndian ? size - 1 - i : i);
+        out[i] = static_cast<char>((bits >> shift) & 0xFF);
+    }
+}
+
+std::uint64_t load_bits(std::size_t size, bool bigEndian, const char* in)
+{
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto shift = 8 * (bigEndian ? size - 1 - i : i);
+        bits |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << shift;
+    }
+    return bits;
+}
+
+template<typename T>
+std::uint64_t to_integer_bits(double value)
+{
+    if (std::isnan(value)) return 0;
+    const auto rounded = std::clamp(
+        std::round(value),
+        static_cast<double>(std::numeric_limits<T>::min()),
+        static_cast<double>(std::numeric_limits<T>::max()));
+    return static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<T>>(static_cast<T>(rounded)));
+}
+
+template<typename T>
+double from_integer_bits(std::uint64_t bits)
+{
+    return static_cast<double>(static_cast<T>(static_cast<std::make_unsigned_t<T>>(bits)));
+}
+
+} // namespace
+
+
+std::size_t encoded_size(field_encoding encoding)
+{
+    switch (encoding) {
+        case field_encoding::float64: return 8;
+        case field_encoding::float32: return 4;
+        case field_encoding::int8: return 1;
+        case field_encoding::uint8: return 1;
+        case field_encoding::int16: return 2;
+        case field_encoding::uint16: return 2;
+        case field_encoding::int32: return 4;
+        case field_encoding::uint32: return 4;
+    }
+    throw std::invalid_argument("Invalid field encoding");
+}
+
+void validate(const packet_layout& layout)
+{
+    if (layout.size == 0) throw std::invalid_argument("Packet size must be positive");
+    for (const auto& f : layout.fields) {
+        if (f.type != cosim::variable_type::real &&
+            f.type != cosim::variable_type::integer &&
+            f.type != cosim::variable_type::boolean) {
+            throw std::invalid_argument("Only real, integer and boolean variables can be mapped to packet fields");
+        }
+        const auto size = encoded_size(f.encoding);
+        if (f.offset > layout.size || size > layout.size - f.offset) {
+            throw std::invalid_argument(
+                "Packet field at offset " + std::to_string(f.offset) +
+                " extends beyond the end of the packet (" + std::to_string(layout.size) + " bytes)");
+        }
+    }
+}
+
+void encode(const packet_field& field, double value, char* packet)
+{
+    const auto size = encoded_size(field.encoding);
+    std::uint64_t bits = 0;
+    switch (field.encoding) {
+        case field_encoding::float64:
+            std::memcpy(&bits, &value, sizeof value);
+            break;
+        case field_encoding::float32: {
+            const auto f = static_cast<float>(value);
+            std::uint32_t b;
+            std::memcpy(&b, &f, sizeof f);
+            bits = b;
+            break;
+        }
+        case field_encoding::int8: bits = to_integer_bits<std::int8_t>(value); break;
+        case field_encoding::uint8: bits = to_integer_bits<std::uint8_t>(value); break;
+        case field_encoding::int16: bits = to_integer_bits<std::int16_t>(value); break;
+        case field_encoding::uint16: bits = to_integer_bits<std::uint16_t>(value); break;
+        case field_encoding::int32: bits = to_integer_bits<std::int32_t>(value); break;
+        case field_encoding::uint32: bits = to_integer_bits<std::uint32_t>(value); break;
+    }
+    store_bits(bits, size, field.bigEndian, packet + field.offset);
+}
+
+double decode(const packet_field& field, const char* packet)
+{
+    const auto bits = load_bits(encoded_size(field.encoding), field.bigEndian, packet + field.offset);
+    switch (field.encoding) {
+        case field_encoding::float64: {
+            double d;
+            std::memcpy(&d, &bits, sizeof d);
+            return d;
+        }
+        case field_encoding::float32: {
+            const auto b = static_cast<std::uint32_t>(bits);
+            float f;
+            std::memcpy(&f, &b, sizeof f);
+            return f;
+        }
+        case field_encoding::int8: return from_integer_bits<std::int8_t>(bits);
+        case field_encoding::uint8: return from_integer_bits<std::uint8_t>(bits);
+        case field_encoding::int16: return from_integer_bits<std::int16_t>(bits);
+        case field_encoding::uint16: return from_integer_bits<std::uint16_t>(bits);
+        case field_encoding::int32: return from_integer_bits<std::int32_t>(bits);
+        case field_encoding::uint32: return from_integer_bits<std::uint32_t>(bits);
+    }
+    return 0.0;
+}
+
+} // namespace cosimc
@@ -0,0 +1,79 @@
+/**
+ *  \file
+ *  \brief Fixed-layout binary packets which carry variable values.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_PACKET_LAYOUT_HPP
+#define LIBCOSIMC_PACKET_LAYOUT_HPP
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/model_description.hpp>
+
+#include <cstddef>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// How a value is represented in a packet.
+enum class field_encoding
+{
+    float64,
+    float32,
+    int8,
+    uint8,
+    int16,
+    uint16,
+    int32,
+    uint32
+};
+
+/// Returns the number of bytes a value takes up with a given encoding.
+std::size_t encoded_size(field_encoding encoding);
+
+/// A value at a fixed position in a packet.
+struct packet_field
+{
+    cosim::simulator_index simulator;
+    cosim::variable_type type;
+    cosim::value_reference reference;
+    std::size_t offset;
+    field_encoding encoding;
+    bool bigEndian;
+};
+
+/**
+ *  The layout of a fixed-size packet.
+ *
+ *  Real, integer and boolean variables may be mapped to fields of any
+ *  encoding.  Values are converted to the encoding by rounding and
+ *  saturating, and booleans are encoded as 0 or 1 and decoded as nonzero.
+ *  Bytes which are not covered by any field are zero.
+ */
+struct packet_layout
+{
+    std::size_t size = 0;
+    std::vector<packet_field> fields;
+};
+
+/**
+ *  Checks that all fields lie within the packet and map variables of
+ *  supported types.
+ *
+ *  \throws std::invalid_argument if not.
+ */
+void validate(const packet_layout& layout);
+
+/// Writes `value` to `packet` as described by `field`.
+void encode(const packet_field& field, double value, char* packet);
+
+/// Reads the value described by `field` from `packet`.
+double decode(const packet_field& field, const char* packet);
+
+} // namespace cosimc
+#endif // header guard
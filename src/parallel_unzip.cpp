@@ -0,0 +1,89 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parallel_unzip.hpp"
+
+#include "thread_pool.hpp"
+
+#include <cosim/utility/zip.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+
+namespace cosimc
+{
+namespace
+{
+
+void extract_entry(
+    const cosim::utility::zip::archive& archive,
+    const std::string& entry,
+    const cosim::filesystem::path& targetDir)
+{
+    const auto index = archive.find_entry(entry);
+    if (index == cosim::utility::zip::invalid_entry_index) {
+        throw std::runtime_error("File not found in archive: " + entry);
+    }
+    // `extract_file_to()` does not recreate the entry's directory.
+    const auto entryDir = targetDir / cosim::filesystem::path(entry).parent_path();
+    cosim::filesystem::create_directories(entryDir);
+    archive.extract_file_to(index, entryDir);
+}
+
+} // namespace
+
+
+void extract_zip_entries(
+    const cosim::filesystem::path& archivePath,
+    const std::vector<std::string>& entries,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount)
+{
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, static_cast<unsigned int>(entries.size()));
+    if (threadCount == 0) return;
+
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&] {
+        const auto archive = cosim::utility::zip::archive(archivePath);
+        for (auto i = next++; i < entries.size(); i = next++) {
+            try {
+                extract_entry(archive, entries[i], targetDir);
+            } catch (...) {
+                next = entries.size();
+                throw;
+            }
+        }
+    };
+
+    thread_pool pool(threadCount);
+    std::vector<std::future<void>> results;
+    for (unsigned int i = 0; i < threadCount; ++i) results.push_back(pool.submit(worker));
+    std::exception_ptr firstError;
+    for (auto& r : results) {
+        try {
+            r.get();
+        } catch (...) {
+            if (!firstError) firstError = std::current_exception();
+        }
+    }
+    if (firstError) std::rethrow_exception(firstError);
+}
+
+std::vector<std::string> list_zip_files(const cosim::filesystem::path& archivePath)
+{
+    const auto archive = cosim::utility::zip::archive(archivePath);
+    std::vector<std::string> files;
+    for (std::uint64_t i = 0; i < archive.entry_count(); ++i) {
+        if (!archive.is_dir_entry(i)) files.push_back(archive.entry_name(i));
+    }
+    return files;
+}
+
+} // namespace cosimc
@@ -0,0 +1,53 @@
+/**
+ *  \file
+ *  \brief Parallel extraction of zip archive entries.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_PARALLEL_UNZIP_HPP
+#define LIBCOSIMC_PARALLEL_UNZIP_HPP
+
+#include <cosim/fs_portability.hpp>
+
+#include <string>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  Extracts the given entries of a zip archive, using several threads.
+ *
+ *  Archive handles must not be shared between threads, so each worker opens
+ *  the archive itself, and then takes entries until none remain.  Entries
+ *  are placed at their archive paths under `targetDir`, creating
+ *  directories as needed.
+ *
+ *  \param archivePath
+ *      The path to the zip archive.
+ *  \param entries
+ *      The names of the file entries to extract.
+ *  \param targetDir
+ *      The directory to extract into.
+ *  \param threadCount
+ *      The most threads to use.  If zero, the number of hardware threads is
+ *      used.
+ *
+ *  \throws std::runtime_error if an entry could not be found or extracted.
+ *      Remaining entries are skipped once an error has occurred.
+ */
+void extract_zip_entries(
+    const cosim::filesystem::path& archivePath,
+    const std::vector<std::string>& entries,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount = 0);
+
+/// Returns the names of all file (not directory) entries in a zip archive.
+std::vector<std::string> list_zip_files(const cosim::filesystem::path& archivePath);
+
+} // namespace cosimc
+#endif // header guard
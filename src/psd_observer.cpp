@@ -0,0 +1,220 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "psd_observer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace cosimc
+{
+
+namespace
+{
+std::vector<double> make_window(window_function window, std::size_t length)
+{
+    // Periodic windows, as is usual for spectral estimation.
+    const double pi = std::acos(-1.0);
+    std::vector<double> w(length, 1.0);
+    for (std::size_t i = 0; i < length; ++i) {
+        const auto c = std::cos(2.0 * pi * static_cast<double>(i) / static_cast<double>(length));
+        switch (window) {
+            case window_function::hann: w[i] = 0.5 - 0.5 * c; break;
+            case window_function::hamming: w[i] = 0.54 - 0.46 * c; break;
+            case window_function::rectangular: break;
+        }
+    }
+    return w;
+}
+} // namespace
+
+
+welch_estimator::welch_estimator(
+    std::size_t segmentLength,
+    std::size_t overlap,
+    window_function window)
+    : plan_(segmentLength)
+    , hop_(segmentLength - overlap)
+    , window_(make_window(window, segmentLength))
+    , buffer_(segmentLength)
+    , scratch_(segmentLength)
+    , sum_(segmentLength / 2 + 1)
+{
+    if (overlap >= segmentLength) {
+        throw std::invalid_argument("The segment overlap must be less than the segment length");
+    }
+    for (const auto w : window_) windowPower_ += w * w;
+}
+
+void welch_estimator::add(double value)
+{
+    buffer_[next_] = value;
+    next_ = (next_ + 1) % buffer_.size();
+    if (filled_ < buffer_.size()) ++filled_;
+    ++sinceSegment_;
+    if (filled_ == buffer_.size() && sinceSegment_ >= hop_) {
+        process_segment();
+        sinceSegment_ = 0;
+    }
+}
+
+void welch_estimator::break_series() noexcept
+{
+    next_ = 0;
+    filled_ = 0;
+    sinceSegment_ = 0;
+}
+
+void welch_estimator::reset() noexcept
+{
+    break_series();
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+    segments_ = 0;
+}
+
+std::vector<double> welch_estimator::psd(double sampleRate) const
+{
+    std::vector<double> result(sum_.size());
+    if (segments_ == 0 || !(sampleRate > 0.0)) return result;
+    const auto scale = 1.0 / (sampleRate * windowPower_ * static_cast<double>(segments_));
+    for (std::size_t k = 0; k < sum_.size(); ++k) {
+        // One-sided: fold in the negative frequencies, which DC and the
+        // Nyquist frequency don't have.
+        const bool edge = (k == 0 || k == sum_.size() - 1);
+        result[k] = sum_[k] * scale * (edge ? 1.0 : 2.0);
+    }
+    return result;
+}
+
+void welch_estimator::process_segment()
+{
+    const auto n = buffer_.size();
+    double mean = 0.0;
+    for (const auto v : buffer_) mean += v;
+    mean /= static_cast<double>(n);
+
+    // The oldest sample is the one about to be overwritten.
+    for (std::size_t i = 0; i < n; ++i) {
+        scratch_[i] = (buffer_[(next_ + i) % n] - mean) * window_[i];
+    }
+    plan_.forward(scratch_.data());
+    for (std::size_t k = 0; k < sum_.size(); ++k) {
+        sum_[k] += std::norm(scratch_[k]);
+    }
+    ++segments_;
+}
+
+
+std::size_t psd_observer::add_variable(
+    cosim::variable_id variable,
+    std::size_t segmentLength,
+    std::size_t overlap,
+    window_function window)
+{
+    if (variable.type == cosim::variable_type::string || variable.type == cosim::variable_type::enumeration) {
+        throw std::invalid_argument("Spectra can only be estimated for real, integer and boolean variables");
+    }
+    entry e{variable, welch_estimator(segmentLength, overlap, window), cosim::duration(0), 0.0};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    expose(e);
+    entries_.push_back(std::move(e));
+    return entries_.size() - 1;
+}
+
+psd_observer::result psd_observer::get(std::size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= entries_.size()) {
+        throw std::out_of_range("Invalid spectrum index: " + std::to_string(index));
+    }
+    const auto& e = entries_[index];
+    result r;
+    r.psd = e.estimator.psd(e.sampleRate);
+    r.frequencies.resize(r.psd.size());
+    const auto binWidth = e.sampleRate / static_cast<double>(2 * (r.psd.size() - 1));
+    for (std::size_t k = 0; k < r.frequencies.size(); ++k) {
+        r.frequencies[k] = static_cast<double>(k) * binWidth;
+    }
+    r.segments = e.estimator.segments();
+    return r;
+}
+
+void psd_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* sim,
+    cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_[index] = sim;
+    for (const auto& e : entries_) {
+        if (e.variable.simulator == index) expose(e);
+    }
+}
+
+void psd_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_.erase(index);
+}
+
+void psd_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void psd_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void psd_observer::simulation_initialized(cosim::step_number, cosim::time_point) { }
+
+void psd_observer::step_complete(cosim::step_number, cosim::duration, cosim::time_point) { }
+
+void psd_observer::simulator_step_complete(
+    cosim::simulator_index index,
+    cosim::step_number,
+    cosim::duration lastStepSize,
+    cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& e : entries_) {
+        if (e.variable.simulator == index) sample(e, lastStepSize);
+    }
+}
+
+void psd_observer::state_restored(cosim::step_number, cosim::time_point)
+{
+    // The series is discontinuous at a restore, so segments must not span it.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& e : entries_) e.estimator.break_series();
+}
+
+void psd_observer::sample(entry& e, cosim::duration stepSize)
+{
+    const auto it = simulators_.find(e.variable.simulator);
+    if (it == simulators_.end()) return;
+    double value = 0.0;
+    switch (e.variable.type) {
+        case cosim::variable_type::real: value = it->second->get_real(e.variable.reference); break;
+        case cosim::variable_type::integer: value = it->second->get_integer(e.variable.reference); break;
+        case cosim::variable_type::boolean: value = it->second->get_boolean(e.variable.reference) ? 1.0 : 0.0; break;
+        default: return;
+    }
+    if (stepSize != e.stepSize) {
+        // The segments so far were sampled at a different rate.
+        if (e.stepSize != cosim::duration(0)) e.estimator.reset();
+        e.stepSize = stepSize;
+        e.sampleRate = 1.0 / std::chrono::duration<double>(stepSize).count();
+    }
+    e.estimator.add(value);
+}
+
+void psd_observer::expose(const entry& e)
+{
+    const auto it = simulators_.find(e.variable.simulator);
+    if (it != simulators_.end()) it->second->expose_for_getting(e.variable.type, e.variable.reference);
+}
+
+} // namespace cosimc
@@ -0,0 +1,170 @@
+/**
+ *  \file
+ *  \brief An observer which estimates power spectral densities while a
+ *  simulation is running.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_PSD_OBSERVER_HPP
+#define LIBCOSIMC_PSD_OBSERVER_HPP
+
+#include "fft.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Window functions for spectral estimation.
+enum class window_function
+{
+    hann,
+    hamming,
+    rectangular,
+};
+
+/**
+ *  An incremental Welch power spectral density estimator.
+ *
+ *  Samples are collected in a ring buffer of one segment.  Whenever
+ *  `segmentLength - overlap` new samples have arrived (and the buffer is
+ *  full), the segment has its mean removed, is windowed and transformed,
+ *  and its periodogram is added to a running sum.  The estimate is the
+ *  average of the periodograms, so memory use and the cost per sample do
+ *  not depend on the length of the series.
+ */
+class welch_estimator
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \throws std::invalid_argument if `segmentLength` is not a power of
+     *      two, or if `overlap` is not less than `segmentLength`.
+     */
+    welch_estimator(std::size_t segmentLength, std::size_t overlap, window_function window);
+
+    /// Adds the next sample.
+    void add(double value);
+
+    /**
+     *  Discards the partial segment, so that no segment spans a
+     *  discontinuity in the series.  Completed segments are kept.
+     */
+    void break_series() noexcept;
+
+    /// Discards all samples and segments, and starts over.
+    void reset() noexcept;
+
+    /// The number of segments which have been averaged.
+    std::uint64_t segments() const noexcept { return segments_; }
+
+    /// The number of frequency bins, `segmentLength / 2 + 1`.
+    std::size_t bin_count() const noexcept { return sum_.size(); }
+
+    /**
+     *  Returns the one-sided power spectral density, in units of the
+     *  variable squared per hertz, for bins `k * sampleRate / segmentLength`.
+     *  All zeros if no segments have been completed.
+     */
+    std::vector<double> psd(double sampleRate) const;
+
+private:
+    void process_segment();
+
+    fft_plan plan_;
+    std::size_t hop_;
+    std::vector<double> window_;
+    double windowPower_ = 0.0;
+    std::vector<double> buffer_;
+    std::size_t next_ = 0;
+    std::size_t filled_ = 0;
+    std::size_t sinceSegment_ = 0;
+    std::vector<std::complex<double>> scratch_;
+    std::vector<double> sum_;
+    std::uint64_t segments_ = 0;
+};
+
+
+/**
+ *  An observer which estimates the power spectral densities of variables
+ *  with Welch's method.
+ *
+ *  A variable is sampled after every step of its simulator, and the
+ *  sample rate is the inverse of the step size.  Segments of different
+ *  sample rates can't be averaged, so if the step size changes, the
+ *  estimate starts over at the new rate.  Real, integer and boolean
+ *  variables are supported.
+ */
+class psd_observer : public cosim::observer
+{
+public:
+    /// A snapshot of a spectral estimate.
+    struct result
+    {
+        std::vector<double> frequencies;
+        std::vector<double> psd;
+        std::uint64_t segments = 0;
+    };
+
+    psd_observer() = default;
+
+    psd_observer(const psd_observer&) = delete;
+    psd_observer& operator=(const psd_observer&) = delete;
+
+    /// Adds a variable to estimate the spectrum of, and returns its index.
+    std::size_t add_variable(
+        cosim::variable_id variable,
+        std::size_t segmentLength,
+        std::size_t overlap,
+        window_function window);
+
+    /**
+     *  Returns the current estimate for a variable.  The frequencies are
+     *  all zero until the variable's simulator has taken a step.  Thread
+     *  safe.
+     */
+    result get(std::size_t index) const;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+private:
+    struct entry
+    {
+        cosim::variable_id variable;
+        welch_estimator estimator;
+        cosim::duration stepSize{0};
+        double sampleRate = 0.0;
+    };
+
+    void sample(entry& e, cosim::duration stepSize);
+    void expose(const entry& e);
+
+    std::unordered_map<cosim::simulator_index, cosim::observable*> simulators_;
+    mutable std::mutex mutex_;
+    std::vector<entry> entries_;
+};
+
+} // namespace cosimc
+#endif // header guard
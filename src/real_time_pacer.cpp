@@ -0,0 +1,242 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "real_time_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+
+namespace cosimc
+{
+namespace
+{
+
+using std::chrono::nanoseconds;
+using steady_clock = std::chrono::steady_clock;
+
+// A step which ends more than this past its target time counts as late.
+constexpr auto lateTolerance = std::chrono::milliseconds(1);
+
+// The longest the pacer sleeps on an external clock before reading it again,
+// which also bounds how long it takes to notice `stop_run()`.
+constexpr auto maxSleepSlice = std::chrono::milliseconds(10);
+
+// The shortest interval over which the clock rate is measured, and the
+// weight of each new measurement in the moving average.
+constexpr auto minRateInterval = std::chrono::milliseconds(1);
+constexpr double rateSmoothing = 0.1;
+
+} // namespace
+
+
+real_time_pacer::real_time_pacer(std::shared_ptr<const cosim::real_time_config> config)
+    : config_(std::move(config))
+{
+}
+
+void real_time_pacer::set_enabled(bool enabled) noexcept
+{
+    if (enabled && !enabled_) anchored_ = false;
+    enabled_ = enabled;
+}
+
+void real_time_pacer::set_clock(clock_function clock)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    clock_ = clock ? std::make_shared<const clock_function>(std::move(clock)) : nullptr;
+}
+
+void real_time_pacer::start_run() noexcept
+{
+    anchored_ = false;
+    running_ = true;
+}
+
+void real_time_pacer::stop_run() noexcept
+{
+    running_ = false;
+}
+
+void real_time_pacer::set_catch_up(const catch_up_settings& settings)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    catchUp_ = settings;
+}
+
+real_time_pacer::statistics real_time_pacer::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void real_time_pacer::simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) { }
+
+void real_time_pacer::simulator_removed(cosim::simulator_index, cosim::time_point) { }
+
+void real_time_pacer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void real_time_pacer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void real_time_pacer::simulation_initialized(cosim::step_number, cosim::time_point) { }
+
+void real_time_pacer::step_complete(cosim::step_number, cosim::duration, cosim::time_point currentTime)
+{
+    if (!enabled_ || !running_) return;
+
+    std::shared_ptr<const clock_function> clock;
+    catch_up_settings catchUp;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clock = clock_;
+        catchUp = catchUp_;
+    }
+    const auto rtf = config_->real_time_factor_target.load();
+    const auto now = read_clock(clock.get());
+
+    if (!anchored_ || clock != anchorClock_ || rtf != anchorRealTimeFactor_) {
+        anchorRealTimeFactor_ = rtf;
+        if (clock != anchorClock_) {
+            clockRate_ = 1.0;
+            rateMeasured_ = false;
+        }
+        anchorClock_ = std::move(clock);
+        lastLocalTime_ = steady_clock::now();
+        lastClockTime_ = now;
+        anchor(now, currentTime);
+        return;
+    }
+
+    if (clock) update_clock_rate(now);
+    const auto target = anchorClockTime_ +
+        std::chrono::duration_cast<nanoseconds>((currentTime - anchorSimulationTime_) / rtf);
+    if (catchUpDelay_ > nanoseconds(0)) {
+        catchUpDelay_ = std::max(catchUpDelay_ - catchUpPerStep_, nanoseconds(0));
+    }
+    const auto pacedTarget = target + catchUpDelay_;
+    const auto end = (now < pacedTarget) ? wait_until(clock.get(), pacedTarget) : now;
+    record_lateness(end - target);
+    catch_up(catchUp, end - target, end - pacedTarget, end, currentTime);
+}
+
+void real_time_pacer::simulator_step_complete(
+    cosim::simulator_index,
+    cosim::step_number,
+    cosim::duration,
+    cosim::time_point)
+{
+}
+
+void real_time_pacer::state_restored(cosim::step_number, cosim::time_point)
+{
+    anchored_ = false;
+}
+
+// Makes the given simulation time correspond to the given clock time.
+void real_time_pacer::anchor(nanoseconds clockTime, cosim::time_point simulationTime)
+{
+    anchorClockTime_ = clockTime;
+    anchorSimulationTime_ = simulationTime;
+    consecutiveLateSteps_ = 0;
+    catchUpDelay_ = nanoseconds(0);
+    anchored_ = true;
+}
+
+// Applies the catch-up policy after a step.  `lateness` is measured against
+// the step's target time, and `excess` against the time the step was paced
+// to, which is later while the `slow_down` policy is catching up.
+void real_time_pacer::catch_up(
+    const catch_up_settings& settings,
+    nanoseconds lateness,
+    nanoseconds excess,
+    nanoseconds clockTime,
+    cosim::time_point simulationTime)
+{
+    if (excess <= lateTolerance) {
+        consecutiveLateSteps_ = 0;
+        return;
+    }
+    ++consecutiveLateSteps_;
+
+    bool reanchor = settings.maxLateness > nanoseconds(0) && lateness > settings.maxLateness;
+    switch (settings.policy) {
+        case catch_up_policy::burst:
+            reanchor = reanchor || (settings.maxSteps > 0 && consecutiveLateSteps_ > settings.maxSteps);
+            break;
+        case catch_up_policy::reanchor:
+            reanchor = true;
+            break;
+        case catch_up_policy::slow_down:
+            if (!reanchor) {
+                catchUpDelay_ += excess;
+                catchUpPerStep_ = catchUpDelay_ / std::max(settings.maxSteps, 1);
+            }
+            break;
+    }
+    if (reanchor) {
+        anchor(clockTime, simulationTime);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.reanchors;
+    }
+}
+
+nanoseconds real_time_pacer::read_clock(const clock_function* clock) const
+{
+    if (clock) return (*clock)();
+    return std::chrono::duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
+}
+
+// Updates the estimated rate of an external clock relative to the local
+// one, from the readings at the end of the previous step and this one.
+void real_time_pacer::update_clock_rate(nanoseconds clockTime)
+{
+    const auto localTime = steady_clock::now();
+    const auto localElapsed = localTime - lastLocalTime_;
+    if (localElapsed < minRateInterval) return;
+    const auto rate = std::chrono::duration<double>(clockTime - lastClockTime_) /
+        std::chrono::duration<double>(localElapsed);
+    // Clocks which jump or stand still would make the estimate useless.
+    if (std::isfinite(rate) && rate > 0.0) {
+        const auto clamped = std::clamp(rate, 0.1, 10.0);
+        clockRate_ = rateMeasured_ ? clockRate_ + rateSmoothing * (clamped - clockRate_) : clamped;
+        rateMeasured_ = true;
+    }
+    lastLocalTime_ = localTime;
+    lastClockTime_ = clockTime;
+}
+
+// Waits until `target` on the given clock, and returns the time at which the
+// wait ended.
+nanoseconds real_time_pacer::wait_until(const clock_function* clock, nanoseconds target)
+{
+    auto now = read_clock(clock);
+    while (now < target && running_) {
+        if (clock) {
+            const auto localWait = std::chrono::duration<double, std::nano>((target - now).count() / clockRate_);
+            std::this_thread::sleep_for(std::min(
+                std::chrono::duration_cast<nanoseconds>(localWait) + nanoseconds(1),
+                nanoseconds(maxSleepSlice)));
+        } else {
+            std::this_thread::sleep_for(target - now);
+        }
+        now = read_clock(clock);
+    }
+    return now;
+}
+
+void real_time_pacer::record_lateness(nanoseconds lateness)
+{
+    totalLateness_ += lateness;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.pacedSteps;
+    if (lateness > lateTolerance) ++stats_.lateSteps;
+    stats_.lastLateness = lateness;
+    stats_.maxLateness = (stats_.pacedSteps == 1) ? lateness : std::max(stats_.maxLateness, lateness);
+    stats_.meanLateness = totalLateness_ / static_cast<std::int64_t>(stats_.pacedSteps);
+    stats_.clockRate = clockRate_;
+}
+
+} // namespace cosimc
@@ -0,0 +1,187 @@
+/**
+ *  \file
+ *  \brief Real-time pacing against a local or external clock.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_REAL_TIME_PACER_HPP
+#define LIBCOSIMC_REAL_TIME_PACER_HPP
+
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+#include <cosim/timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+
+namespace cosimc
+{
+
+/**
+ *  An observer which paces a running simulation to real time.
+ *
+ *  This replaces the pacing done by `cosim::execution`, which only knows the
+ *  local steady clock.  After each step, the pacer waits until the clock
+ *  has reached the time at which the step should end, i.e., the time at
+ *  which pacing started plus the simulated time since then, divided by the
+ *  real time factor target.
+ *
+ *  The clock may be an external one, e.g. the timebase of another real-time
+ *  system.  Since the pacer can only sleep on the local clock, it estimates
+ *  the rate of the external clock relative to the local one from
+ *  consecutive readings, and uses this to convert the remaining wait into a
+ *  local sleep.  It then reads the external clock again, and repeats until
+ *  the target time has been reached.  Drift between the clocks is thus
+ *  corrected at every step, and the simulation stays locked to the external
+ *  timebase.
+ *
+ *  For each paced step, the pacer records the *lateness*, i.e., how far
+ *  past its target time the step ended, as read on the clock after any
+ *  wait.  How the simulation recovers from lateness, e.g. after a stall in
+ *  the host process or a slow model, is determined by the catch-up policy
+ *  (see `catch_up_policy`).
+ *
+ *  Pacing is only done between `start_run()` and `stop_run()`, and it is
+ *  restarted whenever the real time factor target or the clock changes.
+ */
+class real_time_pacer : public cosim::observer
+{
+public:
+    /// A clock, which returns the time since an arbitrary epoch.
+    using clock_function = std::function<std::chrono::nanoseconds()>;
+
+    /// How the pacer recovers when steps end later than their target time.
+    enum class catch_up_policy
+    {
+        /**
+         *  Late steps are not waited for, so the following steps are run
+         *  back to back until the simulation has caught up.  If it is still
+         *  late after `maxSteps` such steps, pacing is re-anchored.
+         *  Zero means no limit.
+         */
+        burst,
+
+        /**
+         *  Pacing is re-anchored at the end of every late step, so lateness
+         *  is never made up for and the simulation falls permanently behind
+         *  by the length of the stall.
+         */
+        reanchor,
+
+        /**
+         *  The lateness is made up for gradually, by shortening each of the
+         *  following `maxSteps` steps by an equal part of it.  This bounds
+         *  how much faster than the real time factor target the simulation
+         *  runs while catching up.
+         */
+        slow_down,
+    };
+
+    /// Catch-up settings.
+    struct catch_up_settings
+    {
+        catch_up_policy policy = catch_up_policy::burst;
+        int maxSteps = 0;
+        /// Lateness beyond which pacing is always re-anchored.  Zero means no limit.
+        std::chrono::nanoseconds maxLateness{0};
+    };
+
+    /// Lateness statistics.
+    struct statistics
+    {
+        std::uint64_t pacedSteps = 0;
+        std::uint64_t lateSteps = 0;
+        /// The number of times pacing has been re-anchored to recover from lateness.
+        std::uint64_t reanchors = 0;
+        std::chrono::nanoseconds lastLateness{0};
+        std::chrono::nanoseconds maxLateness{0};
+        std::chrono::nanoseconds meanLateness{0};
+        /// The estimated rate of the clock relative to the local steady clock.
+        double clockRate = 1.0;
+    };
+
+    /// Constructor.  The real time factor target is read from `config`.
+    explicit real_time_pacer(std::shared_ptr<const cosim::real_time_config> config);
+
+    real_time_pacer(const real_time_pacer&) = delete;
+    real_time_pacer& operator=(const real_time_pacer&) = delete;
+
+    /// Enables or disables pacing.
+    void set_enabled(bool enabled) noexcept;
+
+    /// Returns whether pacing is enabled.
+    bool enabled() const noexcept { return enabled_; }
+
+    /// Sets the clock to pace against, or the local steady clock if empty.
+    void set_clock(clock_function clock);
+
+    /// Sets the catch-up settings.
+    void set_catch_up(const catch_up_settings& settings);
+
+    /// Starts pacing from the end of the next step.
+    void start_run() noexcept;
+
+    /// Stops pacing, and interrupts any ongoing wait.
+    void stop_run() noexcept;
+
+    /// Returns the lateness statistics.  Thread safe.
+    statistics stats() const;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+private:
+    std::chrono::nanoseconds read_clock(const clock_function* clock) const;
+    void update_clock_rate(std::chrono::nanoseconds clockTime);
+    std::chrono::nanoseconds wait_until(const clock_function* clock, std::chrono::nanoseconds target);
+    void anchor(std::chrono::nanoseconds clockTime, cosim::time_point simulationTime);
+    void catch_up(
+        const catch_up_settings& settings,
+        std::chrono::nanoseconds lateness,
+        std::chrono::nanoseconds excess,
+        std::chrono::nanoseconds clockTime,
+        cosim::time_point simulationTime);
+    void record_lateness(std::chrono::nanoseconds lateness);
+
+    std::shared_ptr<const cosim::real_time_config> config_;
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<bool> anchored_{false};
+
+    // Only used on the stepping thread.
+    std::chrono::nanoseconds anchorClockTime_{0};
+    cosim::time_point anchorSimulationTime_;
+    double anchorRealTimeFactor_ = 1.0;
+    std::shared_ptr<const clock_function> anchorClock_;
+    std::chrono::steady_clock::time_point lastLocalTime_;
+    std::chrono::nanoseconds lastClockTime_{0};
+    double clockRate_ = 1.0;
+    bool rateMeasured_ = false;
+    std::chrono::nanoseconds totalLateness_{0};
+    int consecutiveLateSteps_ = 0;
+    std::chrono::nanoseconds catchUpDelay_{0};
+    std::chrono::nanoseconds catchUpPerStep_{0};
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const clock_function> clock_; // Null for the steady clock
+    catch_up_settings catchUp_;
+    statistics stats_;
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,368 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "replaceable_slave.hpp"
+
+#include <cosim/error.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+namespace cosimc
+{
+namespace
+{
+
+using vr_span = gsl::span<const cosim::value_reference>;
+
+void get_values(const cosim::slave& s, vr_span variables, gsl::span<double> values)
+{
+    s.get_real_variables(variables, values);
+}
+
+void get_values(const cosim::slave& s, vr_span variables, gsl::span<int> values)
+{
+    s.get_integer_variables(variables, values);
+}
+
+void get_values(const cosim::slave& s, vr_span variables, gsl::span<bool> values)
+{
+    s.get_boolean_variables(variables, values);
+}
+
+void get_values(const cosim::slave& s, vr_span variables, gsl::span<std::string> values)
+{
+    s.get_string_variables(variables, values);
+}
+
+void set_values(cosim::slave& s, vr_span variables, gsl::span<const double> values)
+{
+    s.set_real_variables(variables, values);
+}
+
+void set_values(cosim::slave& s, vr_span variables, gsl::span<const int> values)
+{
+    s.set_integer_variables(variables, values);
+}
+
+void set_values(cosim::slave& s, vr_span variables, gsl::span<const bool> values)
+{
+    s.set_boolean_variables(variables, values);
+}
+
+void set_values(cosim::slave& s, vr_span variables, gsl::span<const std::string> values)
+{
+    s.set_string_variables(variables, values);
+}
+
+bool is_settable(const cosim::variable_description& v)
+{
+    return v.variability != cosim::variable_variability::constant &&
+        (v.causality == cosim::variable_causality::input ||
+            v.causality == cosim::variable_causality::parameter);
+}
+
+} // namespace
+
+
+replaceable_slave::replaceable_slave(std::shared_ptr<cosim::slave> instance)
+    : instance_(std::move(instance))
+    , modelDescription_(instance_->model_description())
+{
+}
+
+void replaceable_slave::replace(
+    std::shared_ptr<cosim::slave> instance,
+    cosim::time_point currentTime,
+    state_transfer_function transfer)
+{
+    const auto newDescription = instance->model_description();
+    std::unordered_map<std::string, const cosim::variable_description*> byName;
+    for (const auto& v : newDescription.variables) byName.emplace(v.name, &v);
+
+    const auto replacement_for = [&](const cosim::variable_description& v) {
+        const auto it = byName.find(v.name);
+        if (it != byName.end() && it->second->type == v.type) return it->second;
+        if (v.causality == cosim::variable_causality::input ||
+            v.causality == cosim::variable_causality::output) {
+            throw std::invalid_argument(
+                "The replacement for model '" + modelDescription_.name +
+                "' has no variable named '" + v.name + "' of the same type");
+        }
+        return static_cast<const cosim::variable_description*>(nullptr);
+    };
+
+    variable_map<double> reals;
+    variable_map<int> integers;
+    variable_map<bool> booleans;
+    variable_map<std::string> strings;
+    for (const auto& v : modelDescription_.variables) {
+        const auto r = replacement_for(v);
+        switch (v.type) {
+            case cosim::variable_type::real: map_variable(reals_, reals, v, r); break;
+            case cosim::variable_type::integer: map_variable(integers_, integers, v, r); break;
+            case cosim::variable_type::boolean: map_variable(booleans_, booleans, v, r); break;
+            case cosim::variable_type::string: map_variable(strings_, strings, v, r); break;
+            default: break;
+        }
+    }
+
+    if (setUp_) {
+        instance->setup(currentTime, stopTime_, relativeTolerance_);
+        for (const auto& v : modelDescription_.variables) {
+            const auto r = replacement_for(v);
+            if (!r || !is_settable(*r)) continue;
+            switch (v.type) {
+                case cosim::variable_type::real: copy_variable(reals_, v, *r, *instance); break;
+                case cosim::variable_type::integer: copy_variable(integers_, v, *r, *instance); break;
+                case cosim::variable_type::boolean: copy_variable(booleans_, v, *r, *instance); break;
+                case cosim::variable_type::string: copy_variable(strings_, v, *r, *instance); break;
+                default: break;
+            }
+        }
+        if (transfer) transfer(*instance_, *instance);
+        if (started_) instance->start_simulation();
+    }
+
+    const auto old = std::exchange(instance_, std::move(instance));
+    reals_ = std::move(reals);
+    integers_ = std::move(integers);
+    booleans_ = std::move(booleans);
+    strings_ = std::move(strings);
+    replaced_ = true;
+    states_.clear();
+
+    if (started_) {
+        // The old slave is discarded regardless, so a failure to end its
+        // simulation cleanly is of no consequence.
+        try {
+            old->end_simulation();
+        } catch (...) {
+        }
+    }
+}
+
+cosim::model_description replaceable_slave::model_description() const
+{
+    return modelDescription_;
+}
+
+void replaceable_slave::setup(
+    cosim::time_point startTime,
+    std::optional<cosim::time_point> stopTime,
+    std::optional<double> relativeTolerance)
+{
+    instance_->setup(startTime, stopTime, relativeTolerance);
+    setUp_ = true;
+    stopTime_ = stopTime;
+    relativeTolerance_ = relativeTolerance;
+}
+
+void replaceable_slave::start_simulation()
+{
+    instance_->start_simulation();
+    started_ = true;
+}
+
+void replaceable_slave::end_simulation()
+{
+    started_ = false;
+    instance_->end_simulation();
+}
+
+cosim::step_result replaceable_slave::do_step(cosim::time_point currentT, cosim::duration deltaT)
+{
+    return instance_->do_step(currentT, deltaT);
+}
+
+void replaceable_slave::get_real_variables(vr_span variables, gsl::span<double> values) const
+{
+    get(reals_, variables, values);
+}
+
+void replaceable_slave::get_integer_variables(vr_span variables, gsl::span<int> values) const
+{
+    get(integers_, variables, values);
+}
+
+void replaceable_slave::get_boolean_variables(vr_span variables, gsl::span<bool> values) const
+{
+    get(booleans_, variables, values);
+}
+
+void replaceable_slave::get_string_variables(vr_span variables, gsl::span<std::string> values) const
+{
+    get(strings_, variables, values);
+}
+
+void replaceable_slave::set_real_variables(vr_span variables, gsl::span<const double> values)
+{
+    set(reals_, variables, values);
+}
+
+void replaceable_slave::set_integer_variables(vr_span variables, gsl::span<const int> values)
+{
+    set(integers_, variables, values);
+}
+
+void replaceable_slave::set_boolean_variables(vr_span variables, gsl::span<const bool> values)
+{
+    set(booleans_, variables, values);
+}
+
+void replaceable_slave::set_string_variables(vr_span variables, gsl::span<const std::string> values)
+{
+    set(strings_, variables, values);
+}
+
+cosim::state_index replaceable_slave::save_state()
+{
+    const auto stateIndex = instance_->save_state();
+    states_.insert(stateIndex);
+    return stateIndex;
+}
+
+void replaceable_slave::save_state(cosim::state_index stateIndex)
+{
+    check_state(stateIndex);
+    instance_->save_state(stateIndex);
+}
+
+void replaceable_slave::restore_state(cosim::state_index stateIndex)
+{
+    check_state(stateIndex);
+    instance_->restore_state(stateIndex);
+}
+
+void replaceable_slave::release_state(cosim::state_index stateIndex)
+{
+    check_state(stateIndex);
+    instance_->release_state(stateIndex);
+    states_.erase(stateIndex);
+}
+
+cosim::serialization::node replaceable_slave::export_state(cosim::state_index stateIndex) const
+{
+    check_state(stateIndex);
+    return instance_->export_state(stateIndex);
+}
+
+cosim::state_index replaceable_slave::import_state(const cosim::serialization::node& exportedState)
+{
+    const auto stateIndex = instance_->import_state(exportedState);
+    states_.insert(stateIndex);
+    return stateIndex;
+}
+
+template<typename T>
+void replaceable_slave::map_variable(
+    const variable_map<T>& currentMap,
+    variable_map<T>& newMap,
+    const cosim::variable_description& original,
+    const cosim::variable_description* replacement) const
+{
+    if (replacement) {
+        newMap.mapped.emplace(original.reference, replacement->reference);
+        return;
+    }
+    T value{};
+    if (setUp_) {
+        get(currentMap, vr_span(&original.reference, 1), gsl::span<T>(&value, 1));
+    } else if (original.start) {
+        if (const auto start = std::get_if<T>(&*original.start)) value = *start;
+    }
+    newMap.held.emplace(original.reference, std::move(value));
+}
+
+template<typename T>
+void replaceable_slave::copy_variable(
+    const variable_map<T>& currentMap,
+    const cosim::variable_description& original,
+    const cosim::variable_description& replacement,
+    cosim::slave& to) const
+{
+    T value{};
+    get(currentMap, vr_span(&original.reference, 1), gsl::span<T>(&value, 1));
+    set_values(to, vr_span(&replacement.reference, 1), gsl::span<const T>(&value, 1));
+}
+
+template<typename T>
+void replaceable_slave::translate(
+    const variable_map<T>& map,
+    vr_span variables,
+    translation<T>& result)
+{
+    if (std::equal(variables.begin(), variables.end(), result.variables.begin(), result.variables.end())) {
+        return;
+    }
+    translation<T> t;
+    t.variables.assign(variables.begin(), variables.end());
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        if (const auto m = map.mapped.find(variables[i]); m != map.mapped.end()) {
+            t.references.push_back(m->second);
+            t.positions.push_back(i);
+        } else if (const auto h = map.held.find(variables[i]); h != map.held.end()) {
+            t.held.emplace_back(i, &h->second);
+        } else {
+            throw std::out_of_range("Invalid value reference: " + std::to_string(variables[i]));
+        }
+    }
+    t.buffer = std::make_unique<T[]>(t.references.size());
+    result = std::move(t);
+}
+
+template<typename T>
+void replaceable_slave::get(
+    const variable_map<T>& map,
+    vr_span variables,
+    gsl::span<T> values) const
+{
+    if (!replaced_) {
+        get_values(*instance_, variables, values);
+        return;
+    }
+    auto& t = map.getTranslation;
+    translate(map, variables, t);
+    for (const auto& [i, value] : t.held) values[i] = *value;
+    if (t.references.empty()) return;
+    get_values(*instance_, t.references, gsl::span<T>(t.buffer.get(), t.references.size()));
+    for (std::size_t k = 0; k < t.positions.size(); ++k) {
+        values[t.positions[k]] = std::move(t.buffer[k]);
+    }
+}
+
+template<typename T>
+void replaceable_slave::set(
+    variable_map<T>& map,
+    vr_span variables,
+    gsl::span<const T> values)
+{
+    if (!replaced_) {
+        set_values(*instance_, variables, values);
+        return;
+    }
+    auto& t = map.setTranslation;
+    translate(map, variables, t);
+    if (t.references.empty()) return;
+    for (std::size_t k = 0; k < t.positions.size(); ++k) {
+        t.buffer[k] = values[t.positions[k]];
+    }
+    set_values(*instance_, t.references, gsl::span<const T>(t.buffer.get(), t.references.size()));
+}
+
+void replaceable_slave::check_state(cosim::state_index stateIndex) const
+{
+    if (!states_.count(stateIndex)) {
+        throw cosim::error(
+            cosim::make_error_code(cosim::errc::unsupported_feature),
+            "Unknown state index, or the state was saved before the slave was replaced");
+    }
+}
+
+} // namespace cosimc
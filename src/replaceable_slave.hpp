@@ -0,0 +1,188 @@
+/**
+ *  \file
+ *  \brief A slave which can be replaced by another one while a simulation
+ *  is in progress.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_REPLACEABLE_SLAVE_HPP
+#define LIBCOSIMC_REPLACEABLE_SLAVE_HPP
+
+#include <cosim/model_description.hpp>
+#include <cosim/serialization.hpp>
+#include <cosim/slave.hpp>
+#include <cosim/time.hpp>
+
+#include <gsl/span>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A slave which forwards all calls to another slave, and which allows that
+ *  slave to be replaced by a different one, typically a surrogate model,
+ *  between time steps.
+ *
+ *  To the rest of the simulation, the slave keeps the model description of
+ *  the slave it was created with, so that connections and observers, which
+ *  refer to variables by value reference, are unaffected by a replacement.
+ *  Instead, the variables of the original model are mapped to the variables
+ *  of the replacement which have the same names and types.  All inputs and
+ *  outputs of the original model must exist in the replacement.  Other
+ *  variables which are missing in the replacement keep the last values they
+ *  had before the replacement, and setting them has no effect.
+ *
+ *  States saved before a replacement cannot be restored afterwards.
+ */
+class replaceable_slave : public cosim::slave
+{
+public:
+    /**
+     *  A function which copies the state of a slave which is being replaced
+     *  to its replacement.
+     *
+     *  The old slave is still simulating.  The new slave has been set up to
+     *  start at the current time, and is in initialisation mode, so
+     *  parameters and start values of states can be set.
+     */
+    using state_transfer_function = std::function<void(cosim::slave& from, cosim::slave& to)>;
+
+    explicit replaceable_slave(std::shared_ptr<cosim::slave> instance);
+
+    replaceable_slave(const replaceable_slave&) = delete;
+    replaceable_slave& operator=(const replaceable_slave&) = delete;
+
+    /**
+     *  Replaces the slave.
+     *
+     *  If the simulation has been set up, the new slave is set up to start
+     *  at `currentTime`.  Then, the values of all variables which are
+     *  inputs or non-constant parameters in the new slave are copied from
+     *  the old one, after which `transfer`, if given, is called.  Finally,
+     *  the old slave's simulation is ended, and the new one's is started.
+     *
+     *  Must not be called while a step is in progress.  If an exception is
+     *  thrown, the old slave is kept.
+     */
+    void replace(
+        std::shared_ptr<cosim::slave> instance,
+        cosim::time_point currentTime,
+        state_transfer_function transfer = nullptr);
+
+    /// Returns the slave which calls are currently forwarded to.
+    std::shared_ptr<cosim::slave> instance() const noexcept { return instance_; }
+
+    // cosim::slave methods
+    cosim::model_description model_description() const override;
+    void setup(
+        cosim::time_point startTime,
+        std::optional<cosim::time_point> stopTime,
+        std::optional<double> relativeTolerance) override;
+    void start_simulation() override;
+    void end_simulation() override;
+    cosim::step_result do_step(cosim::time_point currentT, cosim::duration deltaT) override;
+    void get_real_variables(gsl::span<const cosim::value_reference> variables, gsl::span<double> values) const override;
+    void get_integer_variables(gsl::span<const cosim::value_reference> variables, gsl::span<int> values) const override;
+    void get_boolean_variables(gsl::span<const cosim::value_reference> variables, gsl::span<bool> values) const override;
+    void get_string_variables(gsl::span<const cosim::value_reference> variables, gsl::span<std::string> values) const override;
+    void set_real_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const double> values) override;
+    void set_integer_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const int> values) override;
+    void set_boolean_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const bool> values) override;
+    void set_string_variables(gsl::span<const cosim::value_reference> variables, gsl::span<const std::string> values) override;
+    cosim::state_index save_state() override;
+    void save_state(cosim::state_index stateIndex) override;
+    void restore_state(cosim::state_index stateIndex) override;
+    void release_state(cosim::state_index stateIndex) override;
+    cosim::serialization::node export_state(cosim::state_index stateIndex) const override;
+    cosim::state_index import_state(const cosim::serialization::node& exportedState) override;
+
+private:
+    // The translation of a list of the original model's variables to the
+    // replacement's, which is kept for as long as the same list is used, so
+    // that the calls of each step neither look up nor allocate anything.
+    template<typename T>
+    struct translation
+    {
+        std::vector<cosim::value_reference> variables;
+        std::vector<cosim::value_reference> references; // Of the mapped variables
+        std::vector<std::size_t> positions; // Of the mapped variables in `variables`
+        std::vector<std::pair<std::size_t, const T*>> held;
+        std::unique_ptr<T[]> buffer; // For the values of the mapped variables
+    };
+
+    // The mapping of the original model's variables of one type.
+    template<typename T>
+    struct variable_map
+    {
+        std::unordered_map<cosim::value_reference, cosim::value_reference> mapped;
+        std::unordered_map<cosim::value_reference, T> held;
+        mutable translation<T> getTranslation;
+        translation<T> setTranslation;
+    };
+
+    template<typename T>
+    void map_variable(
+        const variable_map<T>& currentMap,
+        variable_map<T>& newMap,
+        const cosim::variable_description& original,
+        const cosim::variable_description* replacement) const;
+
+    template<typename T>
+    void copy_variable(
+        const variable_map<T>& currentMap,
+        const cosim::variable_description& original,
+        const cosim::variable_description& replacement,
+        cosim::slave& to) const;
+
+    template<typename T>
+    static void translate(
+        const variable_map<T>& map,
+        gsl::span<const cosim::value_reference> variables,
+        translation<T>& result);
+
+    template<typename T>
+    void get(
+        const variable_map<T>& map,
+        gsl::span<const cosim::value_reference> variables,
+        gsl::span<T> values) const;
+
+    template<typename T>
+    void set(
+        variable_map<T>& map,
+        gsl::span<const cosim::value_reference> variables,
+        gsl::span<const T> values);
+
+    void check_state(cosim::state_index stateIndex) const;
+
+    std::shared_ptr<cosim::slave> instance_;
+    const cosim::model_description modelDescription_;
+    bool replaced_ = false;
+
+    variable_map<double> reals_;
+    variable_map<int> integers_;
+    variable_map<bool> booleans_;
+    variable_map<std::string> strings_;
+
+    bool setUp_ = false;
+    bool started_ = false;
+    std::optional<cosim::time_point> stopTime_;
+    std::optional<double> relativeTolerance_;
+    std::unordered_set<cosim::state_index> states_;
+};
+
+} // namespace cosimc
+#endif // header guard
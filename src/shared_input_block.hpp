@@ -0,0 +1,160 @@
+/**
+ *  \file
+ *  \brief The layout of the shared-memory input channel, and its seqlock.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_SHARED_INPUT_BLOCK_HPP
+#define LIBCOSIMC_SHARED_INPUT_BLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+
+namespace cosimc
+{
+
+/**
+ *  A view of an array of real values in shared memory, guarded by a seqlock.
+ *
+ *  The block starts with a header which holds a magic number, a layout
+ *  version, the number of values and a sequence counter, followed by the
+ *  values themselves on the next cache line.  The sequence counter is odd
+ *  while a write is in progress, and is advanced by two for every completed
+ *  write.  Readers never block writers: they copy the values, and retry if
+ *  the counter was odd or changed in the meantime.
+ *
+ *  Writers serialise among themselves by moving the counter from even to
+ *  odd with a CAS, so several writers may share a block, but a writer which
+ *  dies in the middle of a write leaves the block permanently locked.
+ */
+class shared_input_block
+{
+public:
+    /// Returns the number of bytes needed for a block of `count` values.
+    static std::size_t required_size(std::size_t count) noexcept
+    {
+        return sizeof(header) + count * sizeof(std::atomic<double>);
+    }
+
+    /// Lays out a new block, with all values zero, in `memory`.
+    static shared_input_block initialize(void* memory, std::size_t count)
+    {
+        const auto h = new (memory) header;
+        h->version = layoutVersion;
+        h->count = count;
+        h->sequence.store(0, std::memory_order_relaxed);
+        const auto v = reinterpret_cast<std::atomic<double>*>(h + 1);
+        for (std::size_t i = 0; i < count; ++i) new (v + i) std::atomic<double>(0.0);
+        std::atomic_thread_fence(std::memory_order_release);
+        h->magic = magicNumber;
+        return shared_input_block(h);
+    }
+
+    /**
+     *  Attaches to a block which has been laid out by `initialize()`.
+     *
+     *  \throws std::runtime_error if `memory` doesn't hold a valid block.
+     */
+    static shared_input_block attach(void* memory, std::size_t size)
+    {
+        const auto h = static_cast<header*>(memory);
+        if (size < sizeof(header) || h->magic != magicNumber) {
+            throw std::runtime_error("Not a cosim shared-memory input block");
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (h->version != layoutVersion) {
+            throw std::runtime_error("Unsupported shared-memory input block version");
+        }
+        if (size < required_size(static_cast<std::size_t>(h->count))) {
+            throw std::runtime_error("Shared-memory input block is truncated");
+        }
+        return shared_input_block(h);
+    }
+
+    /// Returns the number of values in the block.
+    std::size_t size() const noexcept { return static_cast<std::size_t>(header_->count); }
+
+    /// Writes `n` values, starting at position `offset`, in one update.
+    void write(std::size_t offset, const double* values, std::size_t n) noexcept
+    {
+        auto& sequence = header_->sequence;
+        auto s = sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if (s & 1) {
+                s = sequence.load(std::memory_order_relaxed);
+            } else if (sequence.compare_exchange_weak(s, s + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        const auto v = this->values();
+        for (std::size_t i = 0; i < n; ++i) {
+            v[offset + i].store(values[i], std::memory_order_relaxed);
+        }
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     *  Copies all values to `values`, which must have room for `size()`
+     *  elements, and stores the sequence number of the copy in `sequence`.
+     *
+     *  Returns false if no consistent copy could be made in `maxAttempts`
+     *  attempts, because writes were in progress.
+     */
+    bool try_read(double* values, std::uint64_t& sequence, int maxAttempts) const noexcept
+    {
+        const auto v = this->values();
+        const auto n = size();
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            const auto before = header_->sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (std::size_t i = 0; i < n; ++i) {
+                values[i] = v[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header_->sequence.load(std::memory_order_relaxed) == before) {
+                sequence = before;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::uint32_t magicNumber = 0x4d485343; // "CSHM"
+    static constexpr std::uint32_t layoutVersion = 1;
+
+    struct header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t count;
+        // On a cache line of its own, since it is written on every update.
+        alignas(64) std::atomic<std::uint64_t> sequence;
+    };
+    static_assert(sizeof(header) % alignof(std::atomic<double>) == 0);
+    // Atomics which use locks don't work across processes.
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<double>::is_always_lock_free);
+
+    explicit shared_input_block(header* h) noexcept
+        : header_(h)
+    { }
+
+    std::atomic<double>* values() const noexcept
+    {
+        return reinterpret_cast<std::atomic<double>*>(header_ + 1);
+    }
+
+    header* header_;
+};
+
+} // namespace cosimc
+#endif // header guard
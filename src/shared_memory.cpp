@@ -0,0 +1,156 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(_WIN32) && !defined(NOMINMAX)
+#    define NOMINMAX
+#endif
+
+#include "shared_memory.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+
+namespace cosimc
+{
+
+#ifdef _WIN32
+
+shared_memory::shared_memory(const std::string& name, std::size_t size)
+    : name_(name)
+    , owner_(true)
+    , size_(size)
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " shared memory segment '" + name_ + "'");
+    };
+
+    const auto size64 = static_cast<std::uint64_t>(size);
+    mappingHandle_ = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(size64 >> 32),
+        static_cast<DWORD>(size64 & 0xFFFFFFFF),
+        name_.c_str());
+    if (!mappingHandle_) fail("Failed to create");
+    data_ = MapViewOfFile(mappingHandle_, FILE_MAP_ALL_ACCESS, 0, 0, size_);
+    if (!data_) fail("Failed to map");
+}
+
+shared_memory::shared_memory(const std::string& name)
+    : name_(name)
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " shared memory segment '" + name_ + "'");
+    };
+
+    mappingHandle_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+    if (!mappingHandle_) fail("Failed to open");
+    data_ = MapViewOfFile(mappingHandle_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!data_) fail("Failed to map");
+    MEMORY_BASIC_INFORMATION info;
+    if (!VirtualQuery(data_, &info, sizeof info)) fail("Failed to determine size of");
+    size_ = static_cast<std::size_t>(info.RegionSize);
+}
+
+shared_memory::~shared_memory() noexcept
+{
+    unmap();
+}
+
+void shared_memory::unmap() noexcept
+{
+    // The mapping object goes away with its last handle.
+    if (data_) UnmapViewOfFile(data_);
+    if (mappingHandle_) CloseHandle(mappingHandle_);
+    data_ = nullptr;
+    mappingHandle_ = nullptr;
+}
+
+#else
+
+namespace
+{
+std::string posix_name(const std::string& name)
+{
+    return (!name.empty() && name.front() == '/') ? name : '/' + name;
+}
+} // namespace
+
+shared_memory::shared_memory(const std::string& name, std::size_t size)
+    : name_(posix_name(name))
+    , size_(size)
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(errno, std::generic_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " shared memory segment '" + name_ + "'");
+    };
+
+    ::shm_unlink(name_.c_str());
+    fd_ = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd_ < 0) fail("Failed to create");
+    owner_ = true;
+    if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0) fail("Failed to resize");
+    void* addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) fail("Failed to map");
+    data_ = addr;
+}
+
+shared_memory::shared_memory(const std::string& name)
+    : name_(posix_name(name))
+{
+    const auto fail = [&](const char* what) {
+        const auto ec = std::error_code(errno, std::generic_category());
+        unmap();
+        throw std::system_error(ec, std::string(what) + " shared memory segment '" + name_ + "'");
+    };
+
+    fd_ = ::shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd_ < 0) fail("Failed to open");
+    struct stat status;
+    if (::fstat(fd_, &status) != 0) fail("Failed to determine size of");
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ == 0) return;
+    void* addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) fail("Failed to map");
+    data_ = addr;
+}
+
+shared_memory::~shared_memory() noexcept
+{
+    unmap();
+}
+
+void shared_memory::unmap() noexcept
+{
+    if (data_) ::munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+    if (owner_) ::shm_unlink(name_.c_str());
+    data_ = nullptr;
+    fd_ = -1;
+    owner_ = false;
+}
+
+#endif
+
+} // namespace cosimc
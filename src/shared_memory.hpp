@@ -0,0 +1,76 @@
+/**
+ *  \file
+ *  \brief Named shared-memory segments.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_SHARED_MEMORY_HPP
+#define LIBCOSIMC_SHARED_MEMORY_HPP
+
+#include <cstddef>
+#include <string>
+
+
+namespace cosimc
+{
+
+/**
+ *  A read-write mapping of a named shared-memory segment.
+ *
+ *  On POSIX systems this is a `shm_open()` object, whose name is prefixed
+ *  with a slash if it doesn't already start with one.  On Windows it is a
+ *  named file mapping backed by the paging file.
+ */
+class shared_memory
+{
+public:
+    /**
+     *  Creates a new segment of `size` bytes, initially zero-filled.
+     *
+     *  Any existing segment with the same name is unlinked first, so that
+     *  writers left over from an earlier run cannot write to the new one.
+     *  The segment is unlinked again when this object is destroyed.
+     *
+     *  \throws std::system_error if the segment could not be created.
+     */
+    shared_memory(const std::string& name, std::size_t size);
+
+    /**
+     *  Opens an existing segment.
+     *
+     *  \throws std::system_error if the segment could not be opened.
+     */
+    explicit shared_memory(const std::string& name);
+
+    ~shared_memory() noexcept;
+
+    shared_memory(const shared_memory&) = delete;
+    shared_memory& operator=(const shared_memory&) = delete;
+    shared_memory(shared_memory&&) = delete;
+    shared_memory& operator=(shared_memory&&) = delete;
+
+    /// The start of the mapped segment.
+    void* data() const noexcept { return data_; }
+
+    /// The size of the segment, in bytes.
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    void unmap() noexcept;
+
+    std::string name_;
+    bool owner_ = false;
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* mappingHandle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "shm_input_manipulator.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// A reader only retries while a write is in progress, and a write of a
+// few hundred values takes well under a microsecond, so this is plenty.
+constexpr int maxReadAttempts = 64;
+
+std::vector<shm_input_manipulator::mapping> nonempty(std::vector<shm_input_manipulator::mapping> mappings)
+{
+    if (mappings.empty()) {
+        throw std::invalid_argument("No variables to set from shared memory");
+    }
+    return mappings;
+}
+
+} // namespace
+
+
+shm_input_manipulator::shm_input_manipulator(
+    const std::string& segmentName,
+    std::vector<mapping> mappings)
+    : mappings_(nonempty(std::move(mappings)))
+    , memory_(segmentName, shared_input_block::required_size(mappings_.size()))
+    , block_(shared_input_block::initialize(memory_.data(), mappings_.size()))
+    , values_(mappings_.size())
+{
+}
+
+void shm_input_manipulator::simulator_added(
+    cosim::simulator_index index,
+    cosim::manipulable* sim,
+    cosim::time_point)
+{
+    simulator_entry entry;
+    entry.sim = sim;
+    for (const auto& v : sim->model_description().variables) {
+        if (v.type == cosim::variable_type::real) {
+            // Parameters are set the same way as inputs.
+            entry.isInput[v.reference] =
+                v.causality == cosim::variable_causality::input ||
+                v.causality == cosim::variable_causality::parameter;
+        }
+    }
+    for (const auto& m : mappings_) {
+        if (m.simulator == index && !entry.isInput.count(m.reference)) {
+            throw std::invalid_argument(
+                "Simulator " + std::to_string(index) + " has no real variable with value reference " +
+                std::to_string(m.reference));
+        }
+    }
+    simulators_[index] = std::move(entry);
+
+    // Apply the latest values to the new simulator too.
+    lastSequence_ = 0;
+}
+
+void shm_input_manipulator::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    simulators_.erase(index);
+}
+
+void shm_input_manipulator::step_commencing(cosim::time_point)
+{
+    std::uint64_t sequence = 0;
+    if (!block_.try_read(values_.data(), sequence, maxReadAttempts)) {
+        ++skippedReads_;
+        return;
+    }
+    // Sequence number 0 means that nothing has been written yet.
+    if (sequence == 0 || sequence == lastSequence_) return;
+    lastSequence_ = sequence;
+
+    for (std::size_t i = 0; i < mappings_.size(); ++i) {
+        set_modifier(mappings_[i], values_[i]);
+    }
+}
+
+void shm_input_manipulator::set_modifier(const mapping& m, double value)
+{
+    const auto it = simulators_.find(m.simulator);
+    if (it == simulators_.end()) return;
+    const auto& entry = it->second;
+    auto modifier = [value](double, cosim::duration) { return value; };
+    entry.sim->expose_for_setting(cosim::variable_type::real, m.reference);
+    if (entry.isInput.at(m.reference)) {
+        entry.sim->set_real_input_modifier(m.reference, std::move(modifier));
+    } else {
+        entry.sim->set_real_output_modifier(m.reference, std::move(modifier));
+    }
+}
+
+} // namespace cosimc
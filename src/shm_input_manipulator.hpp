@@ -0,0 +1,100 @@
+/**
+ *  \file
+ *  \brief A manipulator which reads input values from shared memory.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_SHM_INPUT_MANIPULATOR_HPP
+#define LIBCOSIMC_SHM_INPUT_MANIPULATOR_HPP
+
+#include "shared_input_block.hpp"
+#include "shared_memory.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/manipulator/manipulator.hpp>
+#include <cosim/model_description.hpp>
+#include <cosim/time.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A manipulator which sets real variables to values written to a named
+ *  shared-memory segment by another process.
+ *
+ *  The manipulator creates the segment, with one slot per mapped variable,
+ *  and the other process writes to it with the `cosim_shm_writer` library.
+ *  At the start of each step, the manipulator takes a consistent copy of
+ *  all slots and, if anything has been written since the previous step,
+ *  overrides each variable with the value in its slot.  Variables are left
+ *  alone until the first write.
+ *
+ *  Reading never waits for the writer.  If no consistent copy can be made
+ *  because the slots are being written continuously, the values from the
+ *  previous step are kept, and the read is counted in `skipped_reads()`.
+ */
+class shm_input_manipulator : public cosim::manipulator
+{
+public:
+    /// A variable which is set from a slot in the segment.
+    struct mapping
+    {
+        cosim::simulator_index simulator;
+        cosim::value_reference reference;
+    };
+
+    /**
+     *  Constructor.
+     *
+     *  \param segmentName
+     *      The name of the shared-memory segment to create.
+     *  \param mappings
+     *      The variables to set, in slot order.
+     *
+     *  \throws std::system_error if the segment could not be created.
+     */
+    shm_input_manipulator(const std::string& segmentName, std::vector<mapping> mappings);
+
+    shm_input_manipulator(const shm_input_manipulator&) = delete;
+    shm_input_manipulator& operator=(const shm_input_manipulator&) = delete;
+
+    // cosim::manipulator methods
+    void simulator_added(cosim::simulator_index, cosim::manipulable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void step_commencing(cosim::time_point currentTime) override;
+
+    /// Returns the number of steps at which no consistent copy could be made.
+    std::uint64_t skipped_reads() const noexcept { return skippedReads_; }
+
+private:
+    struct simulator_entry
+    {
+        cosim::manipulable* sim = nullptr;
+        // Whether each real variable is an input or parameter, which gets an
+        // input modifier
+        std::unordered_map<cosim::value_reference, bool> isInput;
+    };
+
+    void set_modifier(const mapping& m, double value);
+
+    std::vector<mapping> mappings_;
+    shared_memory memory_;
+    shared_input_block block_;
+    std::vector<double> values_;
+    std::uint64_t lastSequence_ = 0;
+    std::atomic<std::uint64_t> skippedReads_{0};
+    std::unordered_map<cosim::simulator_index, simulator_entry> simulators_;
+};
+
+} // namespace cosimc
+#endif // header guard
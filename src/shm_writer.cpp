@@ -0,0 +1,54 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "shared_input_block.hpp"
+#include "shared_memory.hpp"
+
+#include <cosim_shm_writer.h>
+
+#include <exception>
+#include <memory>
+
+
+struct cosim_shm_writer_s
+{
+    explicit cosim_shm_writer_s(const char* segmentName)
+        : memory(segmentName)
+        , block(cosimc::shared_input_block::attach(memory.data(), memory.size()))
+    { }
+
+    cosimc::shared_memory memory;
+    cosimc::shared_input_block block;
+};
+
+cosim_shm_writer* cosim_shm_writer_open(const char* segmentName)
+{
+    try {
+        return std::make_unique<cosim_shm_writer>(segmentName).release();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+size_t cosim_shm_writer_size(const cosim_shm_writer* writer)
+{
+    return writer->block.size();
+}
+
+int cosim_shm_writer_write(
+    cosim_shm_writer* writer,
+    size_t offset,
+    const double values[],
+    size_t count)
+{
+    const auto size = writer->block.size();
+    if (offset > size || count > size - offset) return -1;
+    writer->block.write(offset, values, count);
+    return 0;
+}
+
+void cosim_shm_writer_close(cosim_shm_writer* writer)
+{
+    delete writer;
+}
@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "ssp_archive.hpp"
+
+#include "parallel_unzip.hpp"
+#include "xml_document.hpp"
+
+#include <cosim/utility/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+
+namespace cosimc
+{
+namespace
+{
+
+const std::string systemStructureEntry = "SystemStructure.ssd";
+
+// Returns whether `reference` is a relative URI reference, as opposed to an
+// absolute URI (which has a scheme) or an absolute path.
+bool is_relative_reference(const std::string& reference)
+{
+    if (reference.empty() || reference[0] == '/' || reference[0] == '\\') return false;
+    const auto colon = reference.find(':');
+    const auto slash = reference.find('/');
+    return colon == std::string::npos || (slash != std::string::npos && slash < colon);
+}
+
+std::string percent_decode(const std::string& s)
+{
+    std::string decoded;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '%' && i + 2 < s.size() &&
+            std::isxdigit(static_cast<unsigned char>(s[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(s[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += s[i];
+        }
+    }
+    return decoded;
+}
+
+// Collects the archive entries referred to by `source` attributes of
+// components and parameter bindings in `element` and its descendants.
+void collect_sources(const xml_element& element, std::set<std::string>& entries)
+{
+    if (element.name == "Component" || element.name == "ParameterBinding") {
+        const auto source = element.attribute("source");
+        if (source && is_relative_reference(*source)) {
+            const auto entry = cosim::filesystem::path(percent_decode(*source))
+                                   .lexically_normal()
+                                   .generic_string();
+            if (entry.rfind("..", 0) == 0) {
+                throw std::runtime_error("SSP refers to a file outside the archive: " + *source);
+            }
+            entries.insert(entry);
+        }
+    }
+    for (const auto& child : element.children) collect_sources(child, entries);
+}
+
+bool has_extension(const cosim::filesystem::path& path, const std::string& extension)
+{
+    auto actual = path.extension().string();
+    std::transform(actual.begin(), actual.end(), actual.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return actual == extension;
+}
+
+// Extracts the system structure, and returns the other entries it refers to.
+std::vector<std::string> unpack_system_structure(
+    const cosim::filesystem::path& archivePath,
+    const cosim::filesystem::path& targetDir)
+{
+    extract_zip_entries(archivePath, {systemStructureEntry}, targetDir, 1);
+    std::set<std::string> sources;
+    collect_sources(read_xml_file(targetDir / systemStructureEntry), sources);
+    return std::vector<std::string>(sources.begin(), sources.end());
+}
+
+} // namespace
+
+
+bool is_ssp_archive(const cosim::filesystem::path& path)
+{
+    return has_extension(path, ".ssp");
+}
+
+std::vector<std::string> unpack_ssp_archive(
+    const cosim::filesystem::path& archivePath,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount)
+{
+    const auto entries = unpack_system_structure(archivePath, targetDir);
+    extract_zip_entries(archivePath, entries, targetDir, threadCount);
+
+    std::vector<std::string> extracted;
+    extracted.reserve(entries.size() + 1);
+    extracted.push_back(systemStructureEntry);
+    extracted.insert(extracted.end(), entries.begin(), entries.end());
+    return extracted;
+}
+
+void unpack_ssp_model_descriptions(
+    const cosim::filesystem::path& archivePath,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount)
+{
+    std::vector<std::string> fmus;
+    std::vector<std::string> others;
+    for (auto& entry : unpack_system_structure(archivePath, targetDir)) {
+        (has_extension(entry, ".fmu") ? fmus : others).push_back(std::move(entry));
+    }
+    extract_zip_entries(archivePath, others, targetDir, threadCount);
+
+    // An FMU can't be read while it is inside the SSP, so each one is
+    // copied out in turn, and dropped again as soon as its model
+    // description has been extracted.  A broken FMU is left out, for the
+    // caller to report when it finds it missing.
+    for (const auto& fmu : fmus) {
+        const auto scratchDir = cosim::utility::temp_dir();
+        extract_zip_entries(archivePath, {fmu}, scratchDir.path(), 1);
+        try {
+            extract_zip_entries(scratchDir.path() / fmu, {"modelDescription.xml"}, targetDir / fmu, 1);
+        } catch (const std::runtime_error&) {
+        }
+    }
+}
+
+} // namespace cosimc
@@ -0,0 +1,75 @@
+/**
+ *  \file
+ *  \brief Selective unpacking of SSP archives.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_SSP_ARCHIVE_HPP
+#define LIBCOSIMC_SSP_ARCHIVE_HPP
+
+#include <cosim/fs_portability.hpp>
+
+#include <string>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Returns whether `path` refers to a zipped SSP archive, based on its extension.
+bool is_ssp_archive(const cosim::filesystem::path& path);
+
+/**
+ *  Unpacks the parts of an SSP archive which are needed to load it.
+ *
+ *  Only `SystemStructure.ssd` and the files it refers to with relative
+ *  `source` attributes (FMUs, parameter value files and so on) are
+ *  extracted.  Documentation and other resources are left in the archive.
+ *  The system structure is extracted and parsed first, and then the
+ *  referenced files are extracted in parallel, each worker thread reading
+ *  the archive through its own handle.  Directory structure is preserved.
+ *
+ *  \param archivePath
+ *      The path to an `.ssp` file.
+ *  \param targetDir
+ *      The directory to unpack into.  It is created if it does not exist.
+ *  \param threadCount
+ *      The most threads to extract with.  If zero, the number of hardware
+ *      threads is used.
+ *
+ *  \returns
+ *      The archive entries which were extracted, starting with the system
+ *      structure.
+ *
+ *  \throws std::runtime_error if the archive could not be read, or if it
+ *      lacks the system structure or a file referred to by it.
+ */
+std::vector<std::string> unpack_ssp_archive(
+    const cosim::filesystem::path& archivePath,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount = 0);
+
+/**
+ *  Unpacks the parts of an SSP archive which are needed to validate it.
+ *
+ *  This works like `unpack_ssp_archive()`, except that for each FMU, only
+ *  its `modelDescription.xml` is unpacked, into a directory with the FMU's
+ *  archive path.  The FMUs are still copied out of the archive, one at a
+ *  time, since a nested archive can't be read in place, but each copy is
+ *  deleted as soon as its model description has been extracted, and the
+ *  rest of its contents are never unpacked.  FMUs which are not valid
+ *  archives, or which lack a model description, are left out.
+ *
+ *  \throws std::runtime_error if the archive could not be read, or if it
+ *      lacks the system structure or a file referred to by it.
+ */
+void unpack_ssp_model_descriptions(
+    const cosim::filesystem::path& archivePath,
+    const cosim::filesystem::path& targetDir,
+    unsigned int threadCount = 0);
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,227 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "state_hash_observer.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// An implementation of the XXH64 hash function.
+// See https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+constexpr std::uint64_t prime1 = 11400714785074694791ULL;
+constexpr std::uint64_t prime2 = 14029467366897019727ULL;
+constexpr std::uint64_t prime3 = 1609587929392839161ULL;
+constexpr std::uint64_t prime4 = 9650029242287828579ULL;
+constexpr std::uint64_t prime5 = 2870177450012600261ULL;
+
+constexpr std::uint64_t rotl(std::uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+std::uint64_t read64(const unsigned char* p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+std::uint32_t read32(const unsigned char* p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+constexpr std::uint64_t xxh64_round(std::uint64_t acc, std::uint64_t input)
+{
+    return rotl(acc + input * prime2, 31) * prime1;
+}
+
+constexpr std::uint64_t xxh64_merge_round(std::uint64_t acc, std::uint64_t val)
+{
+    return (acc ^ xxh64_round(0, val)) * prime1 + prime4;
+}
+
+std::uint64_t xxh64(const unsigned char* p, std::size_t len, std::uint64_t seed)
+{
+    const unsigned char* const end = p + len;
+    std::uint64_t h;
+
+    if (len >= 32) {
+        std::uint64_t v1 = seed + prime1 + prime2;
+        std::uint64_t v2 = seed + prime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - prime1;
+        const unsigned char* const limit = end - 32;
+        do {
+            v1 = xxh64_round(v1, read64(p));
+            v2 = xxh64_round(v2, read64(p + 8));
+            v3 = xxh64_round(v3, read64(p + 16));
+            v4 = xxh64_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    } else {
+        h = seed + prime5;
+    }
+    h += static_cast<std::uint64_t>(len);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64_round(0, read64(p));
+        h = rotl(h, 27) * prime1 + prime4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+        h = rotl(h, 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= static_cast<std::uint64_t>(*p) * prime5;
+        h = rotl(h, 11) * prime1;
+    }
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+template<typename T>
+void append(std::vector<unsigned char>& buffer, const T& value)
+{
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+void append(std::vector<unsigned char>& buffer, std::string_view value)
+{
+    append(buffer, static_cast<std::uint64_t>(value.size()));
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+} // namespace
+
+
+state_hash_observer::state_hash_observer(std::size_t window)
+{
+    if (window == 0) {
+        throw std::invalid_argument("The state hash window must hold at least one step");
+    }
+    hashes_.resize(window);
+}
+
+state_hash_observer::~state_hash_observer() noexcept = default;
+
+void state_hash_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* simulator,
+    cosim::time_point)
+{
+    simulator_outputs outputs;
+    outputs.simulator = simulator;
+    for (const auto& vd : simulator->model_description().variables) {
+        if (vd.causality != cosim::variable_causality::output) continue;
+        simulator->expose_for_getting(vd.type, vd.reference);
+        switch (vd.type) {
+            case cosim::variable_type::real: outputs.reals.push_back(vd.reference); break;
+            case cosim::variable_type::integer: outputs.integers.push_back(vd.reference); break;
+            case cosim::variable_type::boolean: outputs.booleans.push_back(vd.reference); break;
+            case cosim::variable_type::string: outputs.strings.push_back(vd.reference); break;
+            default: break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_[index] = std::move(outputs);
+}
+
+void state_hash_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    simulators_.erase(index);
+}
+
+void state_hash_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void state_hash_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void state_hash_observer::simulation_initialized(cosim::step_number firstStep, cosim::time_point)
+{
+    record(firstStep);
+}
+
+void state_hash_observer::step_complete(cosim::step_number lastStep, cosim::duration, cosim::time_point)
+{
+    record(lastStep);
+}
+
+void state_hash_observer::simulator_step_complete(
+    cosim::simulator_index,
+    cosim::step_number,
+    cosim::duration,
+    cosim::time_point)
+{ }
+
+void state_hash_observer::state_restored(cosim::step_number currentStep, cosim::time_point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Forget the hashes of the steps that are being repeated, so that the
+    // next step continues the rolling hash from the restored state.
+    if (firstStep_ && currentStep >= *firstStep_) {
+        recorded_ = std::min(recorded_, currentStep - *firstStep_ + 1);
+    }
+}
+
+std::optional<std::uint64_t> state_hash_observer::hash(cosim::step_number step) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!firstStep_) return std::nullopt;
+    return retained(step - *firstStep_);
+}
+
+std::optional<std::uint64_t> state_hash_observer::retained(cosim::step_number index) const
+{
+    const auto window = static_cast<cosim::step_number>(hashes_.size());
+    if (index < 0 || index >= recorded_ || recorded_ - index > window) return std::nullopt;
+    return hashes_[static_cast<std::size_t>(index % window)];
+}
+
+void state_hash_observer::record(cosim::step_number step)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.clear();
+    for (const auto& entry : simulators_) {
+        const auto& outputs = entry.second;
+        for (const auto ref : outputs.reals) append(buffer_, outputs.simulator->get_real(ref));
+        for (const auto ref : outputs.integers) append(buffer_, static_cast<std::int32_t>(outputs.simulator->get_integer(ref)));
+        for (const auto ref : outputs.booleans) append(buffer_, static_cast<std::uint8_t>(outputs.simulator->get_boolean(ref)));
+        for (const auto ref : outputs.strings) append(buffer_, std::string_view(outputs.simulator->get_string(ref)));
+    }
+
+    if (!firstStep_) firstStep_ = step;
+    const auto i = step - *firstStep_;
+    const std::uint64_t seed = retained(i - 1).value_or(0);
+    hashes_[static_cast<std::size_t>(i % static_cast<cosim::step_number>(hashes_.size()))] =
+        xxh64(buffer_.data(), buffer_.size(), seed);
+    recorded_ = i + 1;
+}
+
+} // namespace cosimc
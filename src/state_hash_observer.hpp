@@ -0,0 +1,109 @@
+/**
+ *  \file
+ *  \brief An observer which maintains a rolling hash of the simulation state.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_STATE_HASH_OBSERVER_HPP
+#define LIBCOSIMC_STATE_HASH_OBSERVER_HPP
+
+#include <cosim/model_description.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  An observer which computes a rolling hash over all output values after
+ *  every step.
+ *
+ *  The hash for step `n` is the XXH64 hash of the values of all output
+ *  variables of all simulators after that step, seeded with the hash for
+ *  step `n-1`.  Two runs therefore have equal hashes for a step if and only
+ *  if (barring collisions) all outputs have been bit-identical up to and
+ *  including that step, which makes it cheap to check that e.g. parallel
+ *  and serial stepping give the same results.
+ *
+ *  Values are hashed in their native binary representation, so hashes can
+ *  only be compared between runs on platforms with the same byte order.
+ *
+ *  Only the hashes of the most recent steps are kept, in a ring buffer of a
+ *  fixed size, so memory use does not grow with the length of the
+ *  simulation.  If a state is restored from further back than this, the
+ *  hash chain starts over from the restored step.
+ */
+class state_hash_observer : public cosim::observer
+{
+public:
+    /// The default number of steps for which hashes are kept.
+    static constexpr std::size_t default_window = 65536;
+
+    /**
+     *  Constructor.
+     *
+     *  \param window
+     *      The number of most recent steps for which hashes are kept.
+     *
+     *  \throws std::invalid_argument if `window` is zero.
+     */
+    explicit state_hash_observer(std::size_t window = default_window);
+    ~state_hash_observer() noexcept override;
+
+    state_hash_observer(const state_hash_observer&) = delete;
+    state_hash_observer& operator=(const state_hash_observer&) = delete;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+    /**
+     *  Returns the hash for `step`, or nothing if it has not been computed
+     *  or has been dropped from the window.
+     */
+    std::optional<std::uint64_t> hash(cosim::step_number step) const;
+
+private:
+    struct simulator_outputs
+    {
+        cosim::observable* simulator;
+        std::vector<cosim::value_reference> reals;
+        std::vector<cosim::value_reference> integers;
+        std::vector<cosim::value_reference> booleans;
+        std::vector<cosim::value_reference> strings;
+    };
+
+    void record(cosim::step_number step);
+    // Returns the hash with the given index relative to the first step, if
+    // it is in the window.  Must be called with `mutex_` held.
+    std::optional<std::uint64_t> retained(cosim::step_number index) const;
+
+    std::map<cosim::simulator_index, simulator_outputs> simulators_;
+    std::vector<unsigned char> buffer_;
+    std::optional<cosim::step_number> firstStep_;
+    // A ring buffer, where the hash with relative index `i` is at `i % size`.
+    std::vector<std::uint64_t> hashes_;
+    // The number of steps recorded, i.e., one more than the latest index.
+    cosim::step_number recorded_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace cosimc
+#endif // header guard
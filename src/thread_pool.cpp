@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+
+namespace cosimc
+{
+
+thread_pool::thread_pool(unsigned int threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads_.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+void thread_pool::ensure_size(std::size_t threadCount)
+{
+    while (threads_.size() < threadCount) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+thread_pool::~thread_pool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void thread_pool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void thread_pool::run()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return done_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace cosimc
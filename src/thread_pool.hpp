@@ -0,0 +1,84 @@
+/**
+ *  \file
+ *  \brief A simple thread pool.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_THREAD_POOL_HPP
+#define LIBCOSIMC_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A fixed-size pool of worker threads which execute submitted tasks in
+ *  FIFO order.
+ *
+ *  The destructor waits for all queued tasks to complete, so the pool must
+ *  not be destroyed while a task may be blocked indefinitely.
+ */
+class thread_pool
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param threadCount
+     *      The number of worker threads.  If zero, the number of hardware
+     *      threads is used.
+     */
+    explicit thread_pool(unsigned int threadCount = 0);
+
+    ~thread_pool() noexcept;
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// Returns the number of worker threads.
+    std::size_t size() const noexcept { return threads_.size(); }
+
+    /**
+     *  Adds worker threads, if necessary, so that there are at least
+     *  `threadCount` of them.  Must not be called concurrently with itself
+     *  or `size()`.
+     */
+    void ensure_size(std::size_t threadCount);
+
+    /// Queues `task` for execution and returns a future for its result.
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task)
+    {
+        auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(
+            std::forward<F>(task));
+        auto future = packaged->get_future();
+        enqueue([packaged] { (*packaged)(); });
+        return future;
+    }
+
+private:
+    void enqueue(std::function<void()> task);
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool done_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace cosimc
+#endif // header guard
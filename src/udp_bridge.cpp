@@ -0,0 +1,333 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "udp_bridge.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+
+
+namespace cosimc
+{
+namespace
+{
+
+// The most packets the observer lets queue up for sending.
+constexpr std::size_t maxPendingPackets = 1024;
+
+// The most packets the manipulator receives in one system call.
+constexpr std::size_t receiveBatchSize = 32;
+
+// How often the receiver thread checks whether it should stop.
+constexpr auto stopPollInterval = std::chrono::milliseconds(50);
+
+int to_int(double value)
+{
+    if (std::isnan(value)) return 0;
+    return static_cast<int>(std::clamp(
+        value,
+        static_cast<double>(std::numeric_limits<int>::min()),
+        static_cast<double>(std::numeric_limits<int>::max())));
+}
+
+packet_layout validated(packet_layout layout)
+{
+    validate(layout);
+    return layout;
+}
+
+} // namespace
+
+
+// =============================================================================
+// udp_output_observer
+// =============================================================================
+
+udp_output_observer::udp_output_observer(
+    const std::string& localAddress,
+    std::uint16_t localPort,
+    const std::string& remoteAddress,
+    std::uint16_t remotePort,
+    packet_layout layout)
+    : socket_(localAddress, localPort)
+    , layout_(validated(std::move(layout)))
+{
+    socket_.connect(remoteAddress, remotePort);
+    thread_ = std::thread([this] { run(); });
+}
+
+udp_output_observer::~udp_output_observer() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeUp_.notify_one();
+    thread_.join();
+}
+
+void udp_output_observer::simulator_added(
+    cosim::simulator_index index,
+    cosim::observable* sim,
+    cosim::time_point)
+{
+    for (const auto& f : layout_.fields) {
+        if (f.simulator == index) sim->expose_for_getting(f.type, f.reference);
+    }
+    simulators_[index] = sim;
+}
+
+void udp_output_observer::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    simulators_.erase(index);
+}
+
+void udp_output_observer::variables_connected(cosim::variable_id, cosim::variable_id, cosim::time_point) { }
+
+void udp_output_observer::variable_disconnected(cosim::variable_id, cosim::time_point) { }
+
+void udp_output_observer::simulation_initialized(cosim::step_number, cosim::time_point)
+{
+    publish();
+}
+
+void udp_output_observer::step_complete(cosim::step_number, cosim::duration, cosim::time_point)
+{
+    publish();
+}
+
+void udp_output_observer::simulator_step_complete(
+    cosim::simulator_index,
+    cosim::step_number,
+    cosim::duration,
+    cosim::time_point)
+{
+}
+
+void udp_output_observer::state_restored(cosim::step_number, cosim::time_point) { }
+
+udp_bridge_stats udp_output_observer::stats() const noexcept
+{
+    udp_bridge_stats s;
+    s.packets = packets_;
+    s.droppedPackets = droppedPackets_;
+    s.errors = errors_;
+    return s;
+}
+
+void udp_output_observer::publish()
+{
+    std::vector<char> packet;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.size() >= maxPendingPackets) {
+            ++droppedPackets_;
+            return;
+        }
+        if (!spare_.empty()) {
+            packet = std::move(spare_.back());
+            spare_.pop_back();
+        }
+    }
+
+    packet.assign(layout_.size, 0);
+    for (const auto& f : layout_.fields) {
+        const auto it = simulators_.find(f.simulator);
+        if (it == simulators_.end()) continue;
+        double value = 0.0;
+        switch (f.type) {
+            case cosim::variable_type::real: value = it->second->get_real(f.reference); break;
+            case cosim::variable_type::integer: value = it->second->get_integer(f.reference); break;
+            case cosim::variable_type::boolean: value = it->second->get_boolean(f.reference) ? 1.0 : 0.0; break;
+            default: break;
+        }
+        encode(f, value, packet.data());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(packet));
+    }
+    wakeUp_.notify_one();
+}
+
+void udp_output_observer::run()
+{
+    std::vector<std::vector<char>> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeUp_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        // Packets which are already queued are sent before stopping.
+        if (pending_.empty()) return;
+        batch.swap(pending_);
+        lock.unlock();
+
+        std::size_t sent = 0;
+        try {
+            sent = socket_.send(batch);
+        } catch (const std::exception&) {
+            ++errors_;
+        }
+        packets_ += sent;
+        droppedPackets_ += batch.size() - sent;
+
+        lock.lock();
+        for (auto& p : batch) spare_.push_back(std::move(p));
+        batch.clear();
+    }
+}
+
+
+// =============================================================================
+// udp_input_manipulator
+// =============================================================================
+
+udp_input_manipulator::udp_input_manipulator(
+    const std::string& localAddress,
+    std::uint16_t localPort,
+    packet_layout layout)
+    : socket_(localAddress, localPort)
+    , layout_(validated(std::move(layout)))
+    , values_(layout_.fields.size())
+    , latest_(layout_.fields.size())
+{
+    thread_ = std::thread([this] { run(); });
+}
+
+udp_input_manipulator::~udp_input_manipulator() noexcept
+{
+    stopping_ = true;
+    thread_.join();
+}
+
+void udp_input_manipulator::simulator_added(
+    cosim::simulator_index index,
+    cosim::manipulable* sim,
+    cosim::time_point)
+{
+    simulator_entry entry;
+    entry.sim = sim;
+    for (const auto& v : sim->model_description().variables) {
+        // Parameters are set the same way as inputs.
+        if (v.causality == cosim::variable_causality::input ||
+            v.causality == cosim::variable_causality::parameter) {
+            entry.inputs.emplace(v.type, v.reference);
+        }
+    }
+    for (const auto& f : layout_.fields) {
+        if (f.simulator == index) sim->expose_for_setting(f.type, f.reference);
+    }
+    simulators_[index] = std::move(entry);
+
+    // Apply the latest values to the new simulator too.
+    appliedSequence_ = 0;
+}
+
+void udp_input_manipulator::simulator_removed(cosim::simulator_index index, cosim::time_point)
+{
+    simulators_.erase(index);
+}
+
+void udp_input_manipulator::step_commencing(cosim::time_point)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Sequence number 0 means that nothing has been received yet.
+        if (sequence_ == 0 || sequence_ == appliedSequence_) return;
+        appliedSequence_ = sequence_;
+        std::copy(latest_.begin(), latest_.end(), values_.begin());
+    }
+    for (std::size_t i = 0; i < layout_.fields.size(); ++i) {
+        set_modifier(layout_.fields[i], values_[i]);
+    }
+}
+
+udp_bridge_stats udp_input_manipulator::stats() const noexcept
+{
+    udp_bridge_stats s;
+    s.packets = packets_;
+    s.droppedPackets = droppedPackets_;
+    s.errors = errors_;
+    return s;
+}
+
+void udp_input_manipulator::run()
+{
+    // One byte extra, to detect packets which are too long.
+    std::vector<std::vector<char>> buffers(receiveBatchSize, std::vector<char>(layout_.size + 1));
+    std::vector<std::size_t> lengths;
+    std::vector<double> decoded(layout_.fields.size());
+
+    while (!stopping_) {
+        try {
+            if (!socket_.wait_readable(stopPollInterval)) continue;
+            const auto n = socket_.receive(buffers, lengths);
+
+            // Only the newest packet of a batch matters.
+            const char* newest = nullptr;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (lengths[i] == layout_.size) {
+                    newest = buffers[i].data();
+                    ++packets_;
+                } else {
+                    ++droppedPackets_;
+                }
+            }
+            if (!newest) continue;
+
+            for (std::size_t i = 0; i < layout_.fields.size(); ++i) {
+                decoded[i] = decode(layout_.fields[i], newest);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            latest_.swap(decoded);
+            ++sequence_;
+        } catch (const std::exception&) {
+            ++errors_;
+        }
+    }
+}
+
+void udp_input_manipulator::set_modifier(const packet_field& field, double value)
+{
+    const auto it = simulators_.find(field.simulator);
+    if (it == simulators_.end()) return;
+    const auto& entry = it->second;
+    const bool input = entry.inputs.count({field.type, field.reference}) > 0;
+    switch (field.type) {
+        case cosim::variable_type::real: {
+            auto m = [value](double, cosim::duration) { return value; };
+            if (input) {
+                entry.sim->set_real_input_modifier(field.reference, std::move(m));
+            } else {
+                entry.sim->set_real_output_modifier(field.reference, std::move(m));
+            }
+            break;
+        }
+        case cosim::variable_type::integer: {
+            auto m = [x = to_int(value)](int, cosim::duration) { return x; };
+            if (input) {
+                entry.sim->set_integer_input_modifier(field.reference, std::move(m));
+            } else {
+                entry.sim->set_integer_output_modifier(field.reference, std::move(m));
+            }
+            break;
+        }
+        case cosim::variable_type::boolean: {
+            auto m = [x = value != 0.0](bool, cosim::duration) { return x; };
+            if (input) {
+                entry.sim->set_boolean_input_modifier(field.reference, std::move(m));
+            } else {
+                entry.sim->set_boolean_output_modifier(field.reference, std::move(m));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+} // namespace cosimc
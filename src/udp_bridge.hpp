@@ -0,0 +1,194 @@
+/**
+ *  \file
+ *  \brief An observer and a manipulator which exchange variable values with
+ *  external equipment in fixed-layout UDP packets.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_UDP_BRIDGE_HPP
+#define LIBCOSIMC_UDP_BRIDGE_HPP
+
+#include "packet_layout.hpp"
+#include "udp_socket.hpp"
+
+#include <cosim/algorithm/simulator.hpp>
+#include <cosim/manipulator/manipulator.hpp>
+#include <cosim/observer/observer.hpp>
+#include <cosim/time.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/// Packet counters for the UDP bridge.
+struct udp_bridge_stats
+{
+    /// Packets sent or received.
+    std::uint64_t packets = 0;
+    /// Packets which were not sent, or received packets of the wrong size.
+    std::uint64_t droppedPackets = 0;
+    /// Socket errors.
+    std::uint64_t errors = 0;
+};
+
+/**
+ *  An observer which sends the values of variables in a UDP packet after
+ *  initialization and after each step.
+ *
+ *  Packets are built on the stepping thread and handed over to a dedicated
+ *  sender thread, which sends whatever has accumulated in one batch.  If
+ *  the sender falls far behind, new packets are dropped rather than letting
+ *  the backlog grow without bound.
+ */
+class udp_output_observer : public cosim::observer
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param localAddress
+     *      The local IPv4 address to send from, or an empty string for any.
+     *  \param localPort
+     *      The local port to send from, or zero for an ephemeral port.
+     *  \param remoteAddress
+     *      The IPv4 address to send to.
+     *  \param remotePort
+     *      The port to send to.
+     *  \param layout
+     *      The layout of the packets.
+     */
+    udp_output_observer(
+        const std::string& localAddress,
+        std::uint16_t localPort,
+        const std::string& remoteAddress,
+        std::uint16_t remotePort,
+        packet_layout layout);
+
+    ~udp_output_observer() noexcept override;
+
+    udp_output_observer(const udp_output_observer&) = delete;
+    udp_output_observer& operator=(const udp_output_observer&) = delete;
+
+    // cosim::observer methods
+    void simulator_added(cosim::simulator_index, cosim::observable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void variables_connected(cosim::variable_id output, cosim::variable_id input, cosim::time_point) override;
+    void variable_disconnected(cosim::variable_id input, cosim::time_point) override;
+    void simulation_initialized(cosim::step_number firstStep, cosim::time_point startTime) override;
+    void step_complete(cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void simulator_step_complete(cosim::simulator_index index, cosim::step_number lastStep, cosim::duration lastStepSize, cosim::time_point currentTime) override;
+    void state_restored(cosim::step_number currentStep, cosim::time_point currentTime) override;
+
+    /// Returns the packet counters.  Thread safe.
+    udp_bridge_stats stats() const noexcept;
+
+private:
+    void publish();
+    void run();
+
+    udp_socket socket_;
+    packet_layout layout_;
+    std::unordered_map<cosim::simulator_index, cosim::observable*> simulators_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    bool stopping_ = false;
+    std::vector<std::vector<char>> pending_;
+    std::vector<std::vector<char>> spare_;
+
+    std::atomic<std::uint64_t> packets_{0};
+    std::atomic<std::uint64_t> droppedPackets_{0};
+    std::atomic<std::uint64_t> errors_{0};
+
+    std::thread thread_;
+};
+
+/**
+ *  A manipulator which sets variables from the values in UDP packets.
+ *
+ *  A dedicated receiver thread drains the socket in batches and decodes the
+ *  newest packet of each batch.  At the start of each step, if a packet has
+ *  arrived since the previous step, every mapped variable is overridden
+ *  with the value from the newest packet.  Variables are left alone until
+ *  the first packet arrives.  Packets which are not exactly the size of the
+ *  layout are dropped.
+ */
+class udp_input_manipulator : public cosim::manipulator
+{
+public:
+    /**
+     *  Constructor.
+     *
+     *  \param localAddress
+     *      The local IPv4 address to receive on, or an empty string for any.
+     *  \param localPort
+     *      The local port to receive on, or zero for an ephemeral port.
+     *  \param layout
+     *      The layout of the packets.
+     */
+    udp_input_manipulator(
+        const std::string& localAddress,
+        std::uint16_t localPort,
+        packet_layout layout);
+
+    ~udp_input_manipulator() noexcept override;
+
+    udp_input_manipulator(const udp_input_manipulator&) = delete;
+    udp_input_manipulator& operator=(const udp_input_manipulator&) = delete;
+
+    // cosim::manipulator methods
+    void simulator_added(cosim::simulator_index, cosim::manipulable*, cosim::time_point) override;
+    void simulator_removed(cosim::simulator_index, cosim::time_point) override;
+    void step_commencing(cosim::time_point currentTime) override;
+
+    /// Returns the local port the manipulator receives on.
+    std::uint16_t local_port() const { return socket_.local_port(); }
+
+    /// Returns the packet counters.  Thread safe.
+    udp_bridge_stats stats() const noexcept;
+
+private:
+    struct simulator_entry
+    {
+        cosim::manipulable* sim = nullptr;
+        // Inputs and parameters, which get input modifiers
+        std::set<std::pair<cosim::variable_type, cosim::value_reference>> inputs;
+    };
+
+    void run();
+    void set_modifier(const packet_field& field, double value);
+
+    udp_socket socket_;
+    packet_layout layout_;
+    std::unordered_map<cosim::simulator_index, simulator_entry> simulators_;
+    std::vector<double> values_;
+    std::uint64_t appliedSequence_ = 0;
+
+    std::mutex mutex_;
+    std::vector<double> latest_;
+    std::uint64_t sequence_ = 0;
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> packets_{0};
+    std::atomic<std::uint64_t> droppedPackets_{0};
+    std::atomic<std::uint64_t> errors_{0};
+
+    std::thread thread_;
+};
+
+} // namespace cosimc
+#endif // header guard
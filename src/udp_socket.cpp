@@ -0,0 +1,280 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#if defined(_WIN32) && !defined(NOMINMAX)
+#    define NOMINMAX
+#endif
+
+#include "udp_socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#else
+#    include <arpa/inet.h>
+#    include <fcntl.h>
+#    include <netinet/in.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+
+namespace cosimc
+{
+namespace
+{
+
+sockaddr_in make_address(const std::string& address, std::uint16_t port)
+{
+    sockaddr_in a;
+    std::memset(&a, 0, sizeof a);
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    if (address.empty()) {
+        a.sin_addr.s_addr = htonl(INADDR_ANY);
+    } else if (inet_pton(AF_INET, address.c_str(), &a.sin_addr) != 1) {
+        throw std::invalid_argument("Invalid IPv4 address: '" + address + "'");
+    }
+    return a;
+}
+
+// `is_refused()` identifies an ICMP "port unreachable" response to an
+// earlier datagram, which is reported as an error on a later call on a
+// connected socket.  It is not a failure of the current call, which can
+// simply be retried.
+
+#ifdef _WIN32
+
+int last_error() { return WSAGetLastError(); }
+bool would_block(int e) { return e == WSAEWOULDBLOCK; }
+bool is_refused(int e) { return e == WSAECONNRESET; }
+const std::error_category& socket_category() { return std::system_category(); }
+
+#else
+
+int last_error() { return errno; }
+bool would_block(int e) { return e == EAGAIN || e == EWOULDBLOCK; }
+bool is_refused(int e) { return e == ECONNREFUSED; }
+const std::error_category& socket_category() { return std::generic_category(); }
+
+#endif
+
+[[noreturn]] void throw_socket_error(const char* what)
+{
+    throw std::system_error(last_error(), socket_category(), what);
+}
+
+} // namespace
+
+
+#ifdef _WIN32
+
+udp_socket::udp_socket(const std::string& localAddress, std::uint16_t localPort)
+{
+    WSADATA wsaData;
+    if (const auto rc = WSAStartup(MAKEWORD(2, 2), &wsaData)) {
+        throw std::system_error(rc, std::system_category(), "Failed to initialise Winsock");
+    }
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_ == INVALID_SOCKET) {
+        const auto e = last_error();
+        WSACleanup();
+        throw std::system_error(e, std::system_category(), "Failed to create UDP socket");
+    }
+    try {
+        u_long nonBlocking = 1;
+        if (ioctlsocket(socket_, FIONBIO, &nonBlocking) != 0) {
+            throw_socket_error("Failed to make UDP socket non-blocking");
+        }
+        const auto a = make_address(localAddress, localPort);
+        if (::bind(socket_, reinterpret_cast<const sockaddr*>(&a), sizeof a) != 0) {
+            throw_socket_error("Failed to bind UDP socket");
+        }
+    } catch (...) {
+        closesocket(socket_);
+        WSACleanup();
+        throw;
+    }
+}
+
+udp_socket::~udp_socket() noexcept
+{
+    closesocket(socket_);
+    WSACleanup();
+}
+
+bool udp_socket::wait_readable(std::chrono::milliseconds timeout)
+{
+    WSAPOLLFD p;
+    p.fd = socket_;
+    p.events = POLLRDNORM;
+    p.revents = 0;
+    const auto rc = WSAPoll(&p, 1, static_cast<INT>(timeout.count()));
+    if (rc < 0) throw_socket_error("Failed to wait for UDP socket");
+    return rc > 0;
+}
+
+#else
+
+udp_socket::udp_socket(const std::string& localAddress, std::uint16_t localPort)
+{
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_ < 0) throw_socket_error("Failed to create UDP socket");
+    try {
+        const auto flags = ::fcntl(socket_, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(socket_, F_SETFL, flags | O_NONBLOCK) != 0) {
+            throw_socket_error("Failed to make UDP socket non-blocking");
+        }
+        const auto a = make_address(localAddress, localPort);
+        if (::bind(socket_, reinterpret_cast<const sockaddr*>(&a), sizeof a) != 0) {
+            throw_socket_error("Failed to bind UDP socket");
+        }
+    } catch (...) {
+        ::close(socket_);
+        throw;
+    }
+}
+
+udp_socket::~udp_socket() noexcept
+{
+    ::close(socket_);
+}
+
+bool udp_socket::wait_readable(std::chrono::milliseconds timeout)
+{
+    pollfd p;
+    p.fd = socket_;
+    p.events = POLLIN;
+    p.revents = 0;
+    const auto rc = ::poll(&p, 1, static_cast<int>(timeout.count()));
+    if (rc < 0 && errno != EINTR) throw_socket_error("Failed to wait for UDP socket");
+    return rc > 0;
+}
+
+#endif
+
+void udp_socket::connect(const std::string& address, std::uint16_t port)
+{
+    const auto a = make_address(address, port);
+    if (::connect(socket_, reinterpret_cast<const sockaddr*>(&a), sizeof a) != 0) {
+        throw_socket_error("Failed to connect UDP socket");
+    }
+}
+
+std::uint16_t udp_socket::local_port() const
+{
+    sockaddr_in a;
+    socklen_t length = sizeof a;
+    if (::getsockname(socket_, reinterpret_cast<sockaddr*>(&a), &length) != 0) {
+        throw_socket_error("Failed to get UDP socket address");
+    }
+    return ntohs(a.sin_port);
+}
+
+#ifdef __linux__
+
+std::size_t udp_socket::receive(std::vector<std::vector<char>>& buffers, std::vector<std::size_t>& lengths)
+{
+    std::vector<iovec> iov(buffers.size());
+    std::vector<mmsghdr> messages(buffers.size());
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        iov[i].iov_base = buffers[i].data();
+        iov[i].iov_len = buffers[i].size();
+        std::memset(&messages[i], 0, sizeof messages[i]);
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    const auto n = ::recvmmsg(socket_, messages.data(), static_cast<unsigned int>(messages.size()), 0, nullptr);
+    if (n < 0) {
+        if (would_block(errno) || errno == EINTR) return 0;
+        throw_socket_error("Failed to receive UDP datagrams");
+    }
+    lengths.resize(buffers.size());
+    for (int i = 0; i < n; ++i) {
+        // Truncated datagrams are reported with their full length.
+        lengths[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? buffers[i].size() + 1 : messages[i].msg_len;
+    }
+    return static_cast<std::size_t>(n);
+}
+
+std::size_t udp_socket::send(const std::vector<std::vector<char>>& packets)
+{
+    std::vector<iovec> iov(packets.size());
+    std::vector<mmsghdr> messages(packets.size());
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        iov[i].iov_base = const_cast<char*>(packets[i].data());
+        iov[i].iov_len = packets[i].size();
+        std::memset(&messages[i], 0, sizeof messages[i]);
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    std::size_t sent = 0;
+    while (sent < packets.size()) {
+        const auto n = ::sendmmsg(
+            socket_, messages.data() + sent, static_cast<unsigned int>(packets.size() - sent), 0);
+        if (n < 0) {
+            if (errno == EINTR || is_refused(errno)) continue;
+            if (would_block(errno)) break;
+            throw_socket_error("Failed to send UDP datagrams");
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return sent;
+}
+
+#else
+
+std::size_t udp_socket::receive(std::vector<std::vector<char>>& buffers, std::vector<std::size_t>& lengths)
+{
+    lengths.resize(buffers.size());
+    std::size_t n = 0;
+    while (n < buffers.size()) {
+        const auto rc = ::recv(socket_, buffers[n].data(), static_cast<int>(buffers[n].size()), 0);
+        if (rc < 0) {
+            const auto e = last_error();
+#    ifdef _WIN32
+            if (e == WSAEMSGSIZE) {
+                lengths[n] = buffers[n].size() + 1;
+                ++n;
+                continue;
+            }
+            // A previous send to a closed port is reported here on Windows.
+            if (e == WSAECONNRESET) continue;
+#    endif
+            if (would_block(e)) break;
+            throw_socket_error("Failed to receive UDP datagram");
+        }
+        lengths[n++] = static_cast<std::size_t>(rc);
+    }
+    return n;
+}
+
+std::size_t udp_socket::send(const std::vector<std::vector<char>>& packets)
+{
+    std::size_t sent = 0;
+    while (sent < packets.size()) {
+        const auto& p = packets[sent];
+        if (::send(socket_, p.data(), static_cast<int>(p.size()), 0) < 0) {
+            const auto e = last_error();
+            if (is_refused(e)) continue;
+            if (would_block(e)) break;
+            throw_socket_error("Failed to send UDP datagram");
+        }
+        ++sent;
+    }
+    return sent;
+}
+
+#endif
+
+} // namespace cosimc
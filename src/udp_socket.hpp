@@ -0,0 +1,90 @@
+/**
+ *  \file
+ *  \brief A minimal non-blocking UDP socket with batched I/O.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_UDP_SOCKET_HPP
+#define LIBCOSIMC_UDP_SOCKET_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  A non-blocking IPv4 UDP socket.
+ *
+ *  On Linux, batches of datagrams are sent and received with `sendmmsg()`
+ *  and `recvmmsg()`, i.e., one system call per batch.  Elsewhere, they are
+ *  sent and received one by one.
+ */
+class udp_socket
+{
+public:
+    /**
+     *  Creates a socket bound to a local address and port.
+     *
+     *  \param localAddress
+     *      A dotted-decimal IPv4 address, or an empty string for any
+     *      address.
+     *  \param localPort
+     *      A port number, or zero for an ephemeral port.
+     *
+     *  \throws std::invalid_argument if the address is invalid.
+     *  \throws std::system_error if the socket could not be created or bound.
+     */
+    udp_socket(const std::string& localAddress, std::uint16_t localPort);
+
+    ~udp_socket() noexcept;
+
+    udp_socket(const udp_socket&) = delete;
+    udp_socket& operator=(const udp_socket&) = delete;
+    udp_socket(udp_socket&&) = delete;
+    udp_socket& operator=(udp_socket&&) = delete;
+
+    /// Sets the destination of `send()`, and ignores datagrams from elsewhere.
+    void connect(const std::string& address, std::uint16_t port);
+
+    /// Returns the local port the socket is bound to.
+    std::uint16_t local_port() const;
+
+    /// Waits until a datagram can be received, or `timeout` has passed.
+    bool wait_readable(std::chrono::milliseconds timeout);
+
+    /**
+     *  Receives as many datagrams as are available, up to `buffers.size()`.
+     *
+     *  Each datagram is stored in the corresponding buffer, truncated to the
+     *  buffer size, and its full length is stored in `lengths`.
+     *
+     *  \returns the number of datagrams received.
+     */
+    std::size_t receive(std::vector<std::vector<char>>& buffers, std::vector<std::size_t>& lengths);
+
+    /**
+     *  Sends datagrams to the connected destination.
+     *
+     *  \returns the number of datagrams which were sent, which is less than
+     *      `packets.size()` if the send buffer filled up.
+     */
+    std::size_t send(const std::vector<std::vector<char>>& packets);
+
+private:
+#ifdef _WIN32
+    std::uintptr_t socket_;
+#else
+    int socket_ = -1;
+#endif
+};
+
+} // namespace cosimc
+#endif // header guard
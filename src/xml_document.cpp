@@ -0,0 +1,291 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "xml_document.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+
+namespace cosimc
+{
+namespace
+{
+
+std::string local_name(std::string_view name)
+{
+    const auto colon = name.find(':');
+    return std::string(colon == std::string_view::npos ? name : name.substr(colon + 1));
+}
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_name_char(char c)
+{
+    return !is_space(c) && c != '=' && c != '>' && c != '/' && c != '<' && c != '"' && c != '\'';
+}
+
+void append_utf8(std::string& s, std::uint32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        s += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        s += static_cast<char>(0xC0 | (codePoint >> 6));
+        s += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        s += static_cast<char>(0xE0 | (codePoint >> 12));
+        s += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        s += static_cast<char>(0xF0 | (codePoint >> 18));
+        s += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+class parser
+{
+public:
+    explicit parser(std::string_view document)
+        : doc_(document)
+    { }
+
+    xml_element parse_document()
+    {
+        if (starts_with("\xEF\xBB\xBF")) advance(3); // UTF-8 byte order mark
+        skip_misc();
+        if (at_end() || peek() != '<') fail("Expected a root element");
+        auto root = parse_element();
+        skip_misc();
+        if (!at_end()) fail("Unexpected content after the root element");
+        return root;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        throw std::runtime_error("XML error on line " + std::to_string(line_) + ": " + message);
+    }
+
+    bool at_end() const noexcept { return pos_ >= doc_.size(); }
+
+    char peek() const noexcept { return doc_[pos_]; }
+
+    bool starts_with(std::string_view s) const noexcept
+    {
+        return doc_.substr(pos_, s.size()) == s;
+    }
+
+    void advance(std::size_t n = 1)
+    {
+        for (std::size_t i = 0; i < n && !at_end(); ++i) {
+            if (doc_[pos_] == '\n') ++line_;
+            ++pos_;
+        }
+    }
+
+    void skip_space()
+    {
+        while (!at_end() && is_space(peek())) advance();
+    }
+
+    // Skips everything up to and including `terminator`.
+    void skip_past(std::string_view terminator)
+    {
+        while (!at_end() && !starts_with(terminator)) advance();
+        if (at_end()) fail("Expected '" + std::string(terminator) + "'");
+        advance(terminator.size());
+    }
+
+    // Skips whitespace, comments, processing instructions and document type
+    // declarations.
+    void skip_misc()
+    {
+        for (;;) {
+            skip_space();
+            if (starts_with("<?")) {
+                skip_past("?>");
+            } else if (starts_with("<!--")) {
+                skip_past("-->");
+            } else if (starts_with("<!DOCTYPE")) {
+                skip_past(">");
+            } else {
+                return;
+            }
+        }
+    }
+
+    std::string parse_name()
+    {
+        const auto start = pos_;
+        while (!at_end() && is_name_char(peek())) advance();
+        if (pos_ == start) fail("Expected a name");
+        return std::string(doc_.substr(start, pos_ - start));
+    }
+
+    // Decodes character data up to (not including) `terminator`.
+    std::string parse_text(char terminator)
+    {
+        std::string text;
+        while (!at_end() && peek() != terminator) {
+            if (peek() == '&') {
+                text += parse_entity();
+            } else {
+                text += peek();
+                advance();
+            }
+        }
+        return text;
+    }
+
+    std::string parse_entity()
+    {
+        advance(); // '&'
+        const auto end = doc_.find(';', pos_);
+        if (end == std::string_view::npos || end - pos_ > 10) fail("Unterminated entity reference");
+        const auto name = doc_.substr(pos_, end - pos_);
+        advance(name.size() + 1);
+        if (name == "lt") return "<";
+        if (name == "gt") return ">";
+        if (name == "amp") return "&";
+        if (name == "quot") return "\"";
+        if (name == "apos") return "'";
+        if (name.size() > 1 && name[0] == '#') {
+            try {
+                const bool hex = name[1] == 'x';
+                const auto codePoint = std::stoul(std::string(name.substr(hex ? 2 : 1)), nullptr, hex ? 16 : 10);
+                std::string s;
+                append_utf8(s, static_cast<std::uint32_t>(codePoint));
+                return s;
+            } catch (const std::logic_error&) {
+                // Reported below.
+            }
+        }
+        fail("Unknown entity '&" + std::string(name) + ";'");
+    }
+
+    xml_element parse_element()
+    {
+        xml_element element;
+        element.line = line_;
+        advance(); // '<'
+        const auto qualifiedName = parse_name();
+        element.name = local_name(qualifiedName);
+
+        for (;;) {
+            skip_space();
+            if (at_end()) fail("Unterminated start tag <" + qualifiedName + ">");
+            if (starts_with("/>")) {
+                advance(2);
+                return element;
+            }
+            if (peek() == '>') {
+                advance();
+                break;
+            }
+            const auto attributeName = parse_name();
+            skip_space();
+            if (at_end() || peek() != '=') fail("Expected '=' after attribute '" + attributeName + "'");
+            advance();
+            skip_space();
+            if (at_end() || (peek() != '"' && peek() != '\'')) fail("Expected a quoted attribute value");
+            const char quote = peek();
+            advance();
+            auto value = parse_text(quote);
+            if (at_end()) fail("Unterminated attribute value");
+            advance();
+            // Namespace declarations carry no information we need.
+            if (attributeName != "xmlns" && attributeName.rfind("xmlns:", 0) != 0) {
+                element.attributes.emplace_back(local_name(attributeName), std::move(value));
+            }
+        }
+
+        for (;;) {
+            if (at_end()) fail("Missing end tag for <" + qualifiedName + ">");
+            if (starts_with("</")) {
+                advance(2);
+                const auto endName = parse_name();
+                if (endName != qualifiedName) {
+                    fail("Expected </" + qualifiedName + ">, found </" + endName + ">");
+                }
+                skip_space();
+                if (at_end() || peek() != '>') fail("Expected '>'");
+                advance();
+                return element;
+            } else if (starts_with("<!--")) {
+                skip_past("-->");
+            } else if (starts_with("<![CDATA[")) {
+                advance(9);
+                const auto end = doc_.find("]]>", pos_);
+                if (end == std::string_view::npos) fail("Unterminated CDATA section");
+                element.text += doc_.substr(pos_, end - pos_);
+                advance(end - pos_ + 3);
+            } else if (starts_with("<?")) {
+                skip_past("?>");
+            } else if (peek() == '<') {
+                element.children.push_back(parse_element());
+            } else {
+                element.text += parse_text('<');
+            }
+        }
+    }
+
+    std::string_view doc_;
+    std::size_t pos_ = 0;
+    int line_ = 1;
+};
+
+} // namespace
+
+
+std::optional<std::string> xml_element::attribute(std::string_view attributeName) const
+{
+    for (const auto& a : attributes) {
+        if (a.first == attributeName) return a.second;
+    }
+    return std::nullopt;
+}
+
+const xml_element* xml_element::child(std::string_view childName) const
+{
+    for (const auto& c : children) {
+        if (c.name == childName) return &c;
+    }
+    return nullptr;
+}
+
+std::vector<const xml_element*> xml_element::children_named(std::string_view childName) const
+{
+    std::vector<const xml_element*> result;
+    for (const auto& c : children) {
+        if (c.name == childName) result.push_back(&c);
+    }
+    return result;
+}
+
+xml_element parse_xml(std::string_view document)
+{
+    return parser(document).parse_document();
+}
+
+xml_element read_xml_file(const cosim::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), "Failed to open " + path.string());
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse_xml(contents.str());
+}
+
+} // namespace cosimc
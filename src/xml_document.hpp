@@ -0,0 +1,71 @@
+/**
+ *  \file
+ *  \brief A minimal, non-validating XML reader.
+ *
+ *  \copyright
+ *      This Source Code Form is subject to the terms of the Mozilla Public
+ *      License, v. 2.0. If a copy of the MPL was not distributed with this
+ *      file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#ifndef LIBCOSIMC_XML_DOCUMENT_HPP
+#define LIBCOSIMC_XML_DOCUMENT_HPP
+
+#include <cosim/fs_portability.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace cosimc
+{
+
+/**
+ *  An XML element.
+ *
+ *  Namespace prefixes are stripped from element and attribute names, which
+ *  is sufficient for the configuration formats we read, where every element
+ *  name is unique within its parent regardless of namespace.
+ */
+struct xml_element
+{
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::vector<xml_element> children;
+    std::string text;
+    /// The line on which the element starts.
+    int line = 0;
+
+    /// Returns the value of an attribute, if present.
+    std::optional<std::string> attribute(std::string_view attributeName) const;
+
+    /// Returns the first child element with the given name, or null.
+    const xml_element* child(std::string_view childName) const;
+
+    /// Returns all child elements with the given name.
+    std::vector<const xml_element*> children_named(std::string_view childName) const;
+};
+
+/**
+ *  Parses an XML document, and returns its root element.
+ *
+ *  Processing instructions, comments and document type declarations are
+ *  skipped, and the predefined and numeric character entities are decoded.
+ *
+ *  \throws std::runtime_error if the document is not well formed, with the
+ *      line number in the message.
+ */
+xml_element parse_xml(std::string_view document);
+
+/**
+ *  Reads and parses an XML file.
+ *
+ *  \throws std::system_error if the file could not be read.
+ *  \throws std::runtime_error if the document is not well formed.
+ */
+xml_element read_xml_file(const cosim::filesystem::path& path);
+
+} // namespace cosimc
+#endif // header guard
@@ -0,0 +1,82 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Returns the number of recorded calls to the given function.
+int64_t count_calls(const char* function)
+{
+    cosim_api_call_stats stats[256];
+    const int n = cosim_get_api_stats(stats, 256);
+    for (int i = 0; i < n && i < 256; i++) {
+        if (strcmp(stats[i].function, function) == 0) return stats[i].calls;
+    }
+    return 0;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+
+    // Calls are not counted until instrumentation is enabled.
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+    if (cosim_get_api_stats(NULL, 0) != 0) {
+        fprintf(stderr, "Expected no calls to be counted\n");
+        goto Lfailure;
+    }
+
+    cosim_enable_api_stats();
+    cosim_execution_status status;
+    for (int i = 0; i < 10; i++) {
+        int rc = cosim_execution_get_status(execution, &status);
+        if (rc < 0) { goto Lerror; }
+    }
+    cosim_disable_api_stats();
+    int rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+
+    int64_t calls = count_calls("cosim_execution_get_status");
+    if (calls != 10) {
+        fprintf(stderr, "Expected 10 calls to be counted, got %lld\n", (long long)calls);
+        goto Lfailure;
+    }
+    cosim_api_call_stats stats;
+    rc = cosim_get_api_stats(&stats, 1);
+    if (rc != 1 || stats.total_time < 0) {
+        fprintf(stderr, "Unexpected counters for %d functions\n", rc);
+        goto Lfailure;
+    }
+
+    cosim_reset_api_stats();
+    calls = count_calls("cosim_execution_get_status");
+    if (calls != 0) {
+        fprintf(stderr, "Expected the counters to be reset, got %lld calls\n", (long long)calls);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
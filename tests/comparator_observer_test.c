@@ -0,0 +1,137 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+const char* referenceDir = "comparator_observer_test_reference";
+
+// Runs 10 steps of a single identity slave, with `input` applied to the
+// real input from step `changeStep` onwards, and 1.0 before that.
+// Returns the result of the last call to `cosim_execution_step()`.
+int run(const char* fmuPath, cosim_observer* observer, int changeStep, double input)
+{
+    int result = -1;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lcleanup; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lcleanup; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lcleanup; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lcleanup; }
+
+    if (cosim_execution_add_manipulator(execution, manipulator) < 0) { goto Lcleanup; }
+    if (cosim_execution_add_observer(execution, observer) < 0) { goto Lcleanup; }
+
+    cosim_value_reference ref = 0;
+    for (int i = 0; i < 10; i++) {
+        const double value = (i < changeStep) ? 1.0 : input;
+        if (cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &value) < 0) { goto Lcleanup; }
+        result = cosim_execution_step(execution, 1);
+        if (result < 0) { goto Lcleanup; }
+    }
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return result;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_observer* fileObserver = NULL;
+    cosim_observer* comparator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    // Record the reference.
+    fileObserver = cosim_file_observer_create(referenceDir);
+    if (!fileObserver) { goto Lerror; }
+    rc = run(fmuPath, fileObserver, 10, 1.0);
+    if (rc < 0) { goto Lerror; }
+    cosim_observer_destroy(fileObserver);
+    fileObserver = NULL;
+
+    // An identical run should pass.
+    comparator = cosim_comparator_observer_create(referenceDir, 1e-9, 0.0);
+    if (!comparator) { goto Lerror; }
+    rc = run(fmuPath, comparator, 10, 1.0);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_divergence divergence;
+    rc = cosim_comparator_observer_get_divergence(comparator, &divergence);
+    if (rc != 0) {
+        fprintf(stderr, "Expected no divergence, got %d\n", rc);
+        goto Lfailure;
+    }
+    cosim_observer_destroy(comparator);
+
+    // A run which differs from step 5 should be aborted there.
+    comparator = cosim_comparator_observer_create(referenceDir, 1e-9, 0.0);
+    if (!comparator) { goto Lerror; }
+    rc = run(fmuPath, comparator, 5, 2.0);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected the diverging run to fail\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_REFERENCE_DIVERGENCE) {
+        fprintf(stderr, "Expected error code %d, got %d\n", COSIM_ERRC_REFERENCE_DIVERGENCE, cosim_last_error_code());
+        goto Lerror;
+    }
+
+    rc = cosim_comparator_observer_get_divergence(comparator, &divergence);
+    if (rc != 1) {
+        fprintf(stderr, "Expected a divergence to be reported, got %d\n", rc);
+        goto Lfailure;
+    }
+    if (divergence.step != 6 || divergence.observed_value != 2.0 || divergence.reference_value != 1.0) {
+        fprintf(stderr, "Unexpected divergence: step %lld, observed %f, reference %f\n",
+            divergence.step, divergence.observed_value, divergence.reference_value);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_observer_destroy(comparator);
+    cosim_observer_destroy(fileObserver);
+    return exitCode;
+}
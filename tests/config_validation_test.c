@@ -0,0 +1,117 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char path[1024];
+    char report[4096];
+
+    // Valid configurations
+    int rc = snprintf(path, sizeof path, "%s/msmi/OspSystemStructure.xml", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+    int problems = cosim_validate_osp_config(path, report, sizeof report);
+    if (problems < 0) { goto Lerror; }
+    if (problems != 0) {
+        fprintf(stderr, "Expected a valid OSP config, got %d problems:\n%s\n", problems, report);
+        goto Lfailure;
+    }
+
+    rc = snprintf(path, sizeof path, "%s/ssp/demo", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+    problems = cosim_validate_ssp(path, report, sizeof report);
+    if (problems < 0) { goto Lerror; }
+    if (problems != 0) {
+        fprintf(stderr, "Expected a valid SSP, got %d problems:\n%s\n", problems, report);
+        goto Lfailure;
+    }
+
+    // The same system, validated straight from the archive
+    rc = snprintf(path, sizeof path, "%s/ssp/demo.ssp", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+    problems = cosim_validate_ssp(path, report, sizeof report);
+    if (problems < 0) { goto Lerror; }
+    if (problems != 0) {
+        fprintf(stderr, "Expected a valid SSP archive, got %d problems:\n%s\n", problems, report);
+        goto Lfailure;
+    }
+
+    // A configuration with six problems, all of which should be reported
+    rc = snprintf(path, sizeof path, "%s/msmi_invalid/OspSystemStructure.xml", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+    problems = cosim_validate_osp_config(path, report, sizeof report);
+    if (problems < 0) { goto Lerror; }
+    printf("%s\n", report);
+    if (problems != 6) {
+        fprintf(stderr, "Expected 6 problems, got %d\n", problems);
+        goto Lfailure;
+    }
+    if (!strstr(report, "noSuchVariable") || !strstr(report, "already connected")) {
+        fprintf(stderr, "Report is missing expected problems\n");
+        goto Lfailure;
+    }
+
+    // The problem count is returned even if there is no room for the report
+    problems = cosim_validate_osp_config(path, NULL, 0);
+    if (problems != 6) {
+        fprintf(stderr, "Expected 6 problems without a report buffer, got %d\n", problems);
+        goto Lfailure;
+    }
+
+    // A missing file is an error, not a problem
+    rc = snprintf(path, sizeof path, "%s/no_such_dir/OspSystemStructure.xml", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+    problems = cosim_validate_osp_config(path, report, sizeof report);
+    if (problems != -1) {
+        fprintf(stderr, "Expected an error for a missing file, got %d\n", problems);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    return exitCode;
+}
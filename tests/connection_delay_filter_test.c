@@ -0,0 +1,135 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Feeds either a ramp (y = t) or a unit step through an identity slave to a
+// second identity slave, with the given delay and filter time constant (in
+// seconds) on the connection between them, and returns the output of the
+// second slave after 10 steps in `output`.  Returns 0 on success and -1 on
+// error.
+int run(const char* fmuPath, int ramp, double delay, double timeConstant, double* output)
+{
+    int result = -1;
+    cosim_execution* execution = NULL;
+    cosim_slave* source = NULL;
+    cosim_slave* target = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const double stepSize = 0.1;
+    execution = cosim_execution_create(0, (int64_t)(stepSize * 1.0e9));
+    if (!execution) { goto Lcleanup; }
+
+    source = cosim_local_slave_create(fmuPath, "source");
+    if (!source) { goto Lcleanup; }
+    target = cosim_local_slave_create(fmuPath, "target");
+    if (!target) { goto Lcleanup; }
+
+    cosim_slave_index sourceIndex = cosim_execution_add_slave(execution, source);
+    if (sourceIndex < 0) { goto Lcleanup; }
+    cosim_slave_index targetIndex = cosim_execution_add_slave(execution, target);
+    if (targetIndex < 0) { goto Lcleanup; }
+
+    if (cosim_execution_connect_real_variables(execution, sourceIndex, 0, targetIndex, 0) < 0) { goto Lcleanup; }
+    if (cosim_execution_set_real_connection_delay(execution, targetIndex, 0, (cosim_duration)(delay * 1.0e9)) < 0) { goto Lcleanup; }
+    if (cosim_execution_set_real_connection_filter(execution, targetIndex, 0, (cosim_duration)(timeConstant * 1.0e9)) < 0) { goto Lcleanup; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lcleanup; }
+    if (cosim_execution_add_observer(execution, observer) < 0) { goto Lcleanup; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lcleanup; }
+    if (cosim_execution_add_manipulator(execution, manipulator) < 0) { goto Lcleanup; }
+
+    cosim_value_reference ref = 0;
+    for (int i = 1; i <= 10; i++) {
+        // The source output at the end of step i
+        const double value = ramp ? i * stepSize : 1.0;
+        if (cosim_manipulator_slave_set_real(manipulator, sourceIndex, &ref, 1, &value) < 0) { goto Lcleanup; }
+        if (cosim_execution_step(execution, 1) < 0) { goto Lcleanup; }
+    }
+    if (cosim_observer_slave_get_real(observer, targetIndex, &ref, 1, output) < 0) { goto Lcleanup; }
+    result = 0;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(target);
+    cosim_local_slave_destroy(source);
+    cosim_execution_destroy(execution);
+    return result;
+}
+
+int check(const char* fmuPath, int ramp, double delay, double timeConstant, double expected)
+{
+    double output = -1.0;
+    if (run(fmuPath, ramp, delay, timeConstant, &output) < 0) {
+        print_last_error();
+        return -1;
+    }
+    if (fabs(output - expected) > 1e-9) {
+        fprintf(stderr, "Expected output %f with delay %f and time constant %f, got %f\n", expected, delay, timeConstant, output);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        return 1;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        return 1;
+    }
+
+    // During step 10, the target input is the source output from the end of
+    // step 9 (t = 0.9), minus the delay.  Delays which are not a multiple of
+    // the step size are interpolated.
+    if (check(fmuPath, 1, 0.0, 0.0, 0.9) < 0) return 1;
+    if (check(fmuPath, 1, 0.3, 0.0, 0.6) < 0) return 1;
+    if (check(fmuPath, 1, 0.25, 0.0, 0.65) < 0) return 1;
+
+    // Before the delay has elapsed, the initial output is held.
+    if (check(fmuPath, 1, 2.0, 0.0, 0.0) < 0) return 1;
+
+    // A filtered unit step, starting from 0 at t = 0.
+    const double timeConstant = 0.5;
+    if (check(fmuPath, 0, 0.0, timeConstant, 1.0 - exp(-0.9 / timeConstant)) < 0) return 1;
+
+    // The delay is applied before the filter.
+    if (check(fmuPath, 0, 0.3, timeConstant, 1.0 - exp(-0.6 / timeConstant)) < 0) return 1;
+
+    // Negative delays are rejected.
+    double output;
+    if (run(fmuPath, 1, -0.1, 0.0, &output) == 0) {
+        fprintf(stderr, "Expected a negative delay to be rejected\n");
+        return 1;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) {
+        print_last_error();
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Feeds a ramp (y = t) through an identity slave to a second identity slave,
+// with the given extrapolation order on the connection between them, and
+// returns the output of the second slave after 10 steps in `output`.
+// Returns 0 on success and -1 on error.
+int run(const char* fmuPath, int order, double* output)
+{
+    int result = -1;
+    cosim_execution* execution = NULL;
+    cosim_slave* source = NULL;
+    cosim_slave* target = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const double stepSize = 0.1;
+    execution = cosim_execution_create(0, (int64_t)(stepSize * 1.0e9));
+    if (!execution) { goto Lcleanup; }
+
+    source = cosim_local_slave_create(fmuPath, "source");
+    if (!source) { goto Lcleanup; }
+    target = cosim_local_slave_create(fmuPath, "target");
+    if (!target) { goto Lcleanup; }
+
+    cosim_slave_index sourceIndex = cosim_execution_add_slave(execution, source);
+    if (sourceIndex < 0) { goto Lcleanup; }
+    cosim_slave_index targetIndex = cosim_execution_add_slave(execution, target);
+    if (targetIndex < 0) { goto Lcleanup; }
+
+    if (cosim_execution_connect_real_variables(execution, sourceIndex, 0, targetIndex, 0) < 0) { goto Lcleanup; }
+    if (cosim_execution_set_real_connection_extrapolation(execution, targetIndex, 0, order) < 0) { goto Lcleanup; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lcleanup; }
+    if (cosim_execution_add_observer(execution, observer) < 0) { goto Lcleanup; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lcleanup; }
+    if (cosim_execution_add_manipulator(execution, manipulator) < 0) { goto Lcleanup; }
+
+    cosim_value_reference ref = 0;
+    for (int i = 1; i <= 10; i++) {
+        // The source output at the end of step i
+        const double value = i * stepSize;
+        if (cosim_manipulator_slave_set_real(manipulator, sourceIndex, &ref, 1, &value) < 0) { goto Lcleanup; }
+        if (cosim_execution_step(execution, 1) < 0) { goto Lcleanup; }
+    }
+    if (cosim_observer_slave_get_real(observer, targetIndex, &ref, 1, output) < 0) { goto Lcleanup; }
+    result = 0;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(target);
+    cosim_local_slave_destroy(source);
+    cosim_execution_destroy(execution);
+    return result;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        return 1;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        return 1;
+    }
+
+    // During step 10, the target input is held at the source output from
+    // the end of step 9 (t = 0.9).  With extrapolation, it is instead the
+    // value of the ramp at the middle of step 10 (t = 0.95).
+    const double expected[] = {0.9, 0.95, 0.95};
+    for (int order = 0; order <= 2; order++) {
+        double output = -1.0;
+        if (run(fmuPath, order, &output) < 0) {
+            print_last_error();
+            return 1;
+        }
+        if (fabs(output - expected[order]) > 1e-9) {
+            fprintf(stderr, "Expected output %f with extrapolation order %d, got %f\n", expected[order], order, output);
+            return 1;
+        }
+    }
+
+    // Invalid orders are rejected.
+    double output;
+    if (run(fmuPath, 3, &output) == 0) {
+        fprintf(stderr, "Expected extrapolation order 3 to be rejected\n");
+        return 1;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) {
+        print_last_error();
+        return 1;
+    }
+
+    return 0;
+}
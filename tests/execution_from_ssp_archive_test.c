@@ -0,0 +1,93 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_observer* observer = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    // The archive holds the same system as `ssp/demo`, with the FMUs under
+    // `resources/`, plus documentation which is not needed to load it.
+    char sspFile[1024];
+    int rc = snprintf(sspFile, sizeof sspFile, "%s/ssp/demo.ssp", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    char report[1024];
+    int problems = cosim_validate_ssp(sspFile, report, sizeof report);
+    if (problems < 0) { goto Lerror; }
+    if (problems != 0) {
+        fprintf(stderr, "Expected a valid SSP, got %d problems:\n%s\n", problems, report);
+        goto Lfailure;
+    }
+
+    execution = cosim_ssp_execution_create(sspFile, false, 0);
+    if (!execution) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    cosim_execution_add_observer(execution, observer);
+
+    rc = cosim_execution_step(execution, 3);
+    if (rc < 0) { goto Lerror; }
+
+    size_t numSlaves = cosim_execution_get_num_slaves(execution);
+    if (numSlaves != 2) {
+        fprintf(stderr, "Expected 2 slaves, got %zu\n", numSlaves);
+        goto Lfailure;
+    }
+
+    cosim_slave_info infos[2];
+    rc = cosim_execution_get_slave_infos(execution, &infos[0], numSlaves);
+    if (rc < 0) { goto Lerror; }
+
+    for (size_t i = 0; i < numSlaves; i++) {
+        if (0 == strncmp(infos[i].name, "KnuckleBoomCrane", SLAVE_NAME_MAX_SIZE)) {
+            double value = -1;
+            cosim_value_reference varIndex = 2;
+            rc = cosim_observer_slave_get_real(observer, infos[i].index, &varIndex, 1, &value);
+            if (rc < 0) { goto Lerror; }
+            if (value != 0.05) {
+                fprintf(stderr, "Expected value 0.05, got %f\n", value);
+                goto Lfailure;
+            }
+        }
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_observer_destroy(observer);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,147 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    int exitCode = 0;
+
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    const char* names[] = {"power", "magnitude", "flag"};
+    const char* expressions[] = {
+        "slave.realOut * slave.integerOut",
+        "hypot(slave.realOut, 2^2)",
+        "slave.booleanOut ? 1 : -1"};
+    cosim_slave_index derivedIndex = cosim_execution_add_expression_slave(execution, "derived", names, expressions, 3);
+    if (derivedIndex < 0) { goto Lerror; }
+
+    // Derived signals may be derived from other derived signals.
+    const char* chainedNames[] = {"doubled"};
+    const char* chainedExpressions[] = {"2 * derived.power"};
+    cosim_slave_index chainedIndex = cosim_execution_add_expression_slave(execution, "chained", chainedNames, chainedExpressions, 1);
+    if (chainedIndex < 0) { goto Lerror; }
+
+    const char* badNames[] = {"bad"};
+    const char* unknownVariable[] = {"slave.noSuchVariable + 1"};
+    if (cosim_execution_add_expression_slave(execution, "bad1", badNames, unknownVariable, 1) >= 0) {
+        fprintf(stderr, "Expected an error for an unknown variable\n");
+        goto Lfailure;
+    }
+    const char* syntaxError[] = {"slave.realOut +"};
+    if (cosim_execution_add_expression_slave(execution, "bad2", badNames, syntaxError, 1) >= 0) {
+        fprintf(stderr, "Expected an error for an invalid expression\n");
+        goto Lfailure;
+    }
+    // A failed attempt must not leave a slave behind, so the name can be
+    // used again.
+    const char* inputVariable[] = {"slave.realIn + 1"};
+    if (cosim_execution_add_expression_slave(execution, "retry", badNames, inputVariable, 1) >= 0) {
+        fprintf(stderr, "Expected an error for an input variable\n");
+        goto Lfailure;
+    }
+    const char* outputVariable[] = {"slave.realOut + 1"};
+    if (cosim_execution_add_expression_slave(execution, "retry", badNames, outputVariable, 1) < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference in = 0;
+    const double realValue = 3.0;
+    const int integerValue = 2;
+    const bool booleanValue = true;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &in, 1, &realValue);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_manipulator_slave_set_integer(manipulator, slaveIndex, &in, 1, &integerValue);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_manipulator_slave_set_boolean(manipulator, slaveIndex, &in, 1, &booleanValue);
+    if (rc < 0) { goto Lerror; }
+
+    // The derived signals must be up to date after a single step.
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference outputs[] = {0, 1, 2};
+    double values[3];
+    rc = cosim_observer_slave_get_real(observer, derivedIndex, outputs, 3, values);
+    if (rc < 0) { goto Lerror; }
+    if (values[0] != 6.0) {
+        fprintf(stderr, "Expected power 6.0, got %f\n", values[0]);
+        goto Lfailure;
+    }
+    if (fabs(values[1] - 5.0) > 1e-12) {
+        fprintf(stderr, "Expected magnitude 5.0, got %f\n", values[1]);
+        goto Lfailure;
+    }
+    if (values[2] != 1.0) {
+        fprintf(stderr, "Expected flag 1.0, got %f\n", values[2]);
+        goto Lfailure;
+    }
+
+    double doubled = 0.0;
+    rc = cosim_observer_slave_get_real(observer, chainedIndex, outputs, 1, &doubled);
+    if (rc < 0) { goto Lerror; }
+    if (doubled != 12.0) {
+        fprintf(stderr, "Expected doubled power 12.0, got %f\n", doubled);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+
+    return exitCode;
+}
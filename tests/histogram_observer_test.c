@@ -0,0 +1,155 @@
+#include <cosim.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_BINS 10
+#define NUM_STEPS 20
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    int exitCode = 0;
+
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_histogram_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference realIn = 0;
+    cosim_variable_id variable = {slaveIndex, COSIM_VARIABLE_TYPE_REAL, realIn};
+
+    const int linear = cosim_histogram_observer_add_variable(
+        observer, variable, COSIM_HISTOGRAM_LINEAR_BINS, 0.0, 10.0, NUM_BINS, true);
+    if (linear < 0) { goto Lerror; }
+    const int logarithmic = cosim_histogram_observer_add_variable(
+        observer, variable, COSIM_HISTOGRAM_LOG_BINS, 1.0, 100.0, 2, false);
+    if (logarithmic < 0) { goto Lerror; }
+
+    // Logarithmic bins must have a positive lower limit.
+    if (cosim_histogram_observer_add_variable(observer, variable, COSIM_HISTOGRAM_LOG_BINS, 0.0, 10.0, 2, false) >= 0) {
+        fprintf(stderr, "Expected an error for a logarithmic histogram starting at 0\n");
+        goto Lfailure;
+    }
+
+    // Alternate between 2.5 and 7.5, i.e., cycles with a range of 5.
+    for (int i = 0; i < NUM_STEPS; i++) {
+        double value = (i % 2 == 0) ? 2.5 : 7.5;
+        rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &realIn, 1, &value);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_execution_step(execution, 1);
+        if (rc < 0) { goto Lerror; }
+    }
+
+    int64_t counts[NUM_BINS];
+    double edges[NUM_BINS + 1];
+    cosim_histogram_summary summary;
+    int64_t numBins = cosim_histogram_observer_get_counts(observer, linear, counts, edges, NUM_BINS, &summary);
+    if (numBins != NUM_BINS) {
+        fprintf(stderr, "Expected %d bins, got %" PRId64 "\n", NUM_BINS, numBins);
+        goto Lfailure;
+    }
+    if (edges[0] != 0.0 || edges[1] != 1.0 || edges[NUM_BINS] != 10.0) {
+        fprintf(stderr, "Unexpected bin edges\n");
+        goto Lfailure;
+    }
+    int64_t total = summary.underflow + summary.overflow;
+    for (int i = 0; i < NUM_BINS; i++) total += counts[i];
+    if (summary.samples < NUM_STEPS || total != summary.samples) {
+        fprintf(stderr, "Inconsistent counts: %" PRId64 " samples, %" PRId64 " counted\n", summary.samples, total);
+        goto Lfailure;
+    }
+    // One sample may be of the initial value.
+    if (counts[2] < NUM_STEPS / 2 - 1 || counts[7] < NUM_STEPS / 2 - 1 || counts[2] + counts[7] < NUM_STEPS - 1) {
+        fprintf(stderr, "Unexpected counts: %" PRId64 " and %" PRId64 "\n", counts[2], counts[7]);
+        goto Lfailure;
+    }
+    if (summary.max != 7.5) {
+        fprintf(stderr, "Expected max 7.5, got %f\n", summary.max);
+        goto Lfailure;
+    }
+
+    double cycles[NUM_BINS];
+    double rangeBinWidth = 0.0;
+    numBins = cosim_histogram_observer_get_rainflow_cycles(observer, linear, cycles, NUM_BINS, &rangeBinWidth);
+    if (numBins != NUM_BINS || rangeBinWidth != 1.0) {
+        fprintf(stderr, "Unexpected rainflow bins: %" PRId64 ", width %f\n", numBins, rangeBinWidth);
+        goto Lfailure;
+    }
+    if (cycles[5] < NUM_STEPS / 2 - 2) {
+        fprintf(stderr, "Expected about %d cycles with range 5, got %f\n", NUM_STEPS / 2, cycles[5]);
+        goto Lfailure;
+    }
+
+    // All values fall in the first logarithmic bin, [1, 10), except perhaps the initial one.
+    cosim_histogram_summary logSummary;
+    int64_t logCounts[2];
+    numBins = cosim_histogram_observer_get_counts(observer, logarithmic, logCounts, NULL, 2, &logSummary);
+    if (numBins != 2 || logCounts[0] < NUM_STEPS || logCounts[1] != 0 || logSummary.overflow != 0) {
+        fprintf(stderr, "Unexpected logarithmic counts\n");
+        goto Lfailure;
+    }
+
+    // Rainflow counting was not enabled for the second histogram.
+    if (cosim_histogram_observer_get_rainflow_cycles(observer, logarithmic, cycles, NUM_BINS, NULL) >= 0) {
+        fprintf(stderr, "Expected an error when rainflow counting is disabled\n");
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+
+    return exitCode;
+}
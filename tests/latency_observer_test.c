@@ -0,0 +1,109 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_manipulator* manipulator = NULL;
+    cosim_observer* observer = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    observer = cosim_latency_observer_create(manipulator);
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    // The identity slave's real output follows its real input in the same step.
+    cosim_variable_id input = {slaveIndex, COSIM_VARIABLE_TYPE_REAL, 0};
+    cosim_variable_id output = {slaveIndex, COSIM_VARIABLE_TYPE_REAL, 0};
+    int pair = cosim_latency_observer_add_pair(observer, input, output);
+    if (pair < 0) { goto Lerror; }
+
+    cosim_value_reference ref = 0;
+    for (int i = 1; i <= 20; i++) {
+        double value = i;
+        rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &value);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_execution_step(execution, 1);
+        if (rc < 0) { goto Lerror; }
+    }
+
+    cosim_latency_stats stats;
+    rc = cosim_latency_observer_get_stats(observer, pair, &stats);
+    if (rc < 0) { goto Lerror; }
+    if (stats.samples != 20 || stats.unmatched != 0) {
+        fprintf(stderr, "Expected 20 matched samples, got %lld and %lld unmatched\n",
+            (long long)stats.samples, (long long)stats.unmatched);
+        goto Lfailure;
+    }
+    if (stats.total.min < 0 ||
+        stats.total.min > stats.total.p50 ||
+        stats.total.p50 > stats.total.p99 ||
+        stats.total.p99 > stats.total.max ||
+        stats.queueing.max > stats.total.max ||
+        stats.processing.max > stats.total.max) {
+        fprintf(stderr, "Inconsistent latency distributions\n");
+        goto Lfailure;
+    }
+
+    rc = cosim_latency_observer_get_stats(observer, pair + 1, &stats);
+    if (rc == 0 || cosim_last_error_code() != COSIM_ERRC_OUT_OF_RANGE) {
+        fprintf(stderr, "Expected an invalid pair index to be rejected\n");
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_observer_destroy(observer);
+    cosim_manipulator_destroy(manipulator);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,121 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* critical = NULL;
+    cosim_slave* degradable = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    critical = cosim_local_slave_create(fmuPath, "critical");
+    if (!critical) { goto Lerror; }
+    degradable = cosim_local_slave_create(fmuPath, "degradable");
+    if (!degradable) { goto Lerror; }
+
+    cosim_slave_index criticalIndex = cosim_execution_add_slave(execution, critical);
+    if (criticalIndex < 0) { goto Lerror; }
+    cosim_slave_index degradableIndex = cosim_execution_add_slave(execution, degradable);
+    if (degradableIndex < 0) { goto Lerror; }
+
+    rc = cosim_execution_set_slave_degradable(execution, degradableIndex, 8);
+    if (rc < 0) { goto Lerror; }
+
+    // A real time factor target which can't possibly be met.
+    rc = cosim_execution_enable_real_time_simulation(execution);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_set_real_time_factor_target(execution, 1.0e9);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_set_steps_to_monitor(execution, 5);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_enable_load_shedding(execution);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_step(execution, 200);
+    if (rc < 0) { goto Lerror; }
+
+    int factor = 0;
+    rc = cosim_execution_get_slave_decimation_factor(execution, degradableIndex, &factor);
+    if (rc < 0) { goto Lerror; }
+    if (factor != 8) {
+        fprintf(stderr, "Expected the degradable slave to have decimation factor 8, got %d\n", factor);
+        goto Lfailure;
+    }
+    rc = cosim_execution_get_slave_decimation_factor(execution, criticalIndex, &factor);
+    if (rc < 0) { goto Lerror; }
+    if (factor != 1) {
+        fprintf(stderr, "Expected the critical slave to have decimation factor 1, got %d\n", factor);
+        goto Lfailure;
+    }
+
+    cosim_execution_status status;
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+    if (status.num_degraded_slaves != 1) {
+        fprintf(stderr, "Expected 1 degraded slave, got %d\n", status.num_degraded_slaves);
+        goto Lfailure;
+    }
+
+    // Disabling load shedding restores the slave once its current step is done.
+    rc = cosim_execution_disable_load_shedding(execution);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 16);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_get_slave_decimation_factor(execution, degradableIndex, &factor);
+    if (rc < 0) { goto Lerror; }
+    if (factor != 1) {
+        fprintf(stderr, "Expected the restored slave to have decimation factor 1, got %d\n", factor);
+        goto Lfailure;
+    }
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+    if (status.num_degraded_slaves != 0) {
+        fprintf(stderr, "Expected no degraded slaves, got %d\n", status.num_degraded_slaves);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_local_slave_destroy(degradable);
+    cosim_local_slave_destroy(critical);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
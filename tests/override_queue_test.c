@@ -0,0 +1,126 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create_with_capacity(4);
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    // Fill the queue.
+    cosim_value_reference ref = 0;
+    for (int i = 1; i <= 4; i++) {
+        double value = i;
+        rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &value);
+        if (rc < 0) { goto Lerror; }
+    }
+
+    // One more doesn't fit.
+    double value = 5.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &value);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected submission to a full queue to fail\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_QUEUE_FULL) { goto Lerror; }
+    if (cosim_manipulator_get_overflow_count(manipulator) != 1) {
+        fprintf(stderr, "Expected overflow count 1\n");
+        goto Lfailure;
+    }
+
+    // The queued overrides are applied in order at the next step, which
+    // makes room for more.
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+    double output = -1.0;
+    rc = cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output);
+    if (rc < 0) { goto Lerror; }
+    if (output != 4.0) {
+        fprintf(stderr, "Expected output 4.0, got %f\n", output);
+        goto Lfailure;
+    }
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &value);
+    if (rc < 0) { goto Lerror; }
+
+    // Invalid slave indices are still rejected.
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex + 1, &ref, 1, &value);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected an invalid slave index to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_OUT_OF_RANGE) { goto Lerror; }
+
+    // So are variables which the slave doesn't have, which must not make
+    // the next step fail.
+    cosim_value_reference badRef = 1000;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &badRef, 1, &value);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected an invalid value reference to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_OUT_OF_RANGE) { goto Lerror; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,137 @@
+#include <cosim.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SEGMENT_LENGTH 64
+#define NUM_BINS (SEGMENT_LENGTH / 2 + 1)
+#define NUM_STEPS 512
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    int exitCode = 0;
+
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    // A sample rate of 100 Hz.
+    execution = cosim_execution_create(0, (int64_t)(0.01 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_psd_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference realIn = 0;
+    cosim_variable_id variable = {slaveIndex, COSIM_VARIABLE_TYPE_REAL, realIn};
+
+    const int spectrum = cosim_psd_observer_add_variable(
+        observer, variable, SEGMENT_LENGTH, SEGMENT_LENGTH / 2, COSIM_PSD_WINDOW_HANN);
+    if (spectrum < 0) { goto Lerror; }
+
+    // The segment length must be a power of two.
+    if (cosim_psd_observer_add_variable(observer, variable, 100, 50, COSIM_PSD_WINDOW_HANN) >= 0) {
+        fprintf(stderr, "Expected an error for a segment length which is not a power of two\n");
+        goto Lfailure;
+    }
+
+    // A sine wave with amplitude 1 and a period of 8 samples, i.e., 12.5 Hz,
+    // on top of a constant which should be removed.
+    const double sine[8] = {0.0, 0.7071067811865476, 1.0, 0.7071067811865476, 0.0, -0.7071067811865476, -1.0, -0.7071067811865476};
+    for (int i = 0; i < NUM_STEPS; i++) {
+        double value = 3.0 + sine[i % 8];
+        rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &realIn, 1, &value);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_execution_step(execution, 1);
+        if (rc < 0) { goto Lerror; }
+    }
+
+    double frequencies[NUM_BINS];
+    double psd[NUM_BINS];
+    int64_t numSegments = 0;
+    int64_t numBins = cosim_psd_observer_get_psd(observer, spectrum, frequencies, psd, NUM_BINS, &numSegments);
+    if (numBins != NUM_BINS) {
+        fprintf(stderr, "Expected %d bins, got %" PRId64 "\n", NUM_BINS, numBins);
+        goto Lfailure;
+    }
+    // With 50% overlap, a new segment is completed every 32 samples.
+    if (numSegments < 14) {
+        fprintf(stderr, "Expected at least 14 segments, got %" PRId64 "\n", numSegments);
+        goto Lfailure;
+    }
+    const double binWidth = 100.0 / SEGMENT_LENGTH;
+    if (fabs(frequencies[1] - binWidth) > 1e-9 || fabs(frequencies[NUM_BINS - 1] - 50.0) > 1e-9) {
+        fprintf(stderr, "Unexpected frequencies\n");
+        goto Lfailure;
+    }
+
+    int peak = 0;
+    double power = 0.0;
+    for (int i = 0; i < NUM_BINS; i++) {
+        if (psd[i] > psd[peak]) peak = i;
+        power += psd[i] * binWidth;
+    }
+    if (peak != 8) {
+        fprintf(stderr, "Expected the peak at 12.5 Hz, got %f Hz\n", frequencies[peak]);
+        goto Lfailure;
+    }
+    // The power of the sine wave is its variance, 0.5.
+    if (fabs(power - 0.5) > 0.01) {
+        fprintf(stderr, "Expected a total power of 0.5, got %f\n", power);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+
+    return exitCode;
+}
@@ -0,0 +1,113 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+typedef struct
+{
+    int64_t epoch;
+    int calls;
+} stalling_clock;
+
+int64_t wall_clock_nanoseconds()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// A clock which follows the wall clock, but jumps 200 ms ahead after a few
+// readings, as if the simulation had stalled.
+cosim_time_point stalling_clock_read(void* userData)
+{
+    stalling_clock* clock = (stalling_clock*)userData;
+    ++clock->calls;
+    const int64_t t = wall_clock_nanoseconds() - clock->epoch;
+    return clock->calls > 10 ? t + 200000000 : t;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.01 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    // Slowing down requires a number of steps to catch up over.
+    rc = cosim_execution_set_real_time_catch_up_policy(execution, COSIM_REAL_TIME_CATCH_UP_SLOW_DOWN, 0, 0);
+    if (rc == 0) {
+        fprintf(stderr, "Expected slowing down over zero steps to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) { goto Lerror; }
+
+    stalling_clock clock = {wall_clock_nanoseconds(), 0};
+    rc = cosim_execution_set_real_time_clock(execution, stalling_clock_read, &clock);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_set_real_time_catch_up_policy(execution, COSIM_REAL_TIME_CATCH_UP_REANCHOR, 0, 0);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_enable_real_time_simulation(execution);
+    if (rc < 0) { goto Lerror; }
+
+    // With re-anchoring, the stall is skipped rather than made up for, so
+    // the remaining steps are still paced.
+    rc = cosim_execution_simulate_until(execution, (int64_t)(0.3 * 1.0e9));
+    if (rc < 0) { goto Lerror; }
+
+    cosim_real_time_pacing_stats stats;
+    rc = cosim_execution_get_real_time_pacing_stats(execution, &stats);
+    if (rc < 0) { goto Lerror; }
+    if (stats.reanchors != 1) {
+        fprintf(stderr, "Expected 1 re-anchor, got %lld\n", (long long)stats.reanchors);
+        goto Lfailure;
+    }
+    if (stats.last_lateness > 5000000) {
+        fprintf(stderr, "Expected the last step to be on time, was %lld ns late\n", (long long)stats.last_lateness);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
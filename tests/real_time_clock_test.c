@@ -0,0 +1,104 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int64_t wall_clock_nanoseconds()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// An external clock which runs twice as fast as the wall clock.
+cosim_time_point fast_clock(void* userData)
+{
+    const int64_t epoch = *(const int64_t*)userData;
+    return 2 * (wall_clock_nanoseconds() - epoch);
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.01 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    int64_t epoch = wall_clock_nanoseconds();
+    rc = cosim_execution_set_real_time_clock(execution, fast_clock, &epoch);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_enable_real_time_simulation(execution);
+    if (rc < 0) { goto Lerror; }
+
+    // Half a second of simulated time should take about a quarter of a
+    // second on the wall clock.
+    const int64_t start = wall_clock_nanoseconds();
+    rc = cosim_execution_simulate_until(execution, (int64_t)(0.5 * 1.0e9));
+    if (rc < 0) { goto Lerror; }
+    const double elapsed = (wall_clock_nanoseconds() - start) * 1.0e-9;
+    if (elapsed < 0.2 || elapsed > 0.45) {
+        fprintf(stderr, "Expected the simulation to take about 0.25 s, took %f s\n", elapsed);
+        goto Lfailure;
+    }
+
+    cosim_real_time_pacing_stats stats;
+    rc = cosim_execution_get_real_time_pacing_stats(execution, &stats);
+    if (rc < 0) { goto Lerror; }
+    if (stats.paced_steps < 1) {
+        fprintf(stderr, "Expected some steps to be paced\n");
+        goto Lfailure;
+    }
+    if (stats.clock_rate < 1.5 || stats.clock_rate > 2.5) {
+        fprintf(stderr, "Expected an estimated clock rate of about 2, got %f\n", stats.clock_rate);
+        goto Lfailure;
+    }
+
+    // Reverting to the local clock.
+    rc = cosim_execution_set_real_time_clock(execution, NULL, NULL);
+    if (rc < 0) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,168 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WINDOWS
+#    include <windows.h>
+#else
+#    include <unistd.h>
+#    define Sleep(x) usleep((x)*1000)
+#endif
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+typedef struct
+{
+    int calls;
+    double oldOutput;
+} transfer_data;
+
+int transfer_state(cosim_slave* oldSlave, cosim_slave* newSlave, void* userData)
+{
+    transfer_data* data = (transfer_data*)userData;
+    data->calls++;
+    cosim_value_reference ref = 0;
+    if (cosim_slave_get_real(oldSlave, &ref, 1, &data->oldOutput) < 0) return -1;
+    return cosim_slave_set_real(newSlave, &ref, 1, &data->oldOutput);
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_slave* surrogate = NULL;
+    cosim_slave* surrogate2 = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+    surrogate = cosim_local_slave_create(fmuPath, "surrogate");
+    if (!surrogate) { goto Lerror; }
+    surrogate2 = cosim_local_slave_create(fmuPath, "surrogate2");
+    if (!surrogate2) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference ref = 0;
+    double input = 1.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &input);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 2);
+    if (rc < 0) { goto Lerror; }
+
+    transfer_data data = {0, -1.0};
+    rc = cosim_execution_replace_slave(execution, slaveIndex, surrogate, transfer_state, &data);
+    if (rc < 0) { goto Lerror; }
+    if (data.calls != 1 || data.oldOutput != 1.0) {
+        fprintf(stderr, "Expected one state transfer of the value 1.0, got %d transfers of %f\n", data.calls, data.oldOutput);
+        goto Lfailure;
+    }
+
+    // The manipulator and observer still work on the same slave index.
+    input = 3.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &input);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    double output = -1.0;
+    rc = cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output);
+    if (rc < 0) { goto Lerror; }
+    if (output != 3.0) {
+        fprintf(stderr, "Expected output 3.0 from the replacement, got %f\n", output);
+        goto Lfailure;
+    }
+
+    // A slave can also be replaced while the execution is running in the
+    // background.
+    input = 5.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &input);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_start(execution);
+    if (rc < 0) { goto Lerror; }
+    Sleep(10);
+    rc = cosim_execution_replace_slave(execution, slaveIndex, surrogate2, NULL, NULL);
+    if (rc < 0) {
+        print_last_error();
+        cosim_execution_stop(execution);
+        goto Lfailure;
+    }
+    Sleep(10);
+    rc = cosim_execution_stop(execution);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    output = -1.0;
+    rc = cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output);
+    if (rc < 0) { goto Lerror; }
+    if (output != 5.0) {
+        fprintf(stderr, "Expected output 5.0 from the second replacement, got %f\n", output);
+        goto Lfailure;
+    }
+
+    // Only existing slaves can be replaced.
+    rc = cosim_execution_replace_slave(execution, slaveIndex + 1, surrogate, NULL, NULL);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected replacing an invalid slave to fail\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_OUT_OF_RANGE) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(surrogate2);
+    cosim_local_slave_destroy(surrogate);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
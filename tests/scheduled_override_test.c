@@ -0,0 +1,122 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Steps the execution until `numSteps` steps have been taken in total, and
+// checks the output of the slave.  Returns 0 on success, -1 on error and -2
+// on failure.
+int step_and_check(
+    cosim_execution* execution,
+    cosim_observer* observer,
+    cosim_slave_index slaveIndex,
+    int* stepsTaken,
+    int numSteps,
+    double expected)
+{
+    if (cosim_execution_step(execution, numSteps - *stepsTaken) < 0) return -1;
+    *stepsTaken = numSteps;
+    cosim_value_reference ref = 0;
+    double output = -1.0;
+    if (cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output) < 0) return -1;
+    if (fabs(output - expected) > 1e-9) {
+        fprintf(stderr, "Expected output %f after %d steps, got %f\n", expected, numSteps, output);
+        return -2;
+    }
+    return 0;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    const int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    // Override the input with 5.0 from t = 0.5 for 0.3 s, and then ramp it
+    // to 10.0 from t = 1.0 over 0.5 s.
+    rc = cosim_manipulator_slave_schedule_real(manipulator, slaveIndex, 0, 5.0, 5 * nanoStepSize, 0, 3 * nanoStepSize);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_manipulator_slave_schedule_real(manipulator, slaveIndex, 0, 10.0, 10 * nanoStepSize, 5 * nanoStepSize, 0);
+    if (rc < 0) { goto Lerror; }
+
+    // The output after each step is the input during the step.
+    int steps = 0;
+    const int numChecks = 6;
+    const int checkSteps[] = {5, 6, 8, 9, 13, 17};
+    const double expected[] = {0.0, 5.0, 5.0, 0.0, 4.0, 10.0};
+    for (int i = 0; i < numChecks; i++) {
+        rc = step_and_check(execution, observer, slaveIndex, &steps, checkSteps[i], expected[i]);
+        if (rc == -1) { goto Lerror; }
+        if (rc == -2) { goto Lfailure; }
+    }
+
+    // Negative durations are rejected.
+    rc = cosim_manipulator_slave_schedule_real(manipulator, slaveIndex, 0, 1.0, 0, -nanoStepSize, 0);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected a negative ramp duration to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,147 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Sets up a chain of two identity slaves, where the output of the first is
+// connected to the input of the second with the given delay (in seconds),
+// optionally in a sequential group.  Sets the input of the first slave to
+// 1.0, runs `numSteps` steps, and returns the output of the second slave in
+// `output`.  Returns 0 on success and -1 on error.
+int run(const char* fmuPath, bool sequential, double delay, int64_t numSteps, double* output)
+{
+    int result = -1;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave1 = NULL;
+    cosim_slave* slave2 = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lcleanup; }
+
+    slave1 = cosim_local_slave_create(fmuPath, "slave1");
+    if (!slave1) { goto Lcleanup; }
+    slave2 = cosim_local_slave_create(fmuPath, "slave2");
+    if (!slave2) { goto Lcleanup; }
+
+    cosim_slave_index slaveIndices[2];
+    slaveIndices[0] = cosim_execution_add_slave(execution, slave1);
+    if (slaveIndices[0] < 0) { goto Lcleanup; }
+    slaveIndices[1] = cosim_execution_add_slave(execution, slave2);
+    if (slaveIndices[1] < 0) { goto Lcleanup; }
+
+    if (cosim_execution_connect_real_variables(execution, slaveIndices[0], 0, slaveIndices[1], 0) < 0) { goto Lcleanup; }
+    if (delay > 0.0) {
+        if (cosim_execution_set_real_connection_delay(execution, slaveIndices[1], 0, (cosim_duration)(delay * 1.0e9)) < 0) { goto Lcleanup; }
+    }
+    if (sequential) {
+        if (cosim_execution_add_sequential_group(execution, slaveIndices, 2) < 0) { goto Lcleanup; }
+    }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lcleanup; }
+    if (cosim_execution_add_observer(execution, observer) < 0) { goto Lcleanup; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lcleanup; }
+    if (cosim_execution_add_manipulator(execution, manipulator) < 0) { goto Lcleanup; }
+
+    cosim_value_reference ref = 0;
+    double input = 1.0;
+    if (cosim_manipulator_slave_set_real(manipulator, slaveIndices[0], &ref, 1, &input) < 0) { goto Lcleanup; }
+
+    if (cosim_execution_step(execution, numSteps) < 0) { goto Lcleanup; }
+    if (cosim_observer_slave_get_real(observer, slaveIndices[1], &ref, 1, output) < 0) { goto Lcleanup; }
+
+    // A slave can only be in one group.
+    if (sequential) {
+        if (cosim_execution_add_sequential_group(execution, slaveIndices, 1) == 0) {
+            fprintf(stderr, "Expected adding a slave to two groups to fail\n");
+            goto Lcleanup;
+        }
+        if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) { goto Lcleanup; }
+    }
+    result = 0;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave2);
+    cosim_local_slave_destroy(slave1);
+    cosim_execution_destroy(execution);
+    return result;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        return 1;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        return 1;
+    }
+
+    // With parallel stepping, the second slave sees the new value one step late.
+    double output = -1.0;
+    if (run(fmuPath, false, 0.0, 1, &output) < 0) {
+        print_last_error();
+        return 1;
+    }
+    if (output != 0.0) {
+        fprintf(stderr, "Expected output 0.0 with parallel stepping, got %f\n", output);
+        return 1;
+    }
+
+    // With sequential stepping, it is passed on within the same step.
+    output = -1.0;
+    if (run(fmuPath, true, 0.0, 1, &output) < 0) {
+        print_last_error();
+        return 1;
+    }
+    if (output != 1.0) {
+        fprintf(stderr, "Expected output 1.0 with sequential stepping, got %f\n", output);
+        return 1;
+    }
+
+    // A delayed connection within the group holds the value back by the
+    // delay, here one step.
+    output = -1.0;
+    if (run(fmuPath, true, 0.1, 1, &output) < 0) {
+        print_last_error();
+        return 1;
+    }
+    if (output != 0.0) {
+        fprintf(stderr, "Expected output 0.0 after one step with a delayed connection, got %f\n", output);
+        return 1;
+    }
+    output = -1.0;
+    if (run(fmuPath, true, 0.1, 2, &output) < 0) {
+        print_last_error();
+        return 1;
+    }
+    if (output != 1.0) {
+        fprintf(stderr, "Expected output 1.0 after two steps with a delayed connection, got %f\n", output);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <cosim.h>
+#include <cosim_shm_writer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int check_output(cosim_observer* observer, cosim_slave_index slaveIndex, double expected)
+{
+    cosim_value_reference ref = 0;
+    double output = -1.0;
+    if (cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output) < 0) {
+        print_last_error();
+        return -1;
+    }
+    if (output != expected) {
+        fprintf(stderr, "Expected output %f, got %f\n", expected, output);
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+    cosim_shm_writer* writer = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    const char* segmentName = "cosimc_shm_input_test";
+    cosim_slave_index slaves[] = {slaveIndex};
+    cosim_value_reference refs[] = {0};
+    manipulator = cosim_shm_input_manipulator_create(segmentName, slaves, refs, 1);
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    writer = cosim_shm_writer_open(segmentName);
+    if (!writer) {
+        fprintf(stderr, "Failed to open shared-memory segment\n");
+        goto Lfailure;
+    }
+    if (cosim_shm_writer_size(writer) != 1) {
+        fprintf(stderr, "Expected a segment with one slot\n");
+        goto Lfailure;
+    }
+
+    // Nothing has been written yet, so the input keeps its start value.
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+    if (check_output(observer, slaveIndex, 0.0) < 0) { goto Lfailure; }
+
+    double value = 3.5;
+    rc = cosim_shm_writer_write(writer, 0, &value, 1);
+    if (rc < 0) { goto Lfailure; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+    if (check_output(observer, slaveIndex, 3.5) < 0) { goto Lfailure; }
+
+    // The value is held until it is written again.
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+    if (check_output(observer, slaveIndex, 3.5) < 0) { goto Lfailure; }
+
+    value = -7.0;
+    rc = cosim_shm_writer_write(writer, 0, &value, 1);
+    if (rc < 0) { goto Lfailure; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+    if (check_output(observer, slaveIndex, -7.0) < 0) { goto Lfailure; }
+
+    // Writes outside the segment are rejected.
+    double values[] = {1.0, 2.0};
+    if (cosim_shm_writer_write(writer, 0, values, 2) >= 0) {
+        fprintf(stderr, "Expected an out-of-bounds write to fail\n");
+        goto Lfailure;
+    }
+
+    if (cosim_shm_input_manipulator_get_skipped_reads(manipulator) != 0) {
+        fprintf(stderr, "Expected no skipped reads\n");
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_shm_writer_close(writer);
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,136 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference ref = 0;
+    double input = 1.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &input);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    // While frozen, the output keeps its value.
+    rc = cosim_execution_freeze_slave(execution, slaveIndex);
+    if (rc < 0) { goto Lerror; }
+    if (cosim_execution_is_slave_frozen(execution, slaveIndex) != 1) {
+        fprintf(stderr, "Expected slave to be frozen\n");
+        goto Lfailure;
+    }
+    input = 2.0;
+    rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &ref, 1, &input);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 5);
+    if (rc < 0) { goto Lerror; }
+
+    double output = -1.0;
+    rc = cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output);
+    if (rc < 0) { goto Lerror; }
+    if (output != 1.0) {
+        fprintf(stderr, "Expected frozen output 1.0, got %f\n", output);
+        goto Lfailure;
+    }
+
+    cosim_execution_status status;
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+    if (status.num_frozen_slaves != 1) {
+        fprintf(stderr, "Expected 1 frozen slave, got %d\n", status.num_frozen_slaves);
+        goto Lfailure;
+    }
+
+    // When thawed, the slave catches up and is stepped again.
+    rc = cosim_execution_thaw_slave(execution, slaveIndex);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(execution, 1);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_observer_slave_get_real(observer, slaveIndex, &ref, 1, &output);
+    if (rc < 0) { goto Lerror; }
+    if (output != 2.0) {
+        fprintf(stderr, "Expected thawed output 2.0, got %f\n", output);
+        goto Lfailure;
+    }
+
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+    if (status.num_frozen_slaves != 0 || cosim_execution_is_slave_frozen(execution, slaveIndex) != 0) {
+        fprintf(stderr, "Expected no frozen slaves\n");
+        goto Lfailure;
+    }
+
+    // Invalid slave indices are rejected.
+    rc = cosim_execution_freeze_slave(execution, slaveIndex + 1);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected freezing an invalid slave to fail\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_OUT_OF_RANGE) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
@@ -0,0 +1,144 @@
+#include <cosim.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Runs 10 steps of two connected identity slaves, with `input` applied to
+// the first one from step 5 onwards, and stores the state hash of every
+// step in `hashes`.  If `window` is nonzero, only the hashes of that many
+// steps are kept, and the others are checked to be unavailable and set to
+// zero.  Returns 0 on success and -1 on error.
+int run(const char* fmuPath, double input, size_t window, uint64_t hashes[11])
+{
+    int result = -1;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave1 = NULL;
+    cosim_slave* slave2 = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lcleanup; }
+
+    slave1 = cosim_local_slave_create(fmuPath, "slave1");
+    if (!slave1) { goto Lcleanup; }
+    slave2 = cosim_local_slave_create(fmuPath, "slave2");
+    if (!slave2) { goto Lcleanup; }
+
+    cosim_slave_index slaveIndex1 = cosim_execution_add_slave(execution, slave1);
+    if (slaveIndex1 < 0) { goto Lcleanup; }
+    cosim_slave_index slaveIndex2 = cosim_execution_add_slave(execution, slave2);
+    if (slaveIndex2 < 0) { goto Lcleanup; }
+
+    if (cosim_execution_connect_real_variables(execution, slaveIndex1, 0, slaveIndex2, 0) < 0) { goto Lcleanup; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lcleanup; }
+    if (cosim_execution_add_manipulator(execution, manipulator) < 0) { goto Lcleanup; }
+
+    if (window == 0) {
+        if (cosim_execution_enable_state_hash(execution) < 0) { goto Lcleanup; }
+    } else {
+        if (cosim_execution_enable_state_hash_with_window(execution, window) < 0) { goto Lcleanup; }
+    }
+
+    if (cosim_execution_step(execution, 5) < 0) { goto Lcleanup; }
+    cosim_value_reference ref = 0;
+    if (cosim_manipulator_slave_set_real(manipulator, slaveIndex1, &ref, 1, &input) < 0) { goto Lcleanup; }
+    if (cosim_execution_step(execution, 5) < 0) { goto Lcleanup; }
+
+    for (cosim_step_number step = 0; step <= 10; step++) {
+        if (window > 0 && (size_t)step + window <= 10) {
+            if (cosim_execution_get_state_hash(execution, step, &hashes[step]) == 0) {
+                fprintf(stderr, "Expected no state hash for step %d outside the window\n", (int)step);
+                goto Lcleanup;
+            }
+            hashes[step] = 0;
+            continue;
+        }
+        if (cosim_execution_get_state_hash(execution, step, &hashes[step]) < 0) { goto Lcleanup; }
+    }
+
+    // No hash should exist for a future step.
+    uint64_t unused;
+    if (cosim_execution_get_state_hash(execution, 11, &unused) == 0) {
+        fprintf(stderr, "Expected no state hash for step 11\n");
+        goto Lcleanup;
+    }
+    result = 0;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_local_slave_destroy(slave2);
+    cosim_local_slave_destroy(slave1);
+    cosim_execution_destroy(execution);
+    return result;
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        return 1;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        return 1;
+    }
+
+    uint64_t hashes1[11];
+    uint64_t hashes2[11];
+    uint64_t hashes3[11];
+    uint64_t hashes4[11];
+    if (run(fmuPath, 1.0, 0, hashes1) < 0 || run(fmuPath, 1.0, 0, hashes2) < 0 ||
+        run(fmuPath, 2.0, 0, hashes3) < 0 || run(fmuPath, 1.0, 4, hashes4) < 0) {
+        print_last_error();
+        return 1;
+    }
+
+    for (int step = 0; step <= 10; step++) {
+        if (hashes1[step] != hashes2[step]) {
+            fprintf(stderr, "Expected identical runs to have equal hashes at step %d\n", step);
+            return 1;
+        }
+    }
+    for (int step = 0; step <= 5; step++) {
+        if (hashes1[step] != hashes3[step]) {
+            fprintf(stderr, "Expected equal hashes before the runs differ, at step %d\n", step);
+            return 1;
+        }
+    }
+    if (hashes1[6] == hashes3[6] || hashes1[10] == hashes3[10]) {
+        fprintf(stderr, "Expected different hashes after the runs differ\n");
+        return 1;
+    }
+    // A small window keeps the same chain of hashes, for fewer steps.
+    for (int step = 7; step <= 10; step++) {
+        if (hashes1[step] != hashes4[step]) {
+            fprintf(stderr, "Expected the same hash with a small window, at step %d\n", step);
+            return 1;
+        }
+    }
+    if (hashes1[5] == hashes1[6]) {
+        fprintf(stderr, "Expected the hash to change from step to step: %" PRIu64 "\n", hashes1[5]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WINDOWS
+#    include <windows.h>
+#else
+#    include <unistd.h>
+#    define Sleep(x) usleep((x)*1000)
+#endif
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    rc = cosim_execution_step(execution, 10);
+    if (rc < 0) { goto Lerror; }
+
+    // Ten times larger steps from now on.
+    rc = cosim_execution_set_step_size(execution, 10 * nanoStepSize);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_step(execution, 2);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_execution_status status;
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+
+    double simTime = status.current_time * 1e-9;
+    if (fabs(simTime - 3.0) > 1e-9) {
+        fprintf(stderr, "Expected current time == 3.0, got %f\n", simTime);
+        goto Lfailure;
+    }
+
+    // The step size can also be changed while running in the background.
+    rc = cosim_execution_start(execution);
+    if (rc < 0) { goto Lerror; }
+    Sleep(10);
+    rc = cosim_execution_set_step_size(execution, nanoStepSize);
+    if (rc < 0) { goto Lerror; }
+    Sleep(10);
+    rc = cosim_execution_stop(execution);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+    if (status.state != COSIM_EXECUTION_STOPPED) {
+        fprintf(stderr, "Expected state == %i, got %i\n", COSIM_EXECUTION_STOPPED, status.state);
+        goto Lfailure;
+    }
+
+    // Non-positive step sizes are rejected.
+    rc = cosim_execution_set_step_size(execution, 0);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected a zero step size to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) {
+        fprintf(stderr, "Expected error code %d, got %d\n", COSIM_ERRC_INVALID_ARGUMENT, cosim_last_error_code());
+        goto Lerror;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
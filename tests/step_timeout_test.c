@@ -0,0 +1,164 @@
+#include <cosim.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_execution* sspExecution = NULL;
+    cosim_execution* timeoutExecution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_slave* slowSlave = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    char sspDir[1024];
+    rc = snprintf(sspDir, sizeof sspDir, "%s/ssp/demo", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    int64_t nanoStepSize = (int64_t)(0.1 * 1.0e9);
+    execution = cosim_execution_create(0, nanoStepSize);
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    // A generous timeout should not affect a well-behaved slave.
+    rc = cosim_execution_set_slave_step_timeout(execution, slaveIndex, (int64_t)(10.0 * 1.0e9));
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_step(execution, 10);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_slave_index timedOut = -1;
+    rc = cosim_execution_get_timed_out_slave(execution, &timedOut);
+    if (rc != 0) {
+        fprintf(stderr, "Expected no slave to have timed out, got %d (slave %d)\n", rc, timedOut);
+        goto Lfailure;
+    }
+
+    // The timeout can be changed and disabled between steps.
+    rc = cosim_execution_set_slave_step_timeout(execution, slaveIndex, 0);
+    if (rc < 0) { goto Lerror; }
+
+    rc = cosim_execution_step(execution, 10);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_execution_status status;
+    rc = cosim_execution_get_status(execution, &status);
+    if (rc < 0) { goto Lerror; }
+
+    double simTime = status.current_time * 1e-9;
+    if (fabs(simTime - 2.0) > 1e-9) {
+        fprintf(stderr, "Expected current time == 2.0, got %f\n", simTime);
+        goto Lfailure;
+    }
+
+    // A timeout which no step can meet.  The first step will normally time
+    // out, but allow for a few lucky ones.
+    timeoutExecution = cosim_execution_create(0, nanoStepSize);
+    if (!timeoutExecution) { goto Lerror; }
+
+    slowSlave = cosim_local_slave_create(fmuPath, "slowSlave");
+    if (!slowSlave) { goto Lerror; }
+
+    cosim_slave_index slowIndex = cosim_execution_add_slave(timeoutExecution, slowSlave);
+    if (slowIndex < 0) { goto Lerror; }
+
+    rc = cosim_execution_set_slave_step_timeout(timeoutExecution, slowIndex, 1);
+    if (rc < 0) { goto Lerror; }
+
+    rc = 0;
+    for (int i = 0; i < 100 && rc == 0; i++) {
+        rc = cosim_execution_step(timeoutExecution, 1);
+    }
+    if (rc >= 0) {
+        fprintf(stderr, "Expected a step to time out\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_STEP_TIMEOUT) {
+        fprintf(stderr, "Expected error code %d, got %d\n", COSIM_ERRC_STEP_TIMEOUT, cosim_last_error_code());
+        goto Lerror;
+    }
+
+    timedOut = -1;
+    rc = cosim_execution_get_timed_out_slave(timeoutExecution, &timedOut);
+    if (rc != 1 || timedOut != slowIndex) {
+        fprintf(stderr, "Expected slave %d to have timed out, got %d (slave %d)\n", slowIndex, rc, timedOut);
+        goto Lfailure;
+    }
+
+    // The simulation cannot be continued.
+    rc = cosim_execution_set_slave_step_timeout(timeoutExecution, slowIndex, 0);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_execution_step(timeoutExecution, 1);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected steps after a timeout to be refused\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_STEP_TIMEOUT) {
+        fprintf(stderr, "Expected error code %d, got %d\n", COSIM_ERRC_STEP_TIMEOUT, cosim_last_error_code());
+        goto Lerror;
+    }
+
+    // Executions which use the algorithm from an SSP file don't support it.
+    sspExecution = cosim_ssp_execution_create(sspDir, false, 0);
+    if (!sspExecution) { goto Lerror; }
+
+    rc = cosim_execution_set_slave_step_timeout(sspExecution, 0, nanoStepSize);
+    if (rc >= 0) {
+        fprintf(stderr, "Expected setting a timeout for an SSP execution to fail\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_UNSUPPORTED_FEATURE) {
+        fprintf(stderr, "Expected error code %d, got %d\n", COSIM_ERRC_UNSUPPORTED_FEATURE, cosim_last_error_code());
+        goto Lerror;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_execution_destroy(sspExecution);
+    cosim_execution_destroy(timeoutExecution);
+    cosim_local_slave_destroy(slowSlave);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}
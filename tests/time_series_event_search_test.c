@@ -0,0 +1,176 @@
+#include <cosim.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_STEPS 8
+
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+// Returns the step at which `value` was first observed, or -1.
+cosim_step_number step_of(const double values[], const cosim_step_number steps[], int64_t n, double value)
+{
+    for (int64_t i = 0; i < n; i++) {
+        if (values[i] == value) return steps[i];
+    }
+    return -1;
+}
+
+int main()
+{
+    int exitCode = 0;
+
+    cosim_execution* execution = NULL;
+    cosim_slave* slave = NULL;
+    cosim_observer* observer = NULL;
+    cosim_manipulator* manipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    slave = cosim_local_slave_create(fmuPath, "slave");
+    if (!slave) { goto Lerror; }
+
+    cosim_slave_index slaveIndex = cosim_execution_add_slave(execution, slave);
+    if (slaveIndex < 0) { goto Lerror; }
+
+    observer = cosim_time_series_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+
+    cosim_value_reference reference = 0;
+    rc = cosim_observer_start_observing(observer, slaveIndex, COSIM_VARIABLE_TYPE_REAL, reference);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_observer_start_observing(observer, slaveIndex, COSIM_VARIABLE_TYPE_INTEGER, reference);
+    if (rc < 0) { goto Lerror; }
+
+    // Crosses 15 upwards twice (at 20 and 18), with maxima at 20 and 25
+    // and a minimum at 3.  The integer input is a flag which is set twice.
+    double realInputs[NUM_STEPS] = {5.0, 10.0, 20.0, 12.0, 3.0, 18.0, 25.0, 8.0};
+    int intInputs[NUM_STEPS] = {0, 1, 1, 0, 0, 1, 0, 0};
+    for (int i = 0; i < NUM_STEPS; i++) {
+        rc = cosim_manipulator_slave_set_real(manipulator, slaveIndex, &reference, 1, &realInputs[i]);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_manipulator_slave_set_integer(manipulator, slaveIndex, &reference, 1, &intInputs[i]);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_execution_step(execution, 1);
+        if (rc < 0) { goto Lerror; }
+    }
+
+    // Look up the steps at which the inputs were observed, to check the
+    // search results against.
+    double values[NUM_STEPS + 1];
+    cosim_step_number sampleSteps[NUM_STEPS + 1];
+    cosim_time_point sampleTimes[NUM_STEPS + 1];
+    int64_t numSamples = cosim_observer_slave_get_real_samples(
+        observer, slaveIndex, reference, 0, NUM_STEPS + 1, values, sampleSteps, sampleTimes);
+    if (numSamples < NUM_STEPS) {
+        fprintf(stderr, "Expected at least %d samples, got %" PRId64 "\n", NUM_STEPS, numSamples);
+        goto Lfailure;
+    }
+    const cosim_step_number lastStep = sampleSteps[numSamples - 1];
+
+    cosim_step_number steps[4];
+    cosim_time_point times[4];
+
+    int64_t n = cosim_observer_slave_find_real_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_UPWARD_CROSSING, 15.0, 4, steps, times);
+    if (n < 0) { goto Lerror; }
+    if (n != 2 || steps[0] != step_of(values, sampleSteps, numSamples, 20.0) ||
+        steps[1] != step_of(values, sampleSteps, numSamples, 18.0)) {
+        fprintf(stderr, "Unexpected upward crossings (found %" PRId64 ")\n", n);
+        goto Lfailure;
+    }
+    if (times[0] != sampleTimes[steps[0] - sampleSteps[0]]) {
+        fprintf(stderr, "Unexpected crossing time %" PRId64 "\n", times[0]);
+        goto Lfailure;
+    }
+
+    // Only the first crossing
+    n = cosim_observer_slave_find_real_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_UPWARD_CROSSING, 15.0, 1, steps, times);
+    if (n != 1 || steps[0] != step_of(values, sampleSteps, numSamples, 20.0)) {
+        fprintf(stderr, "Expected only the first upward crossing\n");
+        goto Lfailure;
+    }
+
+    n = cosim_observer_slave_find_real_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_LOCAL_MAXIMUM, 0.0, 4, steps, times);
+    if (n != 2 || steps[0] != step_of(values, sampleSteps, numSamples, 20.0) ||
+        steps[1] != step_of(values, sampleSteps, numSamples, 25.0)) {
+        fprintf(stderr, "Unexpected local maxima (found %" PRId64 ")\n", n);
+        goto Lfailure;
+    }
+
+    n = cosim_observer_slave_find_real_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_LOCAL_MINIMUM, 0.0, 4, steps, times);
+    if (n != 1 || steps[0] != step_of(values, sampleSteps, numSamples, 3.0)) {
+        fprintf(stderr, "Unexpected local minima (found %" PRId64 ")\n", n);
+        goto Lfailure;
+    }
+
+    // The step range limits the search: the second crossing is excluded.
+    n = cosim_observer_slave_find_real_events(
+        observer, slaveIndex, reference, 0, step_of(values, sampleSteps, numSamples, 3.0),
+        COSIM_EVENT_UPWARD_CROSSING, 15.0, 4, steps, times);
+    if (n != 1) {
+        fprintf(stderr, "Expected 1 upward crossing in a limited range, found %" PRId64 "\n", n);
+        goto Lfailure;
+    }
+
+    n = cosim_observer_slave_find_integer_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_RISING_EDGE, 0.0, 4, steps, times);
+    if (n != 2) {
+        fprintf(stderr, "Expected 2 rising edges, found %" PRId64 "\n", n);
+        goto Lfailure;
+    }
+    n = cosim_observer_slave_find_integer_events(
+        observer, slaveIndex, reference, 0, lastStep, COSIM_EVENT_FALLING_EDGE, 0.0, 4, steps, times);
+    if (n != 2) {
+        fprintf(stderr, "Expected 2 falling edges, found %" PRId64 "\n", n);
+        goto Lfailure;
+    }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(slave);
+    cosim_execution_destroy(execution);
+
+    return exitCode;
+}
@@ -0,0 +1,172 @@
+#include <cosim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WINDOWS
+#    include <windows.h>
+#else
+#    include <unistd.h>
+#    define Sleep(x) usleep((x)*1000)
+#endif
+
+void print_last_error()
+{
+    fprintf(
+        stderr,
+        "Error code %d: %s\n",
+        cosim_last_error_code(), cosim_last_error_message());
+}
+
+int main()
+{
+    cosim_log_setup_simple_console_logging();
+    cosim_log_set_output_level(COSIM_LOG_SEVERITY_INFO);
+
+    int exitCode = 0;
+    cosim_execution* execution = NULL;
+    cosim_slave* source = NULL;
+    cosim_slave* target = NULL;
+    cosim_observer* observer = NULL;
+    cosim_observer* udpObserver = NULL;
+    cosim_manipulator* manipulator = NULL;
+    cosim_manipulator* udpManipulator = NULL;
+
+    const char* dataDir = getenv("TEST_DATA_DIR");
+    if (!dataDir) {
+        fprintf(stderr, "Environment variable TEST_DATA_DIR not set\n");
+        goto Lfailure;
+    }
+
+    char fmuPath[1024];
+    int rc = snprintf(fmuPath, sizeof fmuPath, "%s/fmi1/identity.fmu", dataDir);
+    if (rc < 0) {
+        perror(NULL);
+        goto Lfailure;
+    }
+
+    execution = cosim_execution_create(0, (int64_t)(0.1 * 1.0e9));
+    if (!execution) { goto Lerror; }
+
+    source = cosim_local_slave_create(fmuPath, "source");
+    if (!source) { goto Lerror; }
+    target = cosim_local_slave_create(fmuPath, "target");
+    if (!target) { goto Lerror; }
+
+    cosim_slave_index sourceIndex = cosim_execution_add_slave(execution, source);
+    if (sourceIndex < 0) { goto Lerror; }
+    cosim_slave_index targetIndex = cosim_execution_add_slave(execution, target);
+    if (targetIndex < 0) { goto Lerror; }
+
+    observer = cosim_last_value_observer_create();
+    if (!observer) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, observer);
+    if (rc < 0) { goto Lerror; }
+
+    // Drive the source slave's inputs, which its outputs mirror.
+    manipulator = cosim_override_manipulator_create();
+    if (!manipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, manipulator);
+    if (rc < 0) { goto Lerror; }
+    cosim_value_reference ref = 0;
+    double realValue = 2.5;
+    int intValue = -3;
+    bool boolValue = true;
+    rc = cosim_manipulator_slave_set_real(manipulator, sourceIndex, &ref, 1, &realValue);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_manipulator_slave_set_integer(manipulator, sourceIndex, &ref, 1, &intValue);
+    if (rc < 0) { goto Lerror; }
+    rc = cosim_manipulator_slave_set_boolean(manipulator, sourceIndex, &ref, 1, &boolValue);
+    if (rc < 0) { goto Lerror; }
+
+    // Send the source's outputs over loopback to the target's inputs, using
+    // a mix of encodings and byte orders.
+    cosim_packet_field inputFields[] = {
+        {{targetIndex, COSIM_VARIABLE_TYPE_REAL, 0}, 0, COSIM_PACKET_FIELD_FLOAT64, true},
+        {{targetIndex, COSIM_VARIABLE_TYPE_INTEGER, 0}, 8, COSIM_PACKET_FIELD_INT16, false},
+        {{targetIndex, COSIM_VARIABLE_TYPE_BOOLEAN, 0}, 10, COSIM_PACKET_FIELD_UINT8, false},
+    };
+    udpManipulator = cosim_udp_input_manipulator_create("127.0.0.1", 0, 12, inputFields, 3);
+    if (!udpManipulator) { goto Lerror; }
+    rc = cosim_execution_add_manipulator(execution, udpManipulator);
+    if (rc < 0) { goto Lerror; }
+    int port = cosim_udp_input_manipulator_get_port(udpManipulator);
+    if (port <= 0) { goto Lerror; }
+
+    cosim_packet_field outputFields[] = {
+        {{sourceIndex, COSIM_VARIABLE_TYPE_REAL, 0}, 0, COSIM_PACKET_FIELD_FLOAT64, true},
+        {{sourceIndex, COSIM_VARIABLE_TYPE_INTEGER, 0}, 8, COSIM_PACKET_FIELD_INT16, false},
+        {{sourceIndex, COSIM_VARIABLE_TYPE_BOOLEAN, 0}, 10, COSIM_PACKET_FIELD_UINT8, false},
+    };
+    udpObserver = cosim_udp_output_observer_create(
+        "127.0.0.1", 0, "127.0.0.1", (uint16_t)port, 12, outputFields, 3);
+    if (!udpObserver) { goto Lerror; }
+    rc = cosim_execution_add_observer(execution, udpObserver);
+    if (rc < 0) { goto Lerror; }
+
+    // Packets arrive asynchronously, so step until they have made it all
+    // the way through.
+    double realOut = 0.0;
+    int intOut = 0;
+    bool boolOut = false;
+    for (int i = 0; i < 2000; i++) {
+        rc = cosim_execution_step(execution, 1);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_observer_slave_get_real(observer, targetIndex, &ref, 1, &realOut);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_observer_slave_get_integer(observer, targetIndex, &ref, 1, &intOut);
+        if (rc < 0) { goto Lerror; }
+        rc = cosim_observer_slave_get_boolean(observer, targetIndex, &ref, 1, &boolOut);
+        if (rc < 0) { goto Lerror; }
+        if (realOut == realValue && intOut == intValue && boolOut == boolValue) break;
+        Sleep(1);
+    }
+    if (realOut != realValue || intOut != intValue || boolOut != boolValue) {
+        fprintf(stderr, "Expected target outputs %f, %d, %d, got %f, %d, %d\n",
+            realValue, intValue, boolValue, realOut, intOut, boolOut);
+        goto Lfailure;
+    }
+
+    cosim_udp_bridge_stats stats;
+    rc = cosim_udp_input_manipulator_get_stats(udpManipulator, &stats);
+    if (rc < 0) { goto Lerror; }
+    if (stats.packets < 1 || stats.dropped_packets != 0 || stats.errors != 0) {
+        fprintf(stderr, "Unexpected receive counters: %lld, %lld, %lld\n",
+            (long long)stats.packets, (long long)stats.dropped_packets, (long long)stats.errors);
+        goto Lfailure;
+    }
+    rc = cosim_udp_output_observer_get_stats(udpObserver, &stats);
+    if (rc < 0) { goto Lerror; }
+    if (stats.packets < 1 || stats.errors != 0) {
+        fprintf(stderr, "Unexpected send counters: %lld, %lld\n",
+            (long long)stats.packets, (long long)stats.errors);
+        goto Lfailure;
+    }
+
+    // Fields must fit in the packet.
+    cosim_manipulator* invalid = cosim_udp_input_manipulator_create("127.0.0.1", 0, 9, inputFields, 3);
+    if (invalid) {
+        cosim_manipulator_destroy(invalid);
+        fprintf(stderr, "Expected a field outside the packet to be rejected\n");
+        goto Lfailure;
+    }
+    if (cosim_last_error_code() != COSIM_ERRC_INVALID_ARGUMENT) { goto Lerror; }
+
+    goto Lcleanup;
+
+Lerror:
+    print_last_error();
+
+Lfailure:
+    exitCode = 1;
+
+Lcleanup:
+    cosim_manipulator_destroy(udpManipulator);
+    cosim_manipulator_destroy(manipulator);
+    cosim_observer_destroy(udpObserver);
+    cosim_observer_destroy(observer);
+    cosim_local_slave_destroy(target);
+    cosim_local_slave_destroy(source);
+    cosim_execution_destroy(execution);
+    return exitCode;
+}